@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hc_arena.h"
+
+#include "clib_error.h"
+#include "hc_types.h"
+#include "securec.h"
+
+#define ARENA_ALIGN 8
+#define ARENA_ALIGN_UP(size) (((size) + ARENA_ALIGN - 1) & ~(uint32_t)(ARENA_ALIGN - 1))
+#define ARENA_CHUNK_HEAD_SIZE ARENA_ALIGN_UP((uint32_t)sizeof(HcArenaChunk))
+#define ARENA_MAX_ALLOC_SIZE (UINT32_MAX - ARENA_CHUNK_HEAD_SIZE - ARENA_ALIGN)
+
+static uint8_t *GetChunkData(HcArenaChunk *chunk)
+{
+    return (uint8_t *)chunk + ARENA_CHUNK_HEAD_SIZE;
+}
+
+static HcArenaChunk *CreateChunk(uint32_t size)
+{
+    /* chunks are zeroed once here and wiped on destroy, so every allocation is returned zeroed */
+    HcArenaChunk *chunk = (HcArenaChunk *)HcMalloc(ARENA_CHUNK_HEAD_SIZE + size, 0);
+    if (chunk == NULL) {
+        return NULL;
+    }
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
+}
+
+void InitArena(HcArena *arena, uint32_t chunkSize)
+{
+    if (arena == NULL) {
+        return;
+    }
+    arena->head = NULL;
+    arena->chunkSize = ARENA_ALIGN_UP(chunkSize);
+}
+
+void *ArenaAlloc(HcArena *arena, uint32_t size)
+{
+    if (arena == NULL || size == 0 || size > ARENA_MAX_ALLOC_SIZE) {
+        return NULL;
+    }
+    uint32_t alignedSize = ARENA_ALIGN_UP(size);
+    HcArenaChunk *chunk = arena->head;
+    if (chunk == NULL || chunk->size - chunk->used < alignedSize) {
+        if (alignedSize > arena->chunkSize && arena->head != NULL) {
+            /* a large block gets its own chunk behind the head, so the free space of the head is kept */
+            chunk = CreateChunk(alignedSize);
+            if (chunk == NULL) {
+                return NULL;
+            }
+            chunk->next = arena->head->next;
+            arena->head->next = chunk;
+        } else {
+            chunk = CreateChunk(alignedSize > arena->chunkSize ? alignedSize : arena->chunkSize);
+            if (chunk == NULL) {
+                return NULL;
+            }
+            chunk->next = arena->head;
+            arena->head = chunk;
+        }
+    }
+    void *addr = GetChunkData(chunk) + chunk->used;
+    chunk->used += alignedSize;
+    return addr;
+}
+
+int32_t ArenaCopyString(HcArena *arena, const char *str, char **newStr)
+{
+    if (arena == NULL || str == NULL || newStr == NULL) {
+        return CLIB_ERR_NULL_PTR;
+    }
+    uint32_t len = HcStrlen(str);
+    if (len == 0) {
+        return CLIB_ERR_INVALID_LEN;
+    }
+    char *val = (char *)ArenaAlloc(arena, len + 1);
+    if (val == NULL) {
+        return CLIB_ERR_BAD_ALLOC;
+    }
+    (void)memcpy_s(val, len, str, len);
+    *newStr = val;
+    return CLIB_SUCCESS;
+}
+
+void DestroyArena(HcArena *arena)
+{
+    if (arena == NULL) {
+        return;
+    }
+    HcArenaChunk *chunk = arena->head;
+    while (chunk != NULL) {
+        HcArenaChunk *next = chunk->next;
+        if (chunk->used > 0) {
+            (void)memset_s(GetChunkData(chunk), chunk->size, 0, chunk->used);
+        }
+        HcFree(chunk);
+        chunk = next;
+    }
+    arena->head = NULL;
+}
@@ -19,6 +19,8 @@
 
 const int PARCEL_DEFAULT_INCREASE_STEP = 16;
 const uint32_t PARCEL_UINT_MAX = 0xffffffffU;
+#define PARCEL_GROWTH_DIVISOR 2
+#define PARCEL_MAX_GEOMETRIC_SIZE (1024 * 1024)
 
 HcParcel CreateParcel(uint32_t size, uint32_t allocUnit)
 {
@@ -29,7 +31,7 @@ HcParcel CreateParcel(uint32_t size, uint32_t allocUnit)
         parcel.allocUnit = PARCEL_DEFAULT_INCREASE_STEP;
     }
     if (size > 0) {
-        parcel.data = (char *)HcMalloc(size, 0);
+        parcel.data = (char *)HcMallocUninit(size);
         if (parcel.data != NULL) {
             parcel.length = size;
         }
@@ -37,6 +39,21 @@ HcParcel CreateParcel(uint32_t size, uint32_t allocUnit)
     return parcel;
 }
 
+HcParcel CreateReadOnlyParcel(char *data, uint32_t size, ParcelDataReleaser releaser)
+{
+    HcParcel parcel;
+    (void)memset_s(&parcel, sizeof(parcel), 0, sizeof(parcel));
+    parcel.allocUnit = PARCEL_DEFAULT_INCREASE_STEP;
+    parcel.isReadOnly = HC_TRUE;
+    parcel.releaser = releaser;
+    if (data != NULL) {
+        parcel.data = data;
+        parcel.length = size;
+        parcel.endPos = size;
+    }
+    return parcel;
+}
+
 void DeleteParcel(HcParcel *parcel)
 {
     if (parcel == NULL) {
@@ -44,12 +61,18 @@ void DeleteParcel(HcParcel *parcel)
     }
 
     if (parcel->data != NULL) {
-        HcFree(parcel->data);
+        if (!parcel->isReadOnly) {
+            HcFree(parcel->data);
+        } else if (parcel->releaser != NULL) {
+            parcel->releaser(parcel->data, parcel->length);
+        }
         parcel->data = 0;
     }
     parcel->length = 0;
     parcel->beginPos = 0;
     parcel->endPos = 0;
+    parcel->isReadOnly = HC_FALSE;
+    parcel->releaser = NULL;
 }
 
 void ClearParcel(HcParcel *parcel)
@@ -132,7 +155,7 @@ HcBool ParcelRead(HcParcel *parcel, void *dst, uint32_t dataSize)
 HcBool ParcelEraseBlock(HcParcel *parcel, uint32_t start, uint32_t dataSize, void *dst)
 {
     errno_t rc;
-    if (parcel == NULL || dst == NULL || dataSize == 0) {
+    if (parcel == NULL || dst == NULL || dataSize == 0 || parcel->isReadOnly) {
         return HC_FALSE;
     }
     if (start > PARCEL_UINT_MAX - dataSize) {
@@ -172,7 +195,7 @@ HcBool ParcelReadRevert(HcParcel *parcel, void *dst, uint32_t dataSize)
 HcBool ParcelWriteRevert(HcParcel *parcel, const void *src, uint32_t dataSize)
 {
     errno_t rc;
-    void *srcCopy = HcMalloc(dataSize, 0);
+    void *srcCopy = HcMallocUninit(dataSize);
     if (srcCopy == NULL) {
         return HC_FALSE;
     }
@@ -232,11 +255,12 @@ static HcBool ParcelRealloc(HcParcel *parcel, uint32_t size)
     if (parcel->length >= size) {
         return HC_FALSE;
     }
-    char *newData = (char *)HcMalloc(size, 0);
+    char *newData = (char *)HcMallocUninit(size);
     if (newData == NULL) {
         return HC_FALSE;
     }
-    if (memcpy_s(newData, size, parcel->data, parcel->length) != EOK) {
+    /* only the bytes before endPos are meaningful, the tail of the old buffer is not worth copying */
+    if (parcel->endPos > 0 && memcpy_s(newData, size, parcel->data, parcel->endPos) != EOK) {
         HcFree(newData);
         return HC_FALSE;
     }
@@ -290,17 +314,39 @@ static uint32_t GetParcelIncreaseSize(HcParcel *parcel, uint32_t newSize)
     if (parcel == NULL || parcel->allocUnit == 0) {
         return 0;
     }
-    if (newSize % parcel->allocUnit) {
-        return (newSize / parcel->allocUnit + 1) * parcel->allocUnit;
-    } else {
-        return (newSize / parcel->allocUnit) * parcel->allocUnit;
+    /* grow by half of the capacity at least, so that appending n bytes copies O(n) bytes in total */
+    uint32_t geometricSize = parcel->length + parcel->length / PARCEL_GROWTH_DIVISOR;
+    if (geometricSize > parcel->length && geometricSize <= PARCEL_MAX_GEOMETRIC_SIZE && newSize < geometricSize) {
+        newSize = geometricSize;
+    }
+    if (newSize % parcel->allocUnit == 0 || newSize > PARCEL_UINT_MAX - parcel->allocUnit) {
+        return newSize;
+    }
+    return (newSize / parcel->allocUnit + 1) * parcel->allocUnit;
+}
+
+HcBool ParcelReserve(HcParcel *parcel, uint32_t size)
+{
+    if (parcel == NULL || parcel->isReadOnly) {
+        return HC_FALSE;
+    }
+    if (parcel->length - parcel->endPos >= size) {
+        return HC_TRUE;
+    }
+    ParcelRecycle(parcel);
+    if (parcel->length - parcel->endPos >= size) {
+        return HC_TRUE;
+    }
+    if (parcel->endPos > PARCEL_UINT_MAX - size) {
+        return HC_FALSE;
     }
+    return ParcelIncrease(parcel, parcel->endPos + size);
 }
 
 HcBool ParcelWrite(HcParcel *parcel, const void *src, uint32_t dataSize)
 {
     errno_t rc;
-    if (parcel == NULL || src == NULL || dataSize == 0) {
+    if (parcel == NULL || src == NULL || dataSize == 0 || parcel->isReadOnly) {
         return HC_FALSE;
     }
     if (parcel->endPos > PARCEL_UINT_MAX - dataSize) {
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hc_rwlock.h"
+
+#include "hc_log.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int32_t InitHcRwLock(HcRwLock *rwLock)
+{
+    if (rwLock == NULL) {
+        return -1;
+    }
+    int res = pthread_rwlock_init(&rwLock->rwlock, NULL);
+    if (res != 0) {
+        LOGE("[OS]: pthread_rwlock_init fail. [Res]: %" LOG_PUB "d", res);
+        return res;
+    }
+    rwLock->isInitialized = true;
+    return 0;
+}
+
+void DestroyHcRwLock(HcRwLock *rwLock)
+{
+    if (rwLock == NULL || !rwLock->isInitialized) {
+        return;
+    }
+    int res = pthread_rwlock_destroy(&rwLock->rwlock);
+    if (res != 0) {
+        LOGW("[OS]: pthread_rwlock_destroy fail. [Res]: %" LOG_PUB "d", res);
+    }
+    rwLock->isInitialized = false;
+}
+
+int ReadLockHcRwLock(HcRwLock *rwLock)
+{
+    if (rwLock == NULL || !rwLock->isInitialized) {
+        LOGE("[OS]: rwLock is not initialized!");
+        return -1;
+    }
+    int res = pthread_rwlock_rdlock(&rwLock->rwlock);
+    if (res != 0) {
+        LOGW("[OS]: pthread_rwlock_rdlock fail. [Res]: %" LOG_PUB "d", res);
+    }
+    return res;
+}
+
+int WriteLockHcRwLock(HcRwLock *rwLock)
+{
+    if (rwLock == NULL || !rwLock->isInitialized) {
+        LOGE("[OS]: rwLock is not initialized!");
+        return -1;
+    }
+    int res = pthread_rwlock_wrlock(&rwLock->rwlock);
+    if (res != 0) {
+        LOGW("[OS]: pthread_rwlock_wrlock fail. [Res]: %" LOG_PUB "d", res);
+    }
+    return res;
+}
+
+void UnlockHcRwLock(HcRwLock *rwLock)
+{
+    if (rwLock == NULL || !rwLock->isInitialized) {
+        LOGE("[OS]: rwLock is not initialized!");
+        return;
+    }
+    int res = pthread_rwlock_unlock(&rwLock->rwlock);
+    if (res != 0) {
+        LOGW("[OS]: pthread_rwlock_unlock fail. [Res]: %" LOG_PUB "d", res);
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -187,8 +187,8 @@ int32_t ParseAndSkipTlvUnknownNode(HcParcel *parcel)
         return TLV_FAIL;
     }
 
-    // pop data
-    if (!ParcelPopFront(parcel, length)) {
+    // pop data, an empty node has nothing to pop
+    if (length > 0 && !ParcelPopFront(parcel, length)) {
         return TLV_FAIL;
     }
 
@@ -387,11 +387,19 @@ int32_t ParseTlvString(TlvBase *tlv, HcParcel *parcel, HcBool strict)
     (void)strict;
     TlvString *realTlv = (TlvString *)(tlv);
     ClearParcel(&realTlv->data.parcel);
-    if (tlv->length == 0 || ParcelReadParcel(parcel, &realTlv->data.parcel, tlv->length, HC_FALSE)) {
+    if (tlv->length == 0) {
         return tlv->length;
-    } else {
+    }
+    if (!ParcelReadParcel(parcel, &realTlv->data.parcel, tlv->length, HC_FALSE)) {
+        return TLV_FAIL;
+    }
+    /* the string is used in place, so it must carry its own terminator */
+    const char *lastChar = GetParcelLastChar(&realTlv->data.parcel);
+    if (lastChar == NULL || *lastChar != '\0') {
+        ClearParcel(&realTlv->data.parcel);
         return TLV_FAIL;
     }
+    return tlv->length;
 }
 
 int32_t GetlenTlvString(TlvBase *tlv)
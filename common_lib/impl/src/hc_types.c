@@ -29,7 +29,7 @@ extern "C" {
 #define MAX_STR_LEN (512 * 1024)
 #define MAX_MALLOC_SIZE (1024 * 1024 * 100)
 
-void *HcMalloc(uint32_t size, char val)
+void *HcMallocUninit(uint32_t size)
 {
     if (size == 0) {
         LOGE("Malloc size is invalid.");
@@ -48,7 +48,15 @@ void *HcMalloc(uint32_t size, char val)
         LOGE("[OS]: malloc fail. [Size]: %" LOG_PUB "u", size);
         return NULL;
     }
-    (void)memset_s(addr, size, val, size);
+    return addr;
+}
+
+void *HcMalloc(uint32_t size, char val)
+{
+    void *addr = HcMallocUninit(size);
+    if (addr != NULL) {
+        (void)memset_s(addr, size, val, size);
+    }
     return addr;
 }
 
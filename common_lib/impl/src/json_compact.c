@@ -0,0 +1,412 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "json_compact.h"
+#include <string.h>
+#include "securec.h"
+#include "clib_error.h"
+#include "hc_log.h"
+#include "hc_types.h"
+#include "string_util.h"
+
+#define COMPACT_DATA_VERSION 1
+#define MAX_DEPTH 10
+#define JSON_TYPE_MASK 0xFF
+#define VARINT_MAX_LEN 10
+#define VARINT_SHIFT 7
+#define VARINT_VALUE_MASK 0x7F
+#define VARINT_CONTINUE_FLAG 0x80
+#define MAX_SAFE_INTEGER 9007199254740992.0
+#define DOUBLE_BYTE_LEN 8
+#define BITS_PER_BYTE 8
+#define HEX_CHUNK_LEN 64
+#define HEX_ALPHA_OFFSET 10
+#define NIBBLE_BITS 4
+
+typedef enum {
+    COMPACT_TAG_NULL = 0,
+    COMPACT_TAG_FALSE,
+    COMPACT_TAG_TRUE,
+    COMPACT_TAG_INT,
+    COMPACT_TAG_DOUBLE,
+    COMPACT_TAG_STRING,
+    COMPACT_TAG_HEX, /* upper case hex string, carried as the bytes it encodes */
+    COMPACT_TAG_ARRAY,
+    COMPACT_TAG_OBJECT,
+} CompactTag;
+
+typedef struct {
+    HcParcel *parcel;
+    char *hexBuf;
+    uint32_t hexBufLen;
+} CompactDecoder;
+
+static bool WriteVarint(HcParcel *parcel, uint64_t value)
+{
+    uint8_t bytes[VARINT_MAX_LEN];
+    uint32_t len = 0;
+    do {
+        uint8_t byte = (uint8_t)(value & VARINT_VALUE_MASK);
+        value >>= VARINT_SHIFT;
+        bytes[len++] = (value != 0) ? (byte | VARINT_CONTINUE_FLAG) : byte;
+    } while (value != 0);
+    return ParcelWrite(parcel, bytes, len);
+}
+
+static bool ReadVarint(HcParcel *parcel, uint64_t *value)
+{
+    uint64_t result = 0;
+    for (uint32_t shift = 0; shift < VARINT_MAX_LEN * VARINT_SHIFT; shift += VARINT_SHIFT) {
+        uint8_t byte;
+        if (!ParcelReadUint8(parcel, &byte)) {
+            return false;
+        }
+        result |= (uint64_t)(byte & VARINT_VALUE_MASK) << shift;
+        if ((byte & VARINT_CONTINUE_FLAG) == 0) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Every length prefix is bounded by the bytes left, so a forged length can never drive an allocation. */
+static bool ReadLength(HcParcel *parcel, uint32_t *len)
+{
+    uint64_t value;
+    if (!ReadVarint(parcel, &value) || (value > GetParcelDataSize(parcel))) {
+        LOGE("invalid length in compact data.");
+        return false;
+    }
+    *len = (uint32_t)value;
+    return true;
+}
+
+/* Strings and keys keep their terminator on the wire so that they can be used in place when decoding. */
+static bool WriteString(HcParcel *parcel, const char *str)
+{
+    uint32_t len = HcStrlen(str) + 1;
+    return WriteVarint(parcel, len) && ParcelWrite(parcel, str, len);
+}
+
+static const char *ReadString(HcParcel *parcel)
+{
+    uint32_t len;
+    if (!ReadLength(parcel, &len) || (len == 0)) {
+        return NULL;
+    }
+    const char *str = GetParcelData(parcel);
+    if ((str[len - 1] != '\0') || (memchr(str, '\0', len - 1) != NULL)) {
+        LOGE("invalid string in compact data.");
+        return NULL;
+    }
+    (void)ParcelPopFront(parcel, len);
+    return str;
+}
+
+static bool IsUpperHexString(const char *str, uint32_t len)
+{
+    if ((len == 0) || (len % BYTE_TO_HEX_OPER_LENGTH != 0)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < len; i++) {
+        if (!(((str[i] >= '0') && (str[i] <= '9')) || ((str[i] >= 'A') && (str[i] <= 'F')))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint8_t UpperHexToNibble(char c)
+{
+    return (c <= '9') ? (uint8_t)(c - '0') : (uint8_t)(c - 'A' + HEX_ALPHA_OFFSET);
+}
+
+static bool WriteHexString(HcParcel *parcel, const char *str, uint32_t len)
+{
+    uint32_t byteLen = len / BYTE_TO_HEX_OPER_LENGTH;
+    if (!ParcelWriteUint8(parcel, COMPACT_TAG_HEX) || !WriteVarint(parcel, byteLen) ||
+        !ParcelReserve(parcel, byteLen)) {
+        return false;
+    }
+    uint8_t chunk[HEX_CHUNK_LEN];
+    uint32_t chunkLen = 0;
+    for (uint32_t i = 0; i < byteLen; i++) {
+        chunk[chunkLen++] = (uint8_t)((UpperHexToNibble(str[i * BYTE_TO_HEX_OPER_LENGTH]) << NIBBLE_BITS) |
+            UpperHexToNibble(str[i * BYTE_TO_HEX_OPER_LENGTH + 1]));
+        if ((chunkLen == HEX_CHUNK_LEN) || (i + 1 == byteLen)) {
+            if (!ParcelWrite(parcel, chunk, chunkLen)) {
+                return false;
+            }
+            chunkLen = 0;
+        }
+    }
+    return true;
+}
+
+static const char *ReadHexString(CompactDecoder *decoder)
+{
+    uint32_t byteLen;
+    if (!ReadLength(decoder->parcel, &byteLen) || (byteLen == 0) ||
+        (byteLen > (UINT32_MAX - 1) / BYTE_TO_HEX_OPER_LENGTH)) {
+        return NULL;
+    }
+    uint32_t hexLen = byteLen * BYTE_TO_HEX_OPER_LENGTH + 1;
+    if (decoder->hexBufLen < hexLen) {
+        char *hexBuf = (char *)HcMallocUninit(hexLen);
+        if (hexBuf == NULL) {
+            LOGE("allocate hex buffer fail.");
+            return NULL;
+        }
+        HcFree(decoder->hexBuf);
+        decoder->hexBuf = hexBuf;
+        decoder->hexBufLen = hexLen;
+    }
+    const uint8_t *bytes = (const uint8_t *)GetParcelData(decoder->parcel);
+    if (ByteToHexString(bytes, byteLen, decoder->hexBuf, decoder->hexBufLen) != CLIB_SUCCESS) {
+        return NULL;
+    }
+    (void)ParcelPopFront(decoder->parcel, byteLen);
+    return decoder->hexBuf;
+}
+
+static bool WriteStringValue(HcParcel *parcel, const char *str)
+{
+    if (str == NULL) {
+        return false;
+    }
+    uint32_t len = HcStrlen(str);
+    if (IsUpperHexString(str, len)) {
+        return WriteHexString(parcel, str, len);
+    }
+    return ParcelWriteUint8(parcel, COMPACT_TAG_STRING) && WriteString(parcel, str);
+}
+
+static bool WriteNumber(HcParcel *parcel, double value)
+{
+    /* integral values are what the protocols send, NaN fails the range check before the cast */
+    if ((value > -MAX_SAFE_INTEGER) && (value < MAX_SAFE_INTEGER) && ((double)(int64_t)value == value)) {
+        int64_t intValue = (int64_t)value;
+        uint64_t zigzag = (intValue < 0) ? ~((uint64_t)intValue << 1) : ((uint64_t)intValue << 1);
+        return ParcelWriteUint8(parcel, COMPACT_TAG_INT) && WriteVarint(parcel, zigzag);
+    }
+    uint64_t bits = 0;
+    if (memcpy_s(&bits, sizeof(bits), &value, sizeof(value)) != EOK) {
+        return false;
+    }
+    uint8_t bytes[DOUBLE_BYTE_LEN];
+    for (uint32_t i = 0; i < DOUBLE_BYTE_LEN; i++) {
+        bytes[i] = (uint8_t)(bits >> ((DOUBLE_BYTE_LEN - 1 - i) * BITS_PER_BYTE));
+    }
+    return ParcelWriteUint8(parcel, COMPACT_TAG_DOUBLE) && ParcelWrite(parcel, bytes, DOUBLE_BYTE_LEN);
+}
+
+static CJson *ReadInt(HcParcel *parcel)
+{
+    uint64_t zigzag;
+    if (!ReadVarint(parcel, &zigzag)) {
+        return NULL;
+    }
+    int64_t value = ((zigzag & 1) != 0) ? (int64_t)~(zigzag >> 1) : (int64_t)(zigzag >> 1);
+    return cJSON_CreateNumber((double)value);
+}
+
+static CJson *ReadDouble(HcParcel *parcel)
+{
+    uint8_t bytes[DOUBLE_BYTE_LEN];
+    if (!ParcelRead(parcel, bytes, DOUBLE_BYTE_LEN)) {
+        return NULL;
+    }
+    uint64_t bits = 0;
+    for (uint32_t i = 0; i < DOUBLE_BYTE_LEN; i++) {
+        bits = (bits << BITS_PER_BYTE) | bytes[i];
+    }
+    double value = 0;
+    if (memcpy_s(&value, sizeof(value), &bits, sizeof(bits)) != EOK) {
+        return NULL;
+    }
+    return cJSON_CreateNumber(value);
+}
+
+static int32_t EncodeItem(const CJson *item, HcParcel *parcel, uint32_t depth);
+
+static int32_t EncodeChildren(const CJson *item, HcParcel *parcel, uint32_t depth)
+{
+    if (depth >= MAX_DEPTH) {
+        LOGE("json depth over %" LOG_PUB "d", MAX_DEPTH);
+        return CLIB_ERR_INVALID_PARAM;
+    }
+    bool isObject = cJSON_IsObject(item);
+    int32_t count = cJSON_GetArraySize(item);
+    if (!ParcelWriteUint8(parcel, isObject ? COMPACT_TAG_OBJECT : COMPACT_TAG_ARRAY) ||
+        !WriteVarint(parcel, (uint64_t)count)) {
+        return CLIB_ERR_BAD_ALLOC;
+    }
+    const CJson *child = NULL;
+    cJSON_ArrayForEach(child, item) {
+        if (isObject && ((child->string == NULL) || !WriteString(parcel, child->string))) {
+            return CLIB_ERR_BAD_ALLOC;
+        }
+        int32_t res = EncodeItem(child, parcel, depth + 1);
+        if (res != CLIB_SUCCESS) {
+            return res;
+        }
+    }
+    return CLIB_SUCCESS;
+}
+
+static int32_t EncodeItem(const CJson *item, HcParcel *parcel, uint32_t depth)
+{
+    bool isSuccess;
+    switch (item->type & JSON_TYPE_MASK) {
+        case cJSON_NULL:
+            isSuccess = ParcelWriteUint8(parcel, COMPACT_TAG_NULL);
+            break;
+        case cJSON_False:
+            isSuccess = ParcelWriteUint8(parcel, COMPACT_TAG_FALSE);
+            break;
+        case cJSON_True:
+            isSuccess = ParcelWriteUint8(parcel, COMPACT_TAG_TRUE);
+            break;
+        case cJSON_Number:
+            isSuccess = WriteNumber(parcel, item->valuedouble);
+            break;
+        case cJSON_String:
+            isSuccess = WriteStringValue(parcel, item->valuestring);
+            break;
+        case cJSON_Array:
+        case cJSON_Object:
+            return EncodeChildren(item, parcel, depth);
+        default:
+            LOGE("unsupported json type for compact data.");
+            return CLIB_ERR_INVALID_PARAM;
+    }
+    return isSuccess ? CLIB_SUCCESS : CLIB_ERR_BAD_ALLOC;
+}
+
+int32_t PackJsonToCompactData(const CJson *jsonObj, HcParcel *parcel)
+{
+    if ((jsonObj == NULL) || (parcel == NULL)) {
+        return CLIB_ERR_NULL_PTR;
+    }
+    if (!ParcelWriteUint8(parcel, COMPACT_DATA_VERSION)) {
+        return CLIB_ERR_BAD_ALLOC;
+    }
+    return EncodeItem(jsonObj, parcel, 0);
+}
+
+static CJson *DecodeItem(CompactDecoder *decoder, uint32_t depth);
+
+static bool DecodeChild(CompactDecoder *decoder, CJson *container, bool isObject, uint32_t depth)
+{
+    const char *key = NULL;
+    if (isObject) {
+        key = ReadString(decoder->parcel);
+        if (key == NULL) {
+            return false;
+        }
+    }
+    CJson *child = DecodeItem(decoder, depth);
+    if (child == NULL) {
+        return false;
+    }
+    cJSON_bool isAdded = isObject ? cJSON_AddItemToObject(container, key, child) :
+        cJSON_AddItemToArray(container, child);
+    if (!isAdded) {
+        cJSON_Delete(child);
+        return false;
+    }
+    return true;
+}
+
+static CJson *DecodeChildren(CompactDecoder *decoder, bool isObject, uint32_t depth)
+{
+    if (depth >= MAX_DEPTH) {
+        LOGE("compact data depth over %" LOG_PUB "d", MAX_DEPTH);
+        return NULL;
+    }
+    uint32_t count;
+    if (!ReadLength(decoder->parcel, &count)) {
+        return NULL;
+    }
+    CJson *container = isObject ? cJSON_CreateObject() : cJSON_CreateArray();
+    if (container == NULL) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (!DecodeChild(decoder, container, isObject, depth + 1)) {
+            cJSON_Delete(container);
+            return NULL;
+        }
+    }
+    return container;
+}
+
+static CJson *DecodeStringItem(const char *str)
+{
+    return (str == NULL) ? NULL : cJSON_CreateString(str);
+}
+
+static CJson *DecodeItem(CompactDecoder *decoder, uint32_t depth)
+{
+    uint8_t tag;
+    if (!ParcelReadUint8(decoder->parcel, &tag)) {
+        return NULL;
+    }
+    switch (tag) {
+        case COMPACT_TAG_NULL:
+            return cJSON_CreateNull();
+        case COMPACT_TAG_FALSE:
+            return cJSON_CreateFalse();
+        case COMPACT_TAG_TRUE:
+            return cJSON_CreateTrue();
+        case COMPACT_TAG_INT:
+            return ReadInt(decoder->parcel);
+        case COMPACT_TAG_DOUBLE:
+            return ReadDouble(decoder->parcel);
+        case COMPACT_TAG_STRING:
+            return DecodeStringItem(ReadString(decoder->parcel));
+        case COMPACT_TAG_HEX:
+            return DecodeStringItem(ReadHexString(decoder));
+        case COMPACT_TAG_ARRAY:
+        case COMPACT_TAG_OBJECT:
+            return DecodeChildren(decoder, tag == COMPACT_TAG_OBJECT, depth);
+        default:
+            LOGE("unknown tag in compact data. [Tag]: %" LOG_PUB "u", tag);
+            return NULL;
+    }
+}
+
+CJson *CreateJsonFromCompactData(const uint8_t *data, uint32_t dataLen)
+{
+    if ((data == NULL) || (dataLen == 0)) {
+        return NULL;
+    }
+    HcParcel parcel = CreateReadOnlyParcel((char *)data, dataLen, NULL);
+    uint8_t version;
+    if (!ParcelReadUint8(&parcel, &version) || (version != COMPACT_DATA_VERSION)) {
+        LOGE("unsupported compact data version.");
+        return NULL;
+    }
+    CompactDecoder decoder = { &parcel, NULL, 0 };
+    CJson *jsonObj = DecodeItem(&decoder, 0);
+    HcFree(decoder.hexBuf);
+    if ((jsonObj != NULL) && (GetParcelDataSize(&parcel) != 0)) {
+        LOGE("unexpected trailing bytes in compact data.");
+        cJSON_Delete(jsonObj);
+        return NULL;
+    }
+    return jsonObj;
+}
@@ -26,25 +26,28 @@
 #define MAX_DEPTH 10
 #define MAX_LEN 5
 #define BIG_INT_ARR "bigIntArr"
-#define SPLIT_LEN_ONE 1
-#define SPLIT_LEN_TWO 2
 
-static int32_t GetCjsonMaxDepth(const char *jsonStr)
+/*
+ * Scan at most maxLen chars up to the terminator, stop as soon as the nesting gets deeper than MAX_DEPTH.
+ * The scanned length is returned through strLen so that the parser does not need to look for the end again.
+ */
+static bool IsJsonDepthValid(const char *jsonStr, uint32_t maxLen, uint32_t *strLen)
 {
-    int32_t max = 0;
-    uint32_t len = HcStrlen(jsonStr);
-    int32_t cnt = 0;
-    for (uint32_t i = 0; i < len; i++) {
+    int32_t depth = 0;
+    uint32_t i = 0;
+    for (; i < maxLen && jsonStr[i] != '\0'; i++) {
         if (jsonStr[i] == '{' || jsonStr[i] == '[') {
-            cnt++;
-            if (cnt > max) {
-                max = cnt;
+            depth++;
+            if (depth > MAX_DEPTH) {
+                LOGE("jsonStr depth over %" LOG_PUB "d", MAX_DEPTH);
+                return false;
             }
         } else if (jsonStr[i] == '}' || jsonStr[i] == ']') {
-            cnt--;
+            depth--;
         }
     }
-    return max;
+    *strLen = i;
+    return true;
 }
 
 CJson *CreateJsonFromString(const char *jsonStr)
@@ -52,24 +55,25 @@ CJson *CreateJsonFromString(const char *jsonStr)
     if (jsonStr == NULL) {
         return NULL;
     }
-    int32_t depth = GetCjsonMaxDepth(jsonStr);
-    if (depth > MAX_DEPTH) {
-        LOGE("jsonStr depth %" LOG_PUB "d over 10", depth);
+    uint32_t len = 0;
+    if (!IsJsonDepthValid(jsonStr, UINT32_MAX, &len)) {
         return NULL;
     }
-    return cJSON_Parse(jsonStr);
+    return cJSON_ParseWithLength(jsonStr, len);
 }
 
 int32_t CreateJsonFromData(const uint8_t *data, uint32_t dataLen, CJson **outJson)
 {
-    char *dataStr = NULL;
-    int32_t ret = GenerateStringFromData(data, dataLen, &dataStr);
-    if (ret != CLIB_SUCCESS) {
-        LOGE("Failed to generate string from data!");
-        return ret;
+    if (data == NULL || dataLen == 0 || outJson == NULL) {
+        LOGE("Invalid json data!");
+        return CLIB_ERR_INVALID_PARAM;
+    }
+    /* parse the buffer in place, the data may or may not be terminated within dataLen */
+    uint32_t len = 0;
+    if (!IsJsonDepthValid((const char *)data, dataLen, &len)) {
+        return CLIB_ERR_JSON_CREATE;
     }
-    CJson *tmpJson = CreateJsonFromString(dataStr);
-    HcFree(dataStr);
+    CJson *tmpJson = cJSON_ParseWithLength((const char *)data, len);
     if (tmpJson == NULL) {
         LOGE("Failed to create data json!");
         return CLIB_ERR_JSON_CREATE;
@@ -150,113 +154,64 @@ CJson *DetachItemFromJson(CJson *jsonObj, const char *key)
     return cJSON_DetachItemFromObjectCaseSensitive(jsonObj, key);
 }
 
-static void ReplaceStringToInt(char *input, const char *keyName)
+static bool IsDigitString(const char *str)
 {
-    if (keyName == NULL) {
-        LOGE("input keyName is NULL.");
-        return;
-    }
-    uint32_t keywordLen = SPLIT_LEN_ONE + HcStrlen(keyName) + SPLIT_LEN_TWO;
-    char keyword[keywordLen + 1];
-    keyword[0] = '"';
-    if (strcpy_s(&keyword[1], HcStrlen(keyName) + 1, keyName) != EOK) {
-        LOGE("failed to copy keyword to buffer.");
-        return;
-    }
-    keyword[keywordLen - SPLIT_LEN_TWO] = '"';
-    keyword[keywordLen - SPLIT_LEN_ONE] = ':';
-    keyword[keywordLen] = '\0';
-    const char * const pos1 = strstr(input, keyword);
-    if (pos1 == NULL) {
-        LOGW("keyword not found.");
-        return;
+    if (str == NULL || *str == '\0') {
+        return false;
     }
-    const char * const pos2 = strstr(pos1 + keywordLen + 1, "\"");
-    if (pos2 == NULL) {
-        LOGW("json key format parse error.");
-        return;
-    }
-    uint32_t startOffset = pos1 - input + keywordLen;
-    uint32_t endOffset = pos2 - input;
-
-    bool shouldReplace = true;
-    for (uint32_t i = startOffset + 1; i < endOffset; i++) {
-        // only replace if the content is only composed of digits
-        shouldReplace &= input[i] >= '0' && input[i] <= '9';
-    }
-
-    if (shouldReplace) {
-        uint32_t readI = startOffset + SPLIT_LEN_ONE;
-        uint32_t writeI = startOffset;
-        while (input[readI] != '\0') {
-            input[writeI] = input[readI];
-            readI++;
-            writeI++;
-            if (readI == endOffset) {
-                readI++;
-            }
+    for (; *str != '\0'; str++) {
+        if (*str < '0' || *str > '9') {
+            return false;
         }
-        input[writeI] = '\0';
     }
+    return true;
 }
 
-static char **CreateKeyList(CJson *arr)
+/* Items are visited in the order they are printed, so the result is the first "key": of the output. */
+static CJson *GetFirstItemByKey(const CJson *jsonObj, const char *key)
 {
-    int keyListSize = GetItemNum(arr);
-    char **keyList = HcMalloc(keyListSize * sizeof(char *), 0);
-    if (keyList == NULL) {
-        LOGE("Malloc keyList failed.");
-        return NULL;
-    }
-    for (int i = 0; i < keyListSize; i++) {
-        const char *str = GetStringValue(GetItemFromArray(arr, i));
-        if (str == NULL) {
-            keyList[i] = NULL;
-        } else {
-            keyList[i] = strdup(str);
+    CJson *child = NULL;
+    cJSON_ArrayForEach(child, jsonObj) {
+        if (IsStrEqual(child->string, key)) {
+            return child;
+        }
+        CJson *item = GetFirstItemByKey(child, key);
+        if (item != NULL) {
+            return item;
         }
     }
-    return keyList;
-}
-
-static void DestroyKeyList(int size, char **keyList)
-{
-    for (int i = 0; i < size; i++) {
-        HcFree(keyList[i]);
-    }
-    HcFree(keyList);
+    return NULL;
 }
 
-static char *PackJsonWithBigIntArrToString(const CJson *jsonObj, CJson *arr)
+/*
+ * Print the numeric string fields listed in bigIntArr as raw integers, without the bigIntArr itself.
+ * The input may be shared between threads, so the listed items are switched to raw items in a copy
+ * of the tree and the copy is printed in a single pass.
+ */
+static char *PackJsonWithBigIntArrToString(const CJson *jsonObj, const CJson *arr)
 {
-    int keyListSize = GetItemNum(arr);
-    char **keyList = CreateKeyList(arr);
-    if (keyList == NULL) {
-        return NULL;
-    }
     CJson *dupJson = cJSON_Duplicate(jsonObj, RECURSE_FLAG_TRUE);
     if (dupJson == NULL) {
-        DestroyKeyList(keyListSize, keyList);
         LOGE("duplicate json failed.");
         return NULL;
     }
-    cJSON_DeleteItemFromObject(dupJson, BIG_INT_ARR);
-
-    char *jsonStr = NULL;
-    do {
-        jsonStr = cJSON_PrintUnformatted(dupJson);
-        if (jsonStr == NULL) {
-            LOGE("dup json to str failed.");
-            break;
+    cJSON_DeleteItemFromObjectCaseSensitive(dupJson, BIG_INT_ARR);
+    const CJson *keyItem = NULL;
+    cJSON_ArrayForEach(keyItem, arr) {
+        const char *key = GetStringValue(keyItem);
+        if (key == NULL) {
+            continue;
         }
-        for (int i = 0; i < keyListSize; i++) {
-            if (keyList[i] != NULL) {
-                ReplaceStringToInt(jsonStr, keyList[i]);
-            }
+        CJson *item = GetFirstItemByKey(dupJson, key);
+        if (item != NULL && cJSON_IsString(item) && IsDigitString(item->valuestring)) {
+            item->type = (item->type & ~0xFF) | cJSON_Raw;
         }
-    } while (0);
+    }
+    char *jsonStr = cJSON_PrintUnformatted(dupJson);
+    if (jsonStr == NULL) {
+        LOGE("dup json to str failed.");
+    }
     cJSON_Delete(dupJson);
-    DestroyKeyList(keyListSize, keyList);
     return jsonStr;
 }
 
@@ -295,31 +250,43 @@ const char *GetItemKey(const CJson *item)
     return item->string;
 }
 
-CJson *GetObjFromJson(const CJson *jsonObj, const char *key)
+static cJSON_bool IsAnyItem(const cJSON * const item)
 {
-    if (jsonObj == NULL || key == NULL) {
-        return NULL;
-    }
-
-    cJSON *objValue = cJSON_GetObjectItemCaseSensitive(jsonObj, key);
-    if (objValue != NULL) {
-        return objValue;
-    }
+    (void)item;
+    return true;
+}
 
-    int len = cJSON_GetArraySize(jsonObj);
-    for (int i = 0; i < len; i++) {
-        cJSON *item = cJSON_GetArrayItem(jsonObj, i);
-        if (cJSON_IsObject(item)) {
-            cJSON *obj = GetObjFromJson(item, key);
-            if (obj != NULL) {
-                return obj;
+/*
+ * Look the key up in the object first, then depth-first in the nested objects.
+ * Children are walked through the sibling list, indexing them one by one would rescan the list for every child.
+ */
+static cJSON *GetItemByTypeFromJson(const CJson *jsonObj, const char *key, cJSON_bool (*isType)(const cJSON * const))
+{
+    cJSON *item = cJSON_GetObjectItemCaseSensitive(jsonObj, key);
+    if (item != NULL && isType(item)) {
+        return item;
+    }
+    cJSON *child = NULL;
+    cJSON_ArrayForEach(child, jsonObj) {
+        if (cJSON_IsObject(child)) {
+            item = GetItemByTypeFromJson(child, key, isType);
+            if (item != NULL) {
+                return item;
             }
         }
     }
-
     return NULL;
 }
 
+CJson *GetObjFromJson(const CJson *jsonObj, const char *key)
+{
+    if (jsonObj == NULL || key == NULL) {
+        return NULL;
+    }
+
+    return GetItemByTypeFromJson(jsonObj, key, IsAnyItem);
+}
+
 CJson *GetItemFromArray(const CJson *jsonArr, int index)
 {
     if (jsonArr == NULL) {
@@ -334,23 +301,11 @@ const char *GetStringFromJson(const CJson *jsonObj, const char *key)
         return NULL;
     }
 
-    cJSON *jsonObjTmp = cJSON_GetObjectItemCaseSensitive(jsonObj, key);
-    if (jsonObjTmp != NULL && cJSON_IsString(jsonObjTmp)) {
-        return cJSON_GetStringValue(jsonObjTmp);
-    }
-
-    int len = cJSON_GetArraySize(jsonObj);
-    for (int i = 0; i < len; i++) {
-        cJSON *item = cJSON_GetArrayItem(jsonObj, i);
-        if (cJSON_IsObject(item)) {
-            const char *resValue = GetStringFromJson(item, key);
-            if (resValue != NULL) {
-                return resValue;
-            }
-        }
+    cJSON *jsonObjTmp = GetItemByTypeFromJson(jsonObj, key, cJSON_IsString);
+    if (jsonObjTmp == NULL) {
+        return NULL;
     }
-
-    return NULL;
+    return cJSON_GetStringValue(jsonObjTmp);
 }
 
 int32_t GetByteLenFromJson(const CJson *jsonObj, const char *key, uint32_t *byteLen)
@@ -389,24 +344,12 @@ int32_t GetIntFromJson(const CJson *jsonObj, const char *key, int32_t *value)
         return CLIB_ERR_NULL_PTR;
     }
 
-    cJSON *jsonObjTmp = cJSON_GetObjectItemCaseSensitive(jsonObj, key);
-    if (jsonObjTmp != NULL && cJSON_IsNumber(jsonObjTmp)) {
-        *value = (int)cJSON_GetNumberValue(jsonObjTmp);
-        return CLIB_SUCCESS;
-    }
-
-    int len = cJSON_GetArraySize(jsonObj);
-    for (int i = 0; i < len; i++) {
-        cJSON *item = cJSON_GetArrayItem(jsonObj, i);
-        if (cJSON_IsObject(item)) {
-            int32_t ret = GetIntFromJson(item, key, value);
-            if (ret == CLIB_SUCCESS) {
-                return ret;
-            }
-        }
+    cJSON *jsonObjTmp = GetItemByTypeFromJson(jsonObj, key, cJSON_IsNumber);
+    if (jsonObjTmp == NULL) {
+        return CLIB_ERR_JSON_GET;
     }
-
-    return CLIB_ERR_JSON_GET;
+    *value = (int)cJSON_GetNumberValue(jsonObjTmp);
+    return CLIB_SUCCESS;
 }
 
 int32_t GetUnsignedIntFromJson(const CJson *jsonObj, const char *key, uint32_t *value)
@@ -415,30 +358,18 @@ int32_t GetUnsignedIntFromJson(const CJson *jsonObj, const char *key, uint32_t *
         return CLIB_ERR_NULL_PTR;
     }
 
-    cJSON *jsonObjTmp = cJSON_GetObjectItemCaseSensitive(jsonObj, key);
-    if (jsonObjTmp != NULL && cJSON_IsNumber(jsonObjTmp)) {
-        double realValue = cJSON_GetNumberValue(jsonObjTmp);
-        if (realValue < 0) {
-            int32_t tmpValue = (int32_t)realValue;
-            *value = (uint32_t)tmpValue;
-        } else {
-            *value = (uint32_t)realValue;
-        }
-        return CLIB_SUCCESS;
+    cJSON *jsonObjTmp = GetItemByTypeFromJson(jsonObj, key, cJSON_IsNumber);
+    if (jsonObjTmp == NULL) {
+        return CLIB_ERR_JSON_GET;
     }
-
-    int len = cJSON_GetArraySize(jsonObj);
-    for (int i = 0; i < len; i++) {
-        cJSON *item = cJSON_GetArrayItem(jsonObj, i);
-        if (cJSON_IsObject(item)) {
-            int32_t ret = GetUnsignedIntFromJson(item, key, value);
-            if (ret == CLIB_SUCCESS) {
-                return ret;
-            }
-        }
+    double realValue = cJSON_GetNumberValue(jsonObjTmp);
+    if (realValue < 0) {
+        int32_t tmpValue = (int32_t)realValue;
+        *value = (uint32_t)tmpValue;
+    } else {
+        *value = (uint32_t)realValue;
     }
-
-    return CLIB_ERR_JSON_GET;
+    return CLIB_SUCCESS;
 }
 
 int32_t GetUint8FromJson(const CJson *jsonObj, const char *key, uint8_t *value)
@@ -447,30 +378,18 @@ int32_t GetUint8FromJson(const CJson *jsonObj, const char *key, uint8_t *value)
         return CLIB_ERR_NULL_PTR;
     }
 
-    cJSON *jsonObjTmp = cJSON_GetObjectItemCaseSensitive(jsonObj, key);
-    if (jsonObjTmp != NULL && cJSON_IsNumber(jsonObjTmp)) {
-        double realValue = cJSON_GetNumberValue(jsonObjTmp);
-        if (realValue < 0) {
-            int8_t tmpValue = (int8_t)realValue;
-            *value = (uint8_t)tmpValue;
-        } else {
-            *value = (uint8_t)realValue;
-        }
-        return CLIB_SUCCESS;
+    cJSON *jsonObjTmp = GetItemByTypeFromJson(jsonObj, key, cJSON_IsNumber);
+    if (jsonObjTmp == NULL) {
+        return CLIB_ERR_JSON_GET;
     }
-
-    int len = cJSON_GetArraySize(jsonObj);
-    for (int i = 0; i < len; i++) {
-        cJSON *item = cJSON_GetArrayItem(jsonObj, i);
-        if (cJSON_IsObject(item)) {
-            int8_t ret = GetUint8FromJson(item, key, value);
-            if (ret == CLIB_SUCCESS) {
-                return ret;
-            }
-        }
+    double realValue = cJSON_GetNumberValue(jsonObjTmp);
+    if (realValue < 0) {
+        int8_t tmpValue = (int8_t)realValue;
+        *value = (uint8_t)tmpValue;
+    } else {
+        *value = (uint8_t)realValue;
     }
-
-    return CLIB_ERR_JSON_GET;
+    return CLIB_SUCCESS;
 }
 
 int32_t GetInt64FromJson(const CJson *jsonObj, const char *key, int64_t *value)
@@ -489,24 +408,12 @@ int32_t GetBoolFromJson(const CJson *jsonObj, const char *key, bool *value)
         return CLIB_ERR_NULL_PTR;
     }
 
-    cJSON *jsonObjTmp = cJSON_GetObjectItemCaseSensitive(jsonObj, key);
-    if (jsonObjTmp != NULL && cJSON_IsBool(jsonObjTmp)) {
-        *value = cJSON_IsTrue(jsonObjTmp) ? true : false;
-        return CLIB_SUCCESS;
-    }
-
-    int len = cJSON_GetArraySize(jsonObj);
-    for (int i = 0; i < len; i++) {
-        cJSON *item = cJSON_GetArrayItem(jsonObj, i);
-        if (cJSON_IsObject(item)) {
-            int32_t ret = GetBoolFromJson(item, key, value);
-            if (ret == CLIB_SUCCESS) {
-                return ret;
-            }
-        }
+    cJSON *jsonObjTmp = GetItemByTypeFromJson(jsonObj, key, cJSON_IsBool);
+    if (jsonObjTmp == NULL) {
+        return CLIB_ERR_JSON_GET;
     }
-
-    return CLIB_ERR_JSON_GET;
+    *value = cJSON_IsTrue(jsonObjTmp) ? true : false;
+    return CLIB_SUCCESS;
 }
 
 char *GetStringValue(const CJson *item)
@@ -24,16 +24,25 @@
 #include "hc_log.h"
 
 #define OUT_OF_HEX 16
-#define NUMBER_9_IN_DECIMAL 9
+#define HEX_HIGH_SHIFT 4
+#define HEX_LOW_MASK 0x0F
 #define ASCII_CASE_DIFFERENCE_VALUE 32
 #define MIN_ANONYMOUS_LEN 6
 #define ANONYMOUS_ASTERISK_LEN 2
 #define ANONYMOUS_DIVIDER 2
 
-static char HexToChar(uint8_t hex)
-{
-    return (hex > NUMBER_9_IN_DECIMAL) ? (hex + 0x37) : (hex + 0x30); /* Convert to the corresponding character */
-}
+static const char HEX_CHARS[] = "0123456789ABCDEF";
+
+/* Value of the chars from '0' to 'f', OUT_OF_HEX for the non-hex chars in between */
+static const uint8_t HEX_VALUES['f' - '0' + 1] = {
+    0, 1, 2, 3, 4, 5, 6, 7, /* 0x30 */
+    8, 9, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, 10, 11, 12, 13, 14, 15, OUT_OF_HEX, /* 0x40 */
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, /* 0x50 */
+    OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX, OUT_OF_HEX,
+    OUT_OF_HEX, 10, 11, 12, 13, 14, 15, /* 0x60 */
+};
 
 int32_t ByteToHexString(const uint8_t *byte, uint32_t byteLen, char *hexStr, uint32_t hexLen)
 {
@@ -45,26 +54,21 @@ int32_t ByteToHexString(const uint8_t *byte, uint32_t byteLen, char *hexStr, uin
         return CLIB_ERR_INVALID_LEN;
     }
 
+    char *out = hexStr;
     for (uint32_t i = 0; i < byteLen; i++) {
-        hexStr[i * BYTE_TO_HEX_OPER_LENGTH] = HexToChar((byte[i] & 0xF0) >> 4); /* 4: shift right for filling */
-        hexStr[i * BYTE_TO_HEX_OPER_LENGTH + 1] = HexToChar(byte[i] & 0x0F); /* get low four bits */
+        *out++ = HEX_CHARS[byte[i] >> HEX_HIGH_SHIFT];
+        *out++ = HEX_CHARS[byte[i] & HEX_LOW_MASK];
     }
-    hexStr[byteLen * BYTE_TO_HEX_OPER_LENGTH] = '\0';
+    *out = '\0';
 
     return CLIB_SUCCESS;
 }
 
 static uint8_t CharToHex(char c)
 {
-    if ((c >= 'A') && (c <= 'F')) {
-        return (c - 'A' + DEC);
-    } else if ((c >= 'a') && (c <= 'f')) {
-        return (c - 'a' + DEC);
-    } else if ((c >= '0') && (c <= '9')) {
-        return (c - '0');
-    } else {
-        return OUT_OF_HEX;
-    }
+    /* chars below '0' wrap around to large indexes and fail the bound check as well */
+    uint8_t index = (uint8_t)((uint8_t)c - '0');
+    return (index < sizeof(HEX_VALUES)) ? HEX_VALUES[index] : OUT_OF_HEX;
 }
 
 int32_t HexStringToByte(const char *hexStr, uint8_t *byte, uint32_t byteLen)
@@ -78,14 +82,15 @@ int32_t HexStringToByte(const char *hexStr, uint8_t *byte, uint32_t byteLen)
         return CLIB_ERR_INVALID_LEN;
     }
 
+    const char *in = hexStr;
     for (uint32_t i = 0; i < realHexLen / BYTE_TO_HEX_OPER_LENGTH; i++) {
-        uint8_t high = CharToHex(hexStr[i * BYTE_TO_HEX_OPER_LENGTH]);
-        uint8_t low = CharToHex(hexStr[i * BYTE_TO_HEX_OPER_LENGTH + 1]);
-        if (high == OUT_OF_HEX || low == OUT_OF_HEX) {
+        uint8_t high = CharToHex(*in++);
+        uint8_t low = CharToHex(*in++);
+        /* OUT_OF_HEX is the only value with bits above the low nibble */
+        if (((high | low) & ~HEX_LOW_MASK) != 0) {
             return CLIB_ERR_INVALID_PARAM;
         }
-        byte[i] = high << 4; /* 4: Set the high nibble */
-        byte[i] |= low; /* Set the low nibble */
+        byte[i] = (uint8_t)((high << HEX_HIGH_SHIFT) | low);
     }
     return CLIB_SUCCESS;
 }
@@ -202,7 +207,7 @@ int32_t GenerateStringFromData(const uint8_t *data, uint32_t dataLen, char **out
     if (data == NULL || dataLen == 0 || outStr == NULL) {
         return CLIB_ERR_INVALID_PARAM;
     }
-    char *tmpStr = (char *)HcMalloc(dataLen + 1, 0);
+    char *tmpStr = (char *)HcMallocUninit(dataLen + 1);
     if (tmpStr == NULL) {
         return CLIB_ERR_BAD_ALLOC;
     }
@@ -210,6 +215,7 @@ int32_t GenerateStringFromData(const uint8_t *data, uint32_t dataLen, char **out
         HcFree(tmpStr);
         return CLIB_ERR_MEMORY_COPY;
     }
+    tmpStr[dataLen] = '\0';
     *outStr = tmpStr;
     return CLIB_SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HC_ARENA_H
+#define HC_ARENA_H
+
+#include <stdint.h>
+
+/*
+ * A bump allocator for objects sharing one owner lifetime.
+ * Memory handed out by the arena is zeroed and must not be released with HcFree,
+ * everything is wiped and freed at once by DestroyArena.
+ */
+typedef struct HcArenaChunkT {
+    struct HcArenaChunkT *next;
+    uint32_t size;
+    uint32_t used;
+} HcArenaChunk;
+
+typedef struct {
+    HcArenaChunk *head;
+    uint32_t chunkSize;
+} HcArena;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void InitArena(HcArena *arena, uint32_t chunkSize);
+void *ArenaAlloc(HcArena *arena, uint32_t size);
+int32_t ArenaCopyString(HcArena *arena, const char *str, char **newStr);
+void DestroyArena(HcArena *arena);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -26,21 +26,32 @@ extern "C" {
 #define PARCEL_DEFAULT_LENGTH 0
 #define PARCEL_DEFAULT_ALLOC_UNIT 0
 
+typedef void (*ParcelDataReleaser)(char *data, uint32_t length);
+
 typedef struct {
     char *data;
     unsigned int beginPos;
     unsigned int endPos;
     unsigned int length;
     unsigned int allocUnit;
+    HcBool isReadOnly;
+    ParcelDataReleaser releaser;
 } HcParcel;
 
 HcParcel CreateParcel(uint32_t size, uint32_t allocUnit);
+/*
+ * Wrap an existing buffer without copying it. The parcel can only be read, and the releaser
+ * (if not NULL) is called with the buffer instead of HcFree when the parcel is deleted.
+ */
+HcParcel CreateReadOnlyParcel(char *data, uint32_t size, ParcelDataReleaser releaser);
 void DeleteParcel(HcParcel *parcel);
 void ClearParcel(HcParcel *parcel);
 void ResetParcel(HcParcel *parcel, uint32_t size, uint32_t allocUnit);
 HcBool ParcelReadWithoutPopData(HcParcel *parcel, void *dst, uint32_t dataSize);
 HcBool ParcelRead(HcParcel *parcel, void *dst, uint32_t dataSize);
 HcBool ParcelWrite(HcParcel *parcel, const void *src, uint32_t dataSize);
+/* Make sure that at least size bytes can be written without another allocation. */
+HcBool ParcelReserve(HcParcel *parcel, uint32_t size);
 HcBool ParcelReadRevert(HcParcel *parcel, void *dst, uint32_t dataSize);
 HcBool ParcelWriteRevert(HcParcel *parcel, const void *src, uint32_t dataSize);
 uint32_t GetParcelDataSize(const HcParcel *parcel);
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HC_RWLOCK_H
+#define HC_RWLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pthread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Reader/writer lock, readers run in parallel and writers are exclusive.
+ * The lock is not reentrant, a thread must not take it again in any mode before unlocking.
+ */
+typedef struct {
+    pthread_rwlock_t rwlock;
+    bool isInitialized;
+} HcRwLock;
+
+int32_t InitHcRwLock(HcRwLock *rwLock);
+void DestroyHcRwLock(HcRwLock *rwLock);
+
+int ReadLockHcRwLock(HcRwLock *rwLock);
+int WriteLockHcRwLock(HcRwLock *rwLock);
+void UnlockHcRwLock(HcRwLock *rwLock);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
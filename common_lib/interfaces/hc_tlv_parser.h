@@ -227,6 +227,10 @@ int32_t ParseTlv##TlvVecName(TlvBase *tlv, HcParcel *parcel, HcBool strict) \
     if (!ParcelReadUint32(parcel, &count)) { \
         return TLV_FAIL; \
     } \
+    /* every element takes a 4-byte header at least, so the count is only trusted up to that bound */ \
+    if (count <= GetParcelDataSize(parcel) / sizeof(uint32_t)) { \
+        (void)realTlv->data.reserve(&realTlv->data, count); \
+    } \
     int32_t totalLen = sizeof(count); \
     uint32_t index = 0; \
     for (index = 0; index < count; ++index) { \
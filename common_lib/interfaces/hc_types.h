@@ -37,6 +37,7 @@ extern "C" {
 #ifdef DEV_AUTH_MEMORY_DEBUG
 
 #define HcMalloc(size, val) MockMalloc(size, val, __FILE__, __LINE__)
+#define HcMallocUninit(size) MockMalloc(size, 0, __FILE__, __LINE__)
 #define HcFree(addr) MockFree(addr)
 void *MockMalloc(uint32_t size, char val, const char *strFile, int nLine);
 void MockFree(void *addr);
@@ -44,6 +45,11 @@ void MockFree(void *addr);
 #else
 
 void* HcMalloc(uint32_t size, char val);
+/*
+ * Same as HcMalloc but leaves the memory uninitialized, which saves a full write pass on hot paths.
+ * Only use it for buffers whose content is always written before being read.
+ */
+void* HcMallocUninit(uint32_t size);
 void HcFree(void* addr);
 
 #endif
@@ -36,6 +36,7 @@ typedef struct V##ClassName{ \
     Element (*get)(const struct V##ClassName*, uint32_t index); \
     Element* (*getp)(const struct V##ClassName*, uint32_t index); \
     void (*clear)(struct V##ClassName*); \
+    HcBool (*reserve)(struct V##ClassName*, uint32_t count); \
     HcParcel parcel; \
 } ClassName;
 
@@ -134,6 +135,17 @@ void VClear##ClassName(ClassName* obj) \
         ClearParcel(&obj->parcel); \
     } \
 } \
+HcBool VReserve##ClassName(ClassName* obj, uint32_t count) \
+{ \
+    if (NULL == obj || count > UINT32_MAX / sizeof(Element)) { \
+        return HC_FALSE; \
+    } \
+    uint32_t size = obj->size(obj); \
+    if (count <= size) { \
+        return HC_TRUE; \
+    } \
+    return ParcelReserve(&obj->parcel, (count - size) * sizeof(Element)); \
+} \
 ClassName Create##ClassName(void) \
 { \
     ClassName obj; \
@@ -145,6 +157,7 @@ ClassName Create##ClassName(void) \
     obj.size = VSize##ClassName; \
     obj.get = VGet##ClassName; \
     obj.getp = VGetPointer##ClassName; \
+    obj.reserve = VReserve##ClassName; \
     obj.parcel = CreateParcel(0, sizeof(Element) * allocCount); \
     return obj; \
 } \
@@ -162,6 +175,7 @@ void Destroy##ClassName(ClassName* obj) \
 #define HC_VECTOR_POPFRONT(obj, element) (obj)->popFront((obj), (element))
 #define HC_VECTOR_POPELEMENT(obj, element, index) (obj)->eraseElement((obj), (element), (index))
 #define HC_VECTOR_SIZE(obj) (obj)->size(obj)
+#define HC_VECTOR_RESERVE(obj, count) (obj)->reserve((obj), (count))
 #define HC_VECTOR_GET(obj, index) (obj)->get((obj), (index))
 #define HC_VECTOR_GETP(_obj, _index) (_obj)->getp((_obj), (_index))
 #define FOR_EACH_HC_VECTOR(vec, i, iter) \
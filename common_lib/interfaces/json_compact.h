@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JSON_COMPACT_H
+#define JSON_COMPACT_H
+
+#include "hc_parcel.h"
+#include "json_utils.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Compact binary form of a json tree: every value is a one byte tag followed by its payload,
+ * lengths and integers are varints and upper case hex strings are carried as raw bytes.
+ * Decoding gives back a tree that packs to exactly the same string as the encoded one.
+ */
+
+/* Append the encoded json to the parcel, the caller owns the parcel and should call DeleteParcel. */
+int32_t PackJsonToCompactData(const CJson *jsonObj, HcParcel *parcel);
+/* Need to call FreeJson to free the returned pointer when it's no longer in use. */
+CJson *CreateJsonFromCompactData(const uint8_t *data, uint32_t dataLen);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -88,6 +88,34 @@ int32_t CheckKeyParams(const KeyParams *keyParams);
 void FreeParamSet(struct HksParamSet *paramSet);
 int32_t ConstructParamSet(struct HksParamSet **out, const struct HksParam *inParam,
     const uint32_t inParamNum);
+int32_t InitParamSetCache(void);
+/*
+ * Same as ConstructParamSet, but param sets made only of inline value tags are built once and shared.
+ * The returned set must not be modified, FreeParamSet keeps the shared ones alive.
+ */
+int32_t ConstructCachedParamSet(struct HksParamSet **out, const struct HksParam *inParam,
+    const uint32_t inParamNum);
+int32_t InitKeyExistCache(void);
+/*
+ * Remembers the aliases known to exist per os account and storage level, so repeated checks skip huks.
+ * Only positive results are kept, a miss always falls through to huks.
+ */
+bool IsKeyExistCached(const Uint8Buff *keyAlias, bool isDeStorage, int32_t osAccountId);
+/*
+ * Take the generation before asking huks and pass it to AddKeyExistCache, the entry is not added if a
+ * removal happened in between.
+ */
+uint64_t GetKeyExistCacheGeneration(void);
+void AddKeyExistCache(const Uint8Buff *keyAlias, bool isDeStorage, int32_t osAccountId, uint64_t generation);
+/* Drops the alias for both storage levels. */
+void RemoveKeyExistCache(const Uint8Buff *keyAlias, int32_t osAccountId);
+void ClearKeyExistCache(int32_t osAccountId);
+void GetKeyExistCacheStats(KeyExistCacheStats *stats);
+/*
+ * Get the binary prime of primeHex, primeLen is the byte length of the prime. The known primes point to
+ * precomputed tables, any other one is converted into primeBuf which must hold primeLen bytes.
+ */
+int32_t GetDlPrimeByte(const char *primeHex, uint32_t primeLen, uint8_t *primeBuf, const uint8_t **primeByte);
 int32_t BigNumExpMod(const Uint8Buff *base, const Uint8Buff *exp, const char *bigNumHex,
     Uint8Buff *outNum);
 void MoveDeKeyToCe(bool isKeyAlias, int32_t osAccountId, const struct HksBlob *keyAliasBlob);
@@ -27,13 +27,32 @@
 extern "C" {
 #endif
 
+/* Seed the drbg shared by the functions below, they seed a one-shot drbg per call until it succeeds. */
+int32_t InitMbedtlsRng(void);
+/* Precompute the big number constants of the Curve25519 hash2point, and of the DL primes if enabled. */
+int32_t InitMbedtlsBigNumCtx(void);
 int32_t MbedtlsHashToPoint(const Uint8Buff *hash, Uint8Buff *outEcPoint);
 int32_t MbedtlsHashToPoint25519(const Uint8Buff *hash, Uint8Buff *outEcPoint);
 int32_t MbedtlsAgreeSharedSecret(const KeyBuff *priKey, const KeyBuff *pubKey, Uint8Buff *sharedKey);
+#ifdef DEV_AUTH_ENABLE_LOCAL_CRYPTO
+/* In-process variants of the loader operations that involve no key stored in huks, all keys are raw. */
+int32_t MbedtlsSha256(const Uint8Buff *message, Uint8Buff *hash);
+int32_t MbedtlsGenerateRandom(Uint8Buff *rand);
+int32_t MbedtlsComputeHmac(const KeyBuff *key, const Uint8Buff *message, Uint8Buff *outHmac);
+int32_t MbedtlsComputeHkdf(const KeyBuff *key, const Uint8Buff *salt, const Uint8Buff *keyInfo, Uint8Buff *outHkdf);
+int32_t MbedtlsAgreeSharedSecret25519(const KeyBuff *priKey, const KeyBuff *pubKey, Uint8Buff *sharedKey);
+#endif
 int32_t MbedtlsBase64Encode(const uint8_t *byte, uint32_t byteLen, char *base64Str, uint32_t strLen, uint32_t *outLen);
 int32_t MbedtlsBase64Decode(const char *base64Str, uint32_t strLen, uint8_t *byte, uint32_t byteLen, uint32_t *outLen);
 bool MbedtlsIsP256PublicKeyValid(const Uint8Buff *pubKey);
 bool MbedtlsIsX25519PublicKeyValid(const Uint8Buff *pubKey);
+#ifdef DEV_AUTH_ENABLE_MBEDTLS_EXP_MOD
+/*
+ * Returns HAL_ERR_NOT_SUPPORTED if bigNumHex is not a DL prime with precomputed constants.
+ * mbedtls_mpi_exp_mod is not guaranteed constant-time in the exponent, hence the opt-in flag.
+ */
+int32_t MbedtlsBigNumExpMod(const Uint8Buff *base, const Uint8Buff *exp, const char *bigNumHex, Uint8Buff *outNum);
+#endif
 
 #ifdef __cplusplus
 }
@@ -20,11 +20,16 @@
 #include <mbedtls/ctr_drbg.h>
 #include <mbedtls/entropy.h>
 #include <mbedtls/error.h>
+#ifdef DEV_AUTH_ENABLE_LOCAL_CRYPTO
+#include <mbedtls/hkdf.h>
+#include <mbedtls/md.h>
+#endif
 #include <mbedtls/pk.h>
 #include <mbedtls/x509.h>
 
 #include "hal_error.h"
 #include "hc_log.h"
+#include "hc_mutex.h"
 #include "huks_adapter.h"
 #include "huks_adapter_utils.h"
 
@@ -51,6 +56,12 @@ do { \
 #define P256_KEY_SIZE 32
 #define P256_PUBLIC_SIZE 64 // P256_KEY_SIZE * 2
 #define X25519_PUBLIC_SIZE 32
+#ifdef DEV_AUTH_ENABLE_LOCAL_CRYPTO
+#define X25519_PRIVATE_SIZE 32
+#define X25519_SHARED_SIZE 32
+#endif
+#define PARAM_P_INDEX 0
+#define PARAM_SQUARE_INDEX 1
 #define PARAM_A_INDEX 2
 #define PARAM_U_INDEX 4
 #define PARAM_MINUS_A_INDEX 3
@@ -111,6 +122,41 @@ static const uint8_t RANDOM_SEED_CUSTOM[] = {
     0x47, 0x5F, 0x50, 0x53, 0x5F, 0x76, 0x31, 0x30
 };
 
+/* Long-lived drbg shared by all operations, it reseeds itself from the entropy source at the reseed interval. */
+static HcMutex g_rngMutex;
+static mbedtls_entropy_context g_rngEntropy;
+static mbedtls_ctr_drbg_context g_rngCtrDrbg;
+static bool g_isRngInit = false;
+
+typedef struct {
+    int (*rngFunc)(void *, unsigned char *, size_t);
+    void *rngParam;
+    mbedtls_entropy_context *entropy;
+    mbedtls_ctr_drbg_context *ctrDrbg;
+} RngContext;
+
+#ifdef DEV_AUTH_ENABLE_MBEDTLS_EXP_MOD
+typedef struct {
+    const char *primeHex;
+    uint32_t primeLen;
+} DlPrimeParam;
+
+static const DlPrimeParam DL_PRIME_PARAMS[] = {
+    { DL_PRIME_HEX_384, BIG_PRIME_LEN_384 },
+    { DL_PRIME_HEX_256, BIG_PRIME_LEN_256 },
+};
+
+/* Modulus and Montgomery constant R^2 mod P of each DL prime, computed once at init and only read afterwards. */
+static mbedtls_mpi g_dlModP[CAL_ARRAY_SIZE(DL_PRIME_PARAMS)];
+static mbedtls_mpi g_dlModRR[CAL_ARRAY_SIZE(DL_PRIME_PARAMS)];
+static bool g_isDlPrimeCtxInit = false;
+#endif
+
+/* g_hash2pointParas read into big numbers with R^2 mod p of Curve25519, also computed once at init. */
+static mbedtls_mpi g_hash2pointBns[HASH_TO_POINT_PARA_NUMS];
+static mbedtls_mpi g_hash2pointModRR;
+static bool g_isHash2pointCtxInit = false;
+
 static bool IsValidBlob(const Blob *blob)
 {
     return (blob != NULL) && (blob->data != NULL) && (blob->dataSize != 0);
@@ -153,44 +199,25 @@ static void SwapEndian(uint8_t *pubKey, int len)
     }
 }
 
-static void FreeCleanFiveBns(mbedtls_mpi *bn1, mbedtls_mpi *bn2, mbedtls_mpi *bn3,
-                             mbedtls_mpi *bn4, mbedtls_mpi *bn5)
-{
-    mbedtls_mpi_free(bn1);
-    mbedtls_mpi_free(bn2);
-    mbedtls_mpi_free(bn3);
-    mbedtls_mpi_free(bn4);
-    mbedtls_mpi_free(bn5);
-}
-
-static int32_t CalTmpParaX(mbedtls_mpi *tmpY, const mbedtls_mpi *tmpX, const mbedtls_mpi *modP)
+static int32_t CalTmpParaX(mbedtls_mpi *tmpY, const mbedtls_mpi *tmpX, const mbedtls_mpi *paras, mbedtls_mpi *modRR)
 {
     int32_t status;
     mbedtls_mpi tmpBnA;
     mbedtls_mpi tmpBnB;
     mbedtls_mpi tmpBnC;
     mbedtls_mpi tmpBnE;
-    mbedtls_mpi paraBnA;
-    mbedtls_mpi paraBnU;
+    const mbedtls_mpi *modP = &paras[PARAM_P_INDEX];
 
     mbedtls_mpi_init(&tmpBnA);
     mbedtls_mpi_init(&tmpBnB);
     mbedtls_mpi_init(&tmpBnC);
     mbedtls_mpi_init(&tmpBnE);
-    mbedtls_mpi_init(&paraBnA);
-    mbedtls_mpi_init(&paraBnU);
-
-    status = mbedtls_mpi_read_binary(&paraBnA, g_hash2pointParas[PARAM_A_INDEX], BYTE_LENGTH_CURVE_25519);
-    LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParaX error1");
-
-    status = mbedtls_mpi_read_binary(&paraBnU, g_hash2pointParas[PARAM_U_INDEX], BYTE_LENGTH_CURVE_25519);
-    LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParaX error2");
 
     status = mbedtls_mpi_copy(&tmpBnB, tmpX);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParaX error3");
     /* a := b ^ 3 + A * b ^ 2 + b */
 
-    status = mbedtls_mpi_exp_mod(&tmpBnE, &tmpBnB, &paraBnU, modP, NULL);
+    status = mbedtls_mpi_exp_mod(&tmpBnE, &tmpBnB, &paras[PARAM_U_INDEX], modP, modRR);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParaX error4"); // b^2
 
     status = mbedtls_mpi_mul_mpi(&tmpBnC, &tmpBnE, &tmpBnB);
@@ -198,7 +225,7 @@ static int32_t CalTmpParaX(mbedtls_mpi *tmpY, const mbedtls_mpi *tmpX, const mbe
     status = mbedtls_mpi_mod_mpi(&tmpBnC, &tmpBnC, modP);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParaX error6"); // b^3
 
-    status = mbedtls_mpi_mul_mpi(&tmpBnA, &tmpBnE, &paraBnA); // A*b^2
+    status = mbedtls_mpi_mul_mpi(&tmpBnA, &tmpBnE, &paras[PARAM_A_INDEX]); // A*b^2
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParaX error7");
     status = mbedtls_mpi_mod_mpi(&tmpBnA, &tmpBnA, modP);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParaX error8");
@@ -214,45 +241,37 @@ static int32_t CalTmpParaX(mbedtls_mpi *tmpY, const mbedtls_mpi *tmpX, const mbe
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParaX error12");
 
 CLEAN_UP:
-    FreeCleanFiveBns(&paraBnA, &tmpBnA, &tmpBnB, &tmpBnC, &tmpBnE);
-    mbedtls_mpi_free(&paraBnU);
+    mbedtls_mpi_free(&tmpBnA);
+    mbedtls_mpi_free(&tmpBnB);
+    mbedtls_mpi_free(&tmpBnC);
+    mbedtls_mpi_free(&tmpBnE);
     return status;
 }
 
-static int32_t CalTmpParab(mbedtls_mpi *tmpX, const mbedtls_mpi *modP, const uint8_t *hash, uint32_t hashLen)
+static int32_t CalTmpParab(mbedtls_mpi *tmpX, const mbedtls_mpi *paras, mbedtls_mpi *modRR, const uint8_t *hash,
+    uint32_t hashLen)
 {
     int32_t status;
-    mbedtls_mpi paraBnNegA;
-    mbedtls_mpi paraBNOne;
-    mbedtls_mpi paraBnU;
     mbedtls_mpi tmpBnA;
     mbedtls_mpi tmpBnB;
+    const mbedtls_mpi *modP = &paras[PARAM_P_INDEX];
 
-    mbedtls_mpi_init(&paraBnNegA);
-    mbedtls_mpi_init(&paraBNOne);
-    mbedtls_mpi_init(&paraBnU);
     mbedtls_mpi_init(&tmpBnA);
     mbedtls_mpi_init(&tmpBnB);
 
-    status = mbedtls_mpi_read_binary(&paraBnNegA, g_hash2pointParas[PARAM_MINUS_A_INDEX], BYTE_LENGTH_CURVE_25519);
-    LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParab error1");
-    status = mbedtls_mpi_read_binary(&paraBNOne, g_hash2pointParas[PARAM_ONE_INDEX], BYTE_LENGTH_CURVE_25519);
-    LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParab error2");
-    status = mbedtls_mpi_read_binary(&paraBnU, g_hash2pointParas[PARAM_U_INDEX], BYTE_LENGTH_CURVE_25519);
-    LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParab error3");
     status = mbedtls_mpi_read_binary(&tmpBnA, hash, hashLen);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParab error4");
 
     /* b := -A / (1 + u * a ^ 2) */
-    status = mbedtls_mpi_exp_mod(&tmpBnB, &tmpBnA, &paraBnU, modP, NULL);
+    status = mbedtls_mpi_exp_mod(&tmpBnB, &tmpBnA, &paras[PARAM_U_INDEX], modP, modRR);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParab error5");
 
-    status = mbedtls_mpi_mul_mpi(&tmpBnA, &tmpBnB, &paraBnU);
+    status = mbedtls_mpi_mul_mpi(&tmpBnA, &tmpBnB, &paras[PARAM_U_INDEX]);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParab error6");
     status = mbedtls_mpi_mod_mpi(&tmpBnA, &tmpBnA, modP);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParab error7");
 
-    status = mbedtls_mpi_add_mpi(&tmpBnB, &tmpBnA, &paraBNOne);
+    status = mbedtls_mpi_add_mpi(&tmpBnB, &tmpBnA, &paras[PARAM_ONE_INDEX]);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParab error8");
     status = mbedtls_mpi_mod_mpi(&tmpBnB, &tmpBnB, modP);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParab error9");
@@ -260,15 +279,39 @@ static int32_t CalTmpParab(mbedtls_mpi *tmpX, const mbedtls_mpi *modP, const uin
     status = mbedtls_mpi_inv_mod(&tmpBnA, &tmpBnB, modP);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParab error10");
 
-    status = mbedtls_mpi_mul_mpi(tmpX, &tmpBnA, &paraBnNegA);
+    status = mbedtls_mpi_mul_mpi(tmpX, &tmpBnA, &paras[PARAM_MINUS_A_INDEX]);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParab error11");
     status = mbedtls_mpi_mod_mpi(tmpX, tmpX, modP);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "CalTmpParab error12");
 CLEAN_UP:
-    FreeCleanFiveBns(&paraBnNegA, &paraBNOne, &paraBnU, &tmpBnA, &tmpBnB);
+    mbedtls_mpi_free(&tmpBnA);
+    mbedtls_mpi_free(&tmpBnB);
     return status;
 }
 
+static void FreeHash2pointParas(mbedtls_mpi *paras)
+{
+    for (uint32_t i = 0; i < HASH_TO_POINT_PARA_NUMS; i++) {
+        mbedtls_mpi_free(&paras[i]);
+    }
+}
+
+static int32_t ReadHash2pointParas(mbedtls_mpi *paras)
+{
+    for (uint32_t i = 0; i < HASH_TO_POINT_PARA_NUMS; i++) {
+        mbedtls_mpi_init(&paras[i]);
+    }
+    for (uint32_t i = 0; i < HASH_TO_POINT_PARA_NUMS; i++) {
+        int32_t status = mbedtls_mpi_read_binary(&paras[i], g_hash2pointParas[i], BYTE_LENGTH_CURVE_25519);
+        if (status != 0) {
+            LOGE("Read hash2point para %" LOG_PUB "u failed.", i);
+            FreeHash2pointParas(paras);
+            return status;
+        }
+    }
+    return HAL_SUCCESS;
+}
+
 /*
  * hash2point function, use BoringSSL big number algorithm library;
  * p_point(little endian): the output pointer of Curve25519 point;
@@ -276,48 +319,46 @@ CLEAN_UP:
  */
 static int32_t Elligator(unsigned char *point, int pointLength, const unsigned char *hash, int hashLength)
 {
-    mbedtls_mpi paraBnP;
-    mbedtls_mpi paraBnSquare;
-    mbedtls_mpi paraBnNegA;
+    mbedtls_mpi localParas[HASH_TO_POINT_PARA_NUMS];
+    const mbedtls_mpi *paras = g_hash2pointBns;
+    mbedtls_mpi *modRR = &g_hash2pointModRR;
+    if (!g_isHash2pointCtxInit) {
+        int32_t ret = ReadHash2pointParas(localParas);
+        LOG_AND_RETURN_IF_MBED_FAIL(ret, "Elligator error1");
+        paras = localParas;
+        modRR = NULL;
+    }
+    const mbedtls_mpi *paraBnP = &paras[PARAM_P_INDEX];
+    const mbedtls_mpi *paraBnSquare = &paras[PARAM_SQUARE_INDEX];
     mbedtls_mpi tmpBnA;
     mbedtls_mpi tmpBnB;
     mbedtls_mpi tmpBnC;
     mbedtls_mpi tmpBnE;
 
-    mbedtls_mpi_init(&paraBnP);
-    mbedtls_mpi_init(&paraBnSquare);
-    mbedtls_mpi_init(&paraBnNegA);
     mbedtls_mpi_init(&tmpBnA);
     mbedtls_mpi_init(&tmpBnB);
     mbedtls_mpi_init(&tmpBnC);
     mbedtls_mpi_init(&tmpBnE);
 
-    int32_t status = mbedtls_mpi_read_binary(&paraBnP, g_hash2pointParas[0], BYTE_LENGTH_CURVE_25519);
-    LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "Elligator error1");
-    status = mbedtls_mpi_read_binary(&paraBnSquare, g_hash2pointParas[1], BYTE_LENGTH_CURVE_25519);
-    LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "Elligator error2");
-    status = mbedtls_mpi_read_binary(&paraBnNegA, g_hash2pointParas[PARAM_MINUS_A_INDEX], BYTE_LENGTH_CURVE_25519);
-    LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "Elligator error3");
-
-    status = CalTmpParab(&tmpBnB, &paraBnP, hash, hashLength);
+    int32_t status = CalTmpParab(&tmpBnB, paras, modRR, hash, hashLength);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "Elligator error4");
-    status = CalTmpParaX(&tmpBnA, &tmpBnB, &paraBnP);
+    status = CalTmpParaX(&tmpBnA, &tmpBnB, paras, modRR);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "Elligator error5");
 
-    status = mbedtls_mpi_sub_mpi(&tmpBnC, &paraBnP, &tmpBnB);
+    status = mbedtls_mpi_sub_mpi(&tmpBnC, paraBnP, &tmpBnB);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "Elligator error6");
-    status = mbedtls_mpi_mod_mpi(&tmpBnC, &tmpBnC, &paraBnP);
+    status = mbedtls_mpi_mod_mpi(&tmpBnC, &tmpBnC, paraBnP);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "Elligator error7");
 
-    status = mbedtls_mpi_add_mpi(&tmpBnC, &tmpBnC, &paraBnNegA);
+    status = mbedtls_mpi_add_mpi(&tmpBnC, &tmpBnC, &paras[PARAM_MINUS_A_INDEX]);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "Elligator error8");
-    status = mbedtls_mpi_mod_mpi(&tmpBnC, &tmpBnC, &paraBnP);
+    status = mbedtls_mpi_mod_mpi(&tmpBnC, &tmpBnC, paraBnP);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "Elligator error9");
 
-    status = mbedtls_mpi_exp_mod(&tmpBnE, &tmpBnA, &paraBnSquare, &paraBnP, NULL);
+    status = mbedtls_mpi_exp_mod(&tmpBnE, &tmpBnA, paraBnSquare, paraBnP, modRR);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "Elligator error10");
 
-    status = mbedtls_mpi_safe_cond_swap(&tmpBnB, &tmpBnC, (mbedtls_mpi_cmp_mpi(&paraBnSquare, &tmpBnE) == 1));
+    status = mbedtls_mpi_safe_cond_swap(&tmpBnB, &tmpBnC, (mbedtls_mpi_cmp_mpi(paraBnSquare, &tmpBnE) == 1));
     LOG_AND_GOTO_CLEANUP_IF_FAIL(status, "Elligator error11");
 
     status = mbedtls_mpi_write_binary(&tmpBnC, point, pointLength);
@@ -325,9 +366,13 @@ static int32_t Elligator(unsigned char *point, int pointLength, const unsigned c
 
     SwapEndian(point, pointLength);
 CLEAN_UP:
-    mbedtls_mpi_free(&paraBnP);
-    mbedtls_mpi_free(&paraBnSquare);
-    FreeCleanFiveBns(&paraBnNegA, &tmpBnA, &tmpBnB, &tmpBnC, &tmpBnE);
+    mbedtls_mpi_free(&tmpBnA);
+    mbedtls_mpi_free(&tmpBnB);
+    mbedtls_mpi_free(&tmpBnC);
+    mbedtls_mpi_free(&tmpBnE);
+    if (paras == localParas) {
+        FreeHash2pointParas(localParas);
+    }
     return status;
 }
 
@@ -394,10 +439,103 @@ static int32_t WriteOutEcPublicKey(const mbedtls_ecp_point *point, Blob *publicK
     return WriteOutBigNums(&point->MBEDTLS_PRIVATE(X), &point->MBEDTLS_PRIVATE(Y), publicKey);
 }
 
-static int EcKeyAgreementLog(mbedtls_ecp_keypair *keyPair, mbedtls_ecp_point *p, mbedtls_ctr_drbg_context *ctrDrbg)
+static void DeinitRngContext(mbedtls_entropy_context *entropy, mbedtls_ctr_drbg_context *ctrDrbg)
+{
+    mbedtls_ctr_drbg_free(ctrDrbg);
+    mbedtls_entropy_free(entropy);
+    HcFree(ctrDrbg);
+    HcFree(entropy);
+}
+
+static int32_t InitRngContext(mbedtls_entropy_context **entropy, mbedtls_ctr_drbg_context **ctrDrbg)
+{
+    *entropy = HcMalloc(sizeof(mbedtls_entropy_context), 0);
+    *ctrDrbg = HcMalloc(sizeof(mbedtls_ctr_drbg_context), 0);
+    if ((*entropy == NULL) || (*ctrDrbg == NULL)) {
+        LOGE("Malloc for entropy or ctrDrbg failed.");
+        HcFree(*entropy);
+        HcFree(*ctrDrbg);
+        *entropy = NULL;
+        *ctrDrbg = NULL;
+        return HAL_ERR_BAD_ALLOC;
+    }
+    mbedtls_entropy_init(*entropy);
+    mbedtls_ctr_drbg_init(*ctrDrbg);
+    int32_t ret = mbedtls_ctr_drbg_seed(*ctrDrbg, mbedtls_entropy_func, *entropy,
+        RANDOM_SEED_CUSTOM, sizeof(RANDOM_SEED_CUSTOM));
+    if (ret != HAL_SUCCESS) {
+        LOGE("mbedtls_ctr_drbg_seed failed, ret: %d.", ret);
+        DeinitRngContext(*entropy, *ctrDrbg);
+        *entropy = NULL;
+        *ctrDrbg = NULL;
+    }
+    return ret;
+}
+
+static int SharedRngRandom(void *rngParam, unsigned char *output, size_t outputLen)
+{
+    (void)rngParam;
+    (void)LockHcMutex(&g_rngMutex);
+    int ret = mbedtls_ctr_drbg_random(&g_rngCtrDrbg, output, outputLen);
+    UnlockHcMutex(&g_rngMutex);
+    return ret;
+}
+
+static int32_t AcquireRng(RngContext *rng)
+{
+    rng->entropy = NULL;
+    rng->ctrDrbg = NULL;
+    if (g_isRngInit) {
+        rng->rngFunc = SharedRngRandom;
+        rng->rngParam = NULL;
+        return HAL_SUCCESS;
+    }
+    int32_t ret = InitRngContext(&rng->entropy, &rng->ctrDrbg);
+    if (ret != HAL_SUCCESS) {
+        return ret;
+    }
+    rng->rngFunc = mbedtls_ctr_drbg_random;
+    rng->rngParam = rng->ctrDrbg;
+    return HAL_SUCCESS;
+}
+
+static void ReleaseRng(RngContext *rng)
+{
+    if (rng->ctrDrbg != NULL) {
+        DeinitRngContext(rng->entropy, rng->ctrDrbg);
+        rng->entropy = NULL;
+        rng->ctrDrbg = NULL;
+    }
+}
+
+int32_t InitMbedtlsRng(void)
+{
+    if (g_isRngInit) {
+        return HAL_SUCCESS;
+    }
+    if (InitHcMutex(&g_rngMutex, false) != HAL_SUCCESS) {
+        LOGE("Init rng mutex failed.");
+        return HAL_FAILED;
+    }
+    mbedtls_entropy_init(&g_rngEntropy);
+    mbedtls_ctr_drbg_init(&g_rngCtrDrbg);
+    int32_t ret = mbedtls_ctr_drbg_seed(&g_rngCtrDrbg, mbedtls_entropy_func, &g_rngEntropy,
+        RANDOM_SEED_CUSTOM, sizeof(RANDOM_SEED_CUSTOM));
+    if (ret != HAL_SUCCESS) {
+        LOGE("Seed shared ctrDrbg failed, ret: %d.", ret);
+        mbedtls_ctr_drbg_free(&g_rngCtrDrbg);
+        mbedtls_entropy_free(&g_rngEntropy);
+        DestroyHcMutex(&g_rngMutex);
+        return HAL_ERR_MBEDTLS;
+    }
+    g_isRngInit = true;
+    return HAL_SUCCESS;
+}
+
+static int EcKeyAgreementLog(mbedtls_ecp_keypair *keyPair, mbedtls_ecp_point *p, const RngContext *rng)
 {
     return mbedtls_ecp_mul_restartable(&keyPair->MBEDTLS_PRIVATE(grp), p, &keyPair->MBEDTLS_PRIVATE(d),
-        &keyPair->MBEDTLS_PRIVATE(Q), mbedtls_ctr_drbg_random, ctrDrbg, NULL);
+        &keyPair->MBEDTLS_PRIVATE(Q), rng->rngFunc, rng->rngParam, NULL);
 }
 
 static int32_t EcKeyAgreement(const Blob *privateKey, const Blob *publicKey, Blob *secretKey)
@@ -409,20 +547,21 @@ static int32_t EcKeyAgreement(const Blob *privateKey, const Blob *publicKey, Blo
     }
     mbedtls_mpi *secret = HcMalloc(sizeof(mbedtls_mpi), 0);
     mbedtls_ecp_keypair *keyPair = HcMalloc(sizeof(mbedtls_ecp_keypair), 0);
-    mbedtls_entropy_context *entropy = HcMalloc(sizeof(mbedtls_entropy_context), 0);
-    mbedtls_ctr_drbg_context *ctrDrbg = HcMalloc(sizeof(mbedtls_ctr_drbg_context), 0);
-    if ((secret == NULL) || (keyPair == NULL) || (entropy == NULL) || (ctrDrbg == NULL)) {
+    if ((secret == NULL) || (keyPair == NULL)) {
         LOGE("Malloc for mbedtls ec key param failed.");
         HcFree(secret);
         HcFree(keyPair);
-        HcFree(entropy);
-        HcFree(ctrDrbg);
         return HAL_ERR_BAD_ALLOC;
     }
+    RngContext rng;
+    if (AcquireRng(&rng) != HAL_SUCCESS) {
+        LOGE("Acquire rng failed.");
+        HcFree(secret);
+        HcFree(keyPair);
+        return HAL_ERR_MBEDTLS;
+    }
     mbedtls_mpi_init(secret);
     mbedtls_ecp_keypair_init(keyPair);
-    mbedtls_entropy_init(entropy);
-    mbedtls_ctr_drbg_init(ctrDrbg);
     mbedtls_ecp_point p;
     mbedtls_ecp_point_init(&p);
     int32_t ret = ReadEcPublicKey(&keyPair->MBEDTLS_PRIVATE(Q), publicKey);
@@ -431,22 +570,17 @@ static int32_t EcKeyAgreement(const Blob *privateKey, const Blob *publicKey, Blo
     LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Load the ecp group failed.");
     ret = mbedtls_mpi_read_binary(&keyPair->MBEDTLS_PRIVATE(d), privateKey->data, privateKey->dataSize);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Read the private key failed.");
-    ret = mbedtls_ctr_drbg_seed(ctrDrbg, mbedtls_entropy_func, entropy,
-        RANDOM_SEED_CUSTOM, sizeof(RANDOM_SEED_CUSTOM));
-    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Set custom string failed.");
-    LOG_AND_GOTO_CLEANUP_IF_FAIL(EcKeyAgreementLog(keyPair, &p, ctrDrbg), "Compute secret key failed.");
+    ret = EcKeyAgreementLog(keyPair, &p, &rng);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Compute secret key failed.");
     LOG_AND_GOTO_CLEANUP_IF_FAIL(mbedtls_mpi_copy(secret, &p.MBEDTLS_PRIVATE(X)), "Copy secret failed.");
     LOG_AND_GOTO_CLEANUP_IF_FAIL(WriteOutEcPublicKey(&p, secretKey), "Write out ec public key failed.");
 CLEAN_UP:
     mbedtls_mpi_free(secret);
     mbedtls_ecp_keypair_free(keyPair);
-    mbedtls_entropy_free(entropy);
-    mbedtls_ctr_drbg_free(ctrDrbg);
     mbedtls_ecp_point_free(&p);
+    ReleaseRng(&rng);
     HcFree(secret);
     HcFree(keyPair);
-    HcFree(entropy);
-    HcFree(ctrDrbg);
     LOG_AND_RETURN_IF_MBED_FAIL(ret, "Ec key agree failed.");
     return HAL_SUCCESS;
 }
@@ -572,6 +706,223 @@ int32_t MbedtlsAgreeSharedSecret(const KeyBuff *priKey, const KeyBuff *pubKey, U
     return HAL_SUCCESS;
 }
 
+#ifdef DEV_AUTH_ENABLE_LOCAL_CRYPTO
+int32_t MbedtlsSha256(const Uint8Buff *message, Uint8Buff *hash)
+{
+    if (!IsValidUint8Buff(message) || !IsValidUint8Buff(hash)) {
+        LOGE("Invalid params for sha256.");
+        return HAL_ERR_INVALID_PARAM;
+    }
+    Blob input = { .dataSize = message->length, .data = message->val };
+    Blob output = { .dataSize = hash->length, .data = hash->val };
+    int32_t ret = Sha256(&input, &output);
+    if (ret != HAL_SUCCESS) {
+        LOGE("Mbedtls sha256 failed, ret: %" LOG_PUB "d", ret);
+        return ret;
+    }
+    hash->length = output.dataSize;
+    return HAL_SUCCESS;
+}
+
+int32_t MbedtlsGenerateRandom(Uint8Buff *rand)
+{
+    if (!IsValidUint8Buff(rand)) {
+        LOGE("Invalid params for generate random.");
+        return HAL_ERR_INVALID_PARAM;
+    }
+    RngContext rng;
+    int32_t ret = AcquireRng(&rng);
+    if (ret != HAL_SUCCESS) {
+        LOGE("Init RNG context failed.");
+        return HAL_ERR_MBEDTLS;
+    }
+    uint32_t offset = 0;
+    while (offset < rand->length) {
+        uint32_t len = rand->length - offset;
+        if (len > MBEDTLS_CTR_DRBG_MAX_REQUEST) {
+            len = MBEDTLS_CTR_DRBG_MAX_REQUEST;
+        }
+        ret = rng.rngFunc(rng.rngParam, rand->val + offset, len);
+        if (ret != 0) {
+            break;
+        }
+        offset += len;
+    }
+    ReleaseRng(&rng);
+    LOG_AND_RETURN_IF_MBED_FAIL(ret, "Generate random failed, ret: %" LOG_PUB "d", ret);
+    return HAL_SUCCESS;
+}
+
+int32_t MbedtlsComputeHmac(const KeyBuff *key, const Uint8Buff *message, Uint8Buff *outHmac)
+{
+    if (key == NULL || key->key == NULL || key->keyLen == 0 || !IsValidUint8Buff(message) ||
+        !IsValidUint8Buff(outHmac) || outHmac->length != HMAC_LEN) {
+        LOGE("Invalid params for hmac.");
+        return HAL_ERR_INVALID_PARAM;
+    }
+    const mbedtls_md_info_t *info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    if (info == NULL) {
+        return HAL_ERR_NOT_SUPPORTED;
+    }
+    int32_t ret = mbedtls_md_hmac(info, key->key, key->keyLen, message->val, message->length, outHmac->val);
+    LOG_AND_RETURN_IF_MBED_FAIL(ret, "Compute hmac failed, ret: %" LOG_PUB "d", ret);
+    return HAL_SUCCESS;
+}
+
+int32_t MbedtlsComputeHkdf(const KeyBuff *key, const Uint8Buff *salt, const Uint8Buff *keyInfo, Uint8Buff *outHkdf)
+{
+    if (key == NULL || key->key == NULL || key->keyLen == 0 || !IsValidUint8Buff(salt) ||
+        !IsValidUint8Buff(outHkdf)) {
+        LOGE("Invalid params for hkdf.");
+        return HAL_ERR_INVALID_PARAM;
+    }
+    const mbedtls_md_info_t *info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    if (info == NULL) {
+        return HAL_ERR_NOT_SUPPORTED;
+    }
+    const uint8_t *infoData = (keyInfo != NULL) ? keyInfo->val : NULL;
+    uint32_t infoLen = (keyInfo != NULL && keyInfo->val != NULL) ? keyInfo->length : 0;
+    int32_t ret = mbedtls_hkdf(info, salt->val, salt->length, key->key, key->keyLen, infoData, infoLen,
+        outHkdf->val, outHkdf->length);
+    LOG_AND_RETURN_IF_MBED_FAIL(ret, "Compute hkdf failed, ret: %" LOG_PUB "d", ret);
+    return HAL_SUCCESS;
+}
+#endif
+
+#ifdef DEV_AUTH_ENABLE_MBEDTLS_EXP_MOD
+static void FreeDlPrimeCtx(void)
+{
+    for (uint32_t i = 0; i < CAL_ARRAY_SIZE(DL_PRIME_PARAMS); i++) {
+        mbedtls_mpi_free(&g_dlModP[i]);
+        mbedtls_mpi_free(&g_dlModRR[i]);
+    }
+}
+
+static int32_t InitDlPrimeCtx(void)
+{
+    if (g_isDlPrimeCtxInit) {
+        return HAL_SUCCESS;
+    }
+    for (uint32_t i = 0; i < CAL_ARRAY_SIZE(DL_PRIME_PARAMS); i++) {
+        mbedtls_mpi_init(&g_dlModP[i]);
+        mbedtls_mpi_init(&g_dlModRR[i]);
+    }
+    uint8_t primeBuf[BIG_PRIME_LEN_384] = { 0 };
+    mbedtls_mpi one;
+    mbedtls_mpi tmp;
+    mbedtls_mpi_init(&one);
+    mbedtls_mpi_init(&tmp);
+    int32_t ret = mbedtls_mpi_lset(&one, 1);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Set number one failed.");
+    for (uint32_t i = 0; i < CAL_ARRAY_SIZE(DL_PRIME_PARAMS); i++) {
+        const uint8_t *primeByte = NULL;
+        ret = GetDlPrimeByte(DL_PRIME_PARAMS[i].primeHex, DL_PRIME_PARAMS[i].primeLen, primeBuf, &primeByte);
+        LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Get dl prime byte failed.");
+        ret = mbedtls_mpi_read_binary(&g_dlModP[i], primeByte, DL_PRIME_PARAMS[i].primeLen);
+        LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Read dl prime failed.");
+        /* An empty prec_RR is filled by the first exponentiation and reused by the later ones. */
+        ret = mbedtls_mpi_exp_mod(&tmp, &one, &one, &g_dlModP[i], &g_dlModRR[i]);
+        LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Compute montgomery constant failed.");
+    }
+CLEAN_UP:
+    mbedtls_mpi_free(&one);
+    mbedtls_mpi_free(&tmp);
+    if (ret != HAL_SUCCESS) {
+        FreeDlPrimeCtx();
+        return HAL_ERR_MBEDTLS;
+    }
+    g_isDlPrimeCtxInit = true;
+    return HAL_SUCCESS;
+}
+#endif
+
+static int32_t InitHash2pointCtx(void)
+{
+    if (g_isHash2pointCtxInit) {
+        return HAL_SUCCESS;
+    }
+    int32_t ret = ReadHash2pointParas(g_hash2pointBns);
+    LOG_AND_RETURN_IF_MBED_FAIL(ret, "Read hash2point paras failed.");
+    mbedtls_mpi tmp;
+    mbedtls_mpi_init(&tmp);
+    mbedtls_mpi_init(&g_hash2pointModRR);
+    ret = mbedtls_mpi_exp_mod(&tmp, &g_hash2pointBns[PARAM_ONE_INDEX], &g_hash2pointBns[PARAM_ONE_INDEX],
+        &g_hash2pointBns[PARAM_P_INDEX], &g_hash2pointModRR);
+    mbedtls_mpi_free(&tmp);
+    if (ret != HAL_SUCCESS) {
+        LOGE("Compute hash2point montgomery constant failed.");
+        mbedtls_mpi_free(&g_hash2pointModRR);
+        FreeHash2pointParas(g_hash2pointBns);
+        return HAL_ERR_MBEDTLS;
+    }
+    g_isHash2pointCtxInit = true;
+    return HAL_SUCCESS;
+}
+
+int32_t InitMbedtlsBigNumCtx(void)
+{
+#ifdef DEV_AUTH_ENABLE_MBEDTLS_EXP_MOD
+    int32_t dlRes = InitDlPrimeCtx();
+    int32_t hash2pointRes = InitHash2pointCtx();
+    return (dlRes != HAL_SUCCESS) ? dlRes : hash2pointRes;
+#else
+    return InitHash2pointCtx();
+#endif
+}
+
+#ifdef DEV_AUTH_ENABLE_MBEDTLS_EXP_MOD
+static int32_t GetDlPrimeCtxIndex(const char *bigNumHex, uint32_t *index)
+{
+    if (!g_isDlPrimeCtxInit || (bigNumHex == NULL)) {
+        return HAL_ERR_NOT_SUPPORTED;
+    }
+    uint32_t hexLen = HcStrlen(bigNumHex);
+    for (uint32_t i = 0; i < CAL_ARRAY_SIZE(DL_PRIME_PARAMS); i++) {
+        if ((hexLen == DL_PRIME_PARAMS[i].primeLen * BYTE_TO_HEX_OPER_LENGTH) &&
+            (memcmp(DL_PRIME_PARAMS[i].primeHex, bigNumHex, hexLen) == 0)) {
+            *index = i;
+            return HAL_SUCCESS;
+        }
+    }
+    return HAL_ERR_NOT_SUPPORTED;
+}
+
+int32_t MbedtlsBigNumExpMod(const Uint8Buff *base, const Uint8Buff *exp, const char *bigNumHex, Uint8Buff *outNum)
+{
+    uint32_t index = 0;
+    if (GetDlPrimeCtxIndex(bigNumHex, &index) != HAL_SUCCESS) {
+        return HAL_ERR_NOT_SUPPORTED;
+    }
+    if (!IsValidUint8Buff(base) || !IsValidUint8Buff(exp) || !IsValidUint8Buff(outNum)) {
+        LOGE("Input params for big number exp mod is invalid.");
+        return HAL_ERR_INVALID_PARAM;
+    }
+    uint32_t primeLen = DL_PRIME_PARAMS[index].primeLen;
+    CHECK_LEN_EQUAL_RETURN(outNum->length, primeLen, "outNum->length");
+
+    mbedtls_mpi baseNum;
+    mbedtls_mpi expNum;
+    mbedtls_mpi result;
+    mbedtls_mpi_init(&baseNum);
+    mbedtls_mpi_init(&expNum);
+    mbedtls_mpi_init(&result);
+    int32_t ret = mbedtls_mpi_read_binary(&baseNum, base->val, base->length);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Read base failed.");
+    ret = mbedtls_mpi_read_binary(&expNum, exp->val, exp->length);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Read exp failed.");
+    ret = mbedtls_mpi_exp_mod(&result, &baseNum, &expNum, &g_dlModP[index], &g_dlModRR[index]);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Compute exp mod failed.");
+    ret = mbedtls_mpi_write_binary(&result, outNum->val, primeLen);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Write out result failed.");
+CLEAN_UP:
+    mbedtls_mpi_free(&baseNum);
+    mbedtls_mpi_free(&expNum);
+    mbedtls_mpi_free(&result);
+    LOG_AND_RETURN_IF_MBED_FAIL(ret, "Big number exp mod failed.");
+    return HAL_SUCCESS;
+}
+#endif
+
 int32_t MbedtlsBase64Encode(const uint8_t *byte, uint32_t byteLen, char *base64Str, uint32_t strLen, uint32_t *outLen)
 {
     CHECK_PTR_RETURN_HAL_ERROR_CODE(byte, "byte");
@@ -635,16 +986,15 @@ bool MbedtlsIsP256PublicKeyValid(const Uint8Buff *pubKey)
         LOGE("Invaild P256 pubKey input.");
         return false;
     }
-    mbedtls_ctr_drbg_context *ctrDrbg = HcMalloc(sizeof(mbedtls_ctr_drbg_context), 0);
-    if (ctrDrbg == NULL) {
-        LOGE("Malloc for mbedtls_ctr_drbg_context failed.");
+    RngContext rng;
+    if (AcquireRng(&rng) != HAL_SUCCESS) {
+        LOGE("Acquire rng failed.");
         return false;
     }
     mbedtls_ecp_group grp;
     mbedtls_ecp_point publicKeyPoint;
     mbedtls_ecp_point returnPoint;
     mbedtls_ecp_group_init(&grp);
-    mbedtls_ctr_drbg_init(ctrDrbg);
     mbedtls_ecp_point_init(&publicKeyPoint);
     mbedtls_ecp_point_init(&returnPoint);
     mbedtls_mpi scalar;
@@ -662,17 +1012,16 @@ bool MbedtlsIsP256PublicKeyValid(const Uint8Buff *pubKey)
     LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Invaild point on P256.");
     ret = mbedtls_mpi_lset(&scalar, P256_CHECK_SCALAR_VALUE);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Set number eight failed.");
-    ret = mbedtls_ecp_mul(&grp, &returnPoint, &scalar, &publicKeyPoint, mbedtls_ctr_drbg_random, ctrDrbg);
+    ret = mbedtls_ecp_mul(&grp, &returnPoint, &scalar, &publicKeyPoint, rng.rngFunc, rng.rngParam);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Compute 8PK failed.");
     ret = mbedtls_ecp_is_zero(&returnPoint);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "8PK is the point at infinity.");
 CLEAN_UP:
     mbedtls_ecp_group_free(&grp);
-    mbedtls_ctr_drbg_free(ctrDrbg);
     mbedtls_ecp_point_free(&publicKeyPoint);
     mbedtls_ecp_point_free(&returnPoint);
     mbedtls_mpi_free(&scalar);
-    HcFree(ctrDrbg);
+    ReleaseRng(&rng);
     if (ret != HAL_SUCCESS) {
         LOGE("P256 pubKey is invaild!");
         return false;
@@ -681,39 +1030,6 @@ CLEAN_UP:
     return true;
 }
 
-static void DeinitRngContext(mbedtls_entropy_context *entropy, mbedtls_ctr_drbg_context *ctrDrbg)
-{
-    mbedtls_ctr_drbg_free(ctrDrbg);
-    mbedtls_entropy_free(entropy);
-    HcFree(ctrDrbg);
-    HcFree(entropy);
-}
-
-static int32_t InitRngContext(mbedtls_entropy_context **entropy, mbedtls_ctr_drbg_context **ctrDrbg)
-{
-    *entropy = HcMalloc(sizeof(mbedtls_entropy_context), 0);
-    *ctrDrbg = HcMalloc(sizeof(mbedtls_ctr_drbg_context), 0);
-    if ((*entropy == NULL) || (*ctrDrbg == NULL)) {
-        LOGE("Malloc for entropy or ctrDrbg failed.");
-        HcFree(*entropy);
-        HcFree(*ctrDrbg);
-        *entropy = NULL;
-        *ctrDrbg = NULL;
-        return HAL_ERR_BAD_ALLOC;
-    }
-    mbedtls_entropy_init(*entropy);
-    mbedtls_ctr_drbg_init(*ctrDrbg);
-    int32_t ret = mbedtls_ctr_drbg_seed(*ctrDrbg, mbedtls_entropy_func, *entropy,
-        RANDOM_SEED_CUSTOM, sizeof(RANDOM_SEED_CUSTOM));
-    if (ret != HAL_SUCCESS) {
-        LOGE("mbedtls_ctr_drbg_seed failed, ret: %d.", ret);
-        DeinitRngContext(*entropy, *ctrDrbg);
-        *entropy = NULL;
-        *ctrDrbg = NULL;
-    }
-    return ret;
-}
-
 static int32_t SetX25519CheckScalar(mbedtls_mpi *scalar)
 {
     const int32_t VAILD_SCALAR_VALUE_ZERO_POS0 = 0;
@@ -751,9 +1067,8 @@ bool MbedtlsIsX25519PublicKeyValid(const Uint8Buff *pubKey)
         LOGE("Invaild X25519 pubKey input.");
         return false;
     }
-    mbedtls_entropy_context *entropy = NULL;
-    mbedtls_ctr_drbg_context *ctrDrbg = NULL;
-    int32_t ret = InitRngContext(&entropy, &ctrDrbg);
+    RngContext rng;
+    int32_t ret = AcquireRng(&rng);
     if (ret != 0) {
         LOGE("Init RNG context failed.");
         return false;
@@ -774,7 +1089,7 @@ bool MbedtlsIsX25519PublicKeyValid(const Uint8Buff *pubKey)
     LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Invaild point on X25519.");
     ret = SetX25519CheckScalar(&scalar);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Set scalar (2^254 + 8 * 1) failed.");
-    ret = mbedtls_ecp_mul(&grp, &returnPoint, &scalar, &publicKeyPoint, mbedtls_ctr_drbg_random, ctrDrbg);
+    ret = mbedtls_ecp_mul(&grp, &returnPoint, &scalar, &publicKeyPoint, rng.rngFunc, rng.rngParam);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Compute (2^254 + 8 * 1)PK failed.");
     ret = mbedtls_ecp_is_zero(&returnPoint);
     LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "(2^254 + 8 * 1)PK is the point at infinity.");
@@ -783,11 +1098,97 @@ CLEAN_UP:
     mbedtls_ecp_point_free(&publicKeyPoint);
     mbedtls_ecp_point_free(&returnPoint);
     mbedtls_mpi_free(&scalar);
-    DeinitRngContext(entropy, ctrDrbg);
+    ReleaseRng(&rng);
     if (ret != HAL_SUCCESS) {
         LOGE("X25519 pubKey is invaild!");
         return false;
     }
     LOGI("Check X25519 pubKey success.");
     return true;
-}
\ No newline at end of file
+}
+
+#ifdef DEV_AUTH_ENABLE_LOCAL_CRYPTO
+static int32_t ClampX25519Scalar(mbedtls_mpi *scalar)
+{
+    const int32_t CLEAR_SCALAR_POS0 = 0;
+    const int32_t CLEAR_SCALAR_POS1 = 1;
+    const int32_t CLEAR_SCALAR_POS2 = 2;
+    const int32_t SET_SCALAR_POS254 = 254;
+    const int32_t CLEAR_SCALAR_POS255 = 255;
+    // RFC 7748 decodeScalar25519
+    int32_t ret = mbedtls_mpi_set_bit(scalar, CLEAR_SCALAR_POS0, 0);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Clear scalar pos 0 failed.");
+    ret = mbedtls_mpi_set_bit(scalar, CLEAR_SCALAR_POS1, 0);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Clear scalar pos 1 failed.");
+    ret = mbedtls_mpi_set_bit(scalar, CLEAR_SCALAR_POS2, 0);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Clear scalar pos 2 failed.");
+    ret = mbedtls_mpi_set_bit(scalar, CLEAR_SCALAR_POS255, 0);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Clear scalar pos 255 failed.");
+    ret = mbedtls_mpi_set_bit(scalar, SET_SCALAR_POS254, 1);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Set scalar pos 254 failed.");
+CLEAN_UP:
+    return ret;
+}
+
+static bool IsAllZero(const uint8_t *data, uint32_t len)
+{
+    uint8_t acc = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        acc |= data[i];
+    }
+    return acc == 0;
+}
+
+int32_t MbedtlsAgreeSharedSecret25519(const KeyBuff *priKey, const KeyBuff *pubKey, Uint8Buff *sharedKey)
+{
+    if (priKey == NULL || priKey->key == NULL || priKey->keyLen != X25519_PRIVATE_SIZE || pubKey == NULL ||
+        pubKey->key == NULL || pubKey->keyLen != X25519_PUBLIC_SIZE || sharedKey == NULL ||
+        sharedKey->val == NULL || sharedKey->length != X25519_SHARED_SIZE) {
+        LOGE("Invalid params for X25519 agree.");
+        return HAL_ERR_INVALID_PARAM;
+    }
+    RngContext rng;
+    int32_t ret = AcquireRng(&rng);
+    if (ret != HAL_SUCCESS) {
+        LOGE("Init RNG context failed.");
+        return HAL_ERR_MBEDTLS;
+    }
+    mbedtls_ecp_group grp;
+    mbedtls_ecp_point publicKeyPoint;
+    mbedtls_ecp_point sharedPoint;
+    mbedtls_mpi scalar;
+    mbedtls_ecp_group_init(&grp);
+    mbedtls_ecp_point_init(&publicKeyPoint);
+    mbedtls_ecp_point_init(&sharedPoint);
+    mbedtls_mpi_init(&scalar);
+    size_t outLen = 0;
+    ret = mbedtls_ecp_group_load(&grp, MBEDTLS_ECP_DP_CURVE25519);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Load X25519 group failed.");
+    ret = mbedtls_ecp_point_read_binary(&grp, &publicKeyPoint, pubKey->key, pubKey->keyLen);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Read X25519 public key failed.");
+    ret = mbedtls_mpi_read_binary_le(&scalar, priKey->key, priKey->keyLen);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Read X25519 private key failed.");
+    ret = ClampX25519Scalar(&scalar);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Clamp X25519 private key failed.");
+    ret = mbedtls_ecp_mul(&grp, &sharedPoint, &scalar, &publicKeyPoint, rng.rngFunc, rng.rngParam);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Compute X25519 shared point failed.");
+    ret = mbedtls_ecp_point_write_binary(&grp, &sharedPoint, MBEDTLS_ECP_PF_UNCOMPRESSED, &outLen,
+        sharedKey->val, sharedKey->length);
+    LOG_AND_GOTO_CLEANUP_IF_FAIL(ret, "Write X25519 shared key failed.");
+    if (outLen != X25519_SHARED_SIZE || IsAllZero(sharedKey->val, X25519_SHARED_SIZE)) {
+        LOGE("X25519 shared key is invalid.");
+        ret = HAL_ERR_MBEDTLS;
+    }
+CLEAN_UP:
+    mbedtls_ecp_group_free(&grp);
+    mbedtls_ecp_point_free(&publicKeyPoint);
+    mbedtls_ecp_point_free(&sharedPoint);
+    mbedtls_mpi_free(&scalar);
+    ReleaseRng(&rng);
+    if (ret != HAL_SUCCESS) {
+        (void)memset_s(sharedKey->val, sharedKey->length, 0, sharedKey->length);
+        return HAL_ERR_MBEDTLS;
+    }
+    return HAL_SUCCESS;
+}
+#endif
\ No newline at end of file
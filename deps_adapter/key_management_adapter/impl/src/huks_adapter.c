@@ -40,6 +40,9 @@ static int32_t Sha256(const Uint8Buff *message, Uint8Buff *hash)
     CHECK_PTR_RETURN_HAL_ERROR_CODE(hash->val, "hash->val");
     CHECK_LEN_EQUAL_RETURN(hash->length, SHA256_LEN, "hash->length");
 
+#ifdef DEV_AUTH_ENABLE_LOCAL_CRYPTO
+    return MbedtlsSha256(message, hash);
+#else
     struct HksBlob srcBlob = { message->length, message->val };
     struct HksBlob hashBlob = { hash->length, hash->val };
     struct HksParamSet *paramSet = NULL;
@@ -49,7 +52,7 @@ static int32_t Sha256(const Uint8Buff *message, Uint8Buff *hash)
             .uint32Param = HKS_DIGEST_SHA256
         }
     };
-    int32_t res = ConstructParamSet(&paramSet, digestParam, CAL_ARRAY_SIZE(digestParam));
+    int32_t res = ConstructCachedParamSet(&paramSet, digestParam, CAL_ARRAY_SIZE(digestParam));
     if (res != HAL_SUCCESS) {
         LOGE("construct param set failed, res = %" LOG_PUB "d", res);
         return res;
@@ -64,6 +67,7 @@ static int32_t Sha256(const Uint8Buff *message, Uint8Buff *hash)
 
     FreeParamSet(paramSet);
     return HAL_SUCCESS;
+#endif
 }
 
 static int32_t GenerateRandom(Uint8Buff *rand)
@@ -72,6 +76,9 @@ static int32_t GenerateRandom(Uint8Buff *rand)
     CHECK_PTR_RETURN_HAL_ERROR_CODE(rand->val, "rand->val");
     CHECK_LEN_ZERO_RETURN_ERROR_CODE(rand->length, "rand->length");
 
+#ifdef DEV_AUTH_ENABLE_LOCAL_CRYPTO
+    return MbedtlsGenerateRandom(rand);
+#else
     struct HksBlob randBlob = { rand->length, rand->val };
     int32_t res = HksGenerateRandom(NULL, &randBlob);
     if (res != HKS_SUCCESS) {
@@ -80,6 +87,7 @@ static int32_t GenerateRandom(Uint8Buff *rand)
     }
 
     return HAL_SUCCESS;
+#endif
 }
 
 static int32_t CheckKeyExist(const Uint8Buff *keyAlias, bool isDeStorage, int32_t osAccountId)
@@ -87,6 +95,10 @@ static int32_t CheckKeyExist(const Uint8Buff *keyAlias, bool isDeStorage, int32_
     CHECK_PTR_RETURN_HAL_ERROR_CODE(keyAlias, "keyAlias");
     CHECK_PTR_RETURN_HAL_ERROR_CODE(keyAlias->val, "keyAlias->val");
     CHECK_LEN_ZERO_RETURN_ERROR_CODE(keyAlias->length, "keyAlias->length");
+    if (IsKeyExistCached(keyAlias, isDeStorage, osAccountId)) {
+        return HAL_SUCCESS;
+    }
+    uint64_t generation = GetKeyExistCacheGeneration();
 
     struct HksParamSet *deParamSet = NULL;
     int32_t res = ConstructCheckParamSet(true, osAccountId, &deParamSet);
@@ -124,7 +136,7 @@ static int32_t CheckKeyExist(const Uint8Buff *keyAlias, bool isDeStorage, int32_
         LOGE("[HUKS]: HksKeyExist fail. [Res]: %" LOG_PUB "d", res);
         return HAL_ERR_HUKS;
     }
-
+    AddKeyExistCache(keyAlias, isDeStorage, osAccountId, generation);
     return HAL_SUCCESS;
 }
 
@@ -160,6 +172,7 @@ static int32_t DeleteKey(const Uint8Buff *keyAlias, bool isDeStorage, int32_t os
         }
     }
     LOGI("[HUKS]: HksDeleteKey quit. [Res]: %" LOG_PUB "d", res);
+    RemoveKeyExistCache(keyAlias, osAccountId);
 
     FreeParamSet(deParamSet);
     FreeParamSet(ceParamSet);
@@ -180,6 +193,11 @@ static int32_t ComputeHmac(const KeyParams *keyParams, const Uint8Buff *message,
     if (res != HAL_SUCCESS) {
         return res;
     }
+#ifdef DEV_AUTH_ENABLE_LOCAL_CRYPTO
+    if (!keyParams->keyBuff.isAlias) {
+        return MbedtlsComputeHmac(&keyParams->keyBuff, message, outHmac);
+    }
+#endif
 
     struct HksParamSet *deParamSet = NULL;
     res = ConstructHmacParamSet(true, keyParams->osAccountId, keyParams->keyBuff.isAlias, &deParamSet);
@@ -315,6 +333,11 @@ static int32_t ComputeHkdf(const KeyParams *keyParams, const Uint8Buff *salt, co
     if (res != HAL_SUCCESS) {
         return res;
     }
+#ifdef DEV_AUTH_ENABLE_LOCAL_CRYPTO
+    if (!keyParams->keyBuff.isAlias) {
+        return MbedtlsComputeHkdf(&keyParams->keyBuff, salt, keyInfo, outHkdf);
+    }
+#endif
 
     struct HksBlob srcKeyBlob = { keyParams->keyBuff.keyLen, keyParams->keyBuff.key };
     struct HksBlob derivedKeyBlob = { outHkdf->length, outHkdf->val };
@@ -713,6 +736,11 @@ static int32_t AgreeSharedSecret(const KeyParams *priKeyParams, const KeyBuff *p
         KeyBuff priKey = { priKeyParams->keyBuff.key, priKeyParams->keyBuff.keyLen, priKeyParams->keyBuff.isAlias };
         return MbedtlsAgreeSharedSecret(&priKey, pubKey, sharedKey);
     }
+#ifdef DEV_AUTH_ENABLE_LOCAL_CRYPTO
+    if (g_algToHksAlgorithm[algo] == HKS_ALG_X25519 && !priKeyParams->keyBuff.isAlias) {
+        return MbedtlsAgreeSharedSecret25519(&priKeyParams->keyBuff, pubKey, sharedKey);
+    }
+#endif
 
     struct HksBlob priKeyBlob = { priKeyParams->keyBuff.keyLen, priKeyParams->keyBuff.key };
     struct HksBlob pubKeyBlob = { pubKey->keyLen, pubKey->key };
@@ -755,6 +783,7 @@ static int32_t GenerateKeyPairWithStorage(const KeyParams *keyParams, uint32_t k
     }
     struct HksBlob keyAliasBlob = { keyParams->keyBuff.keyLen, keyParams->keyBuff.key };
 
+    uint64_t generation = GetKeyExistCacheGeneration();
     LOGI("[HUKS]: HksGenerateKey enter.");
     res = HksGenerateKey(&keyAliasBlob, paramSet, NULL);
     FreeParamSet(paramSet);
@@ -763,6 +792,8 @@ static int32_t GenerateKeyPairWithStorage(const KeyParams *keyParams, uint32_t k
         LOGE("[HUKS]: HksGenerateKey fail. [Res]: %" LOG_PUB "d", res);
         return HAL_ERR_HUKS;
     }
+    Uint8Buff keyAlias = { keyParams->keyBuff.key, keyParams->keyBuff.keyLen };
+    AddKeyExistCache(&keyAlias, keyParams->isDeStorage, keyParams->osAccountId, generation);
     return HAL_SUCCESS;
 }
 
@@ -994,14 +1025,18 @@ static bool CheckDlPublicKey(const Uint8Buff *key, const char *primeHex)
         LOGE("Key length > prime number length.");
         return false;
     }
-    uint8_t *primeByte = (uint8_t *)HcMalloc(innerKeyLen, 0);
-    if (primeByte == NULL) {
-        LOGE("Malloc for primeByte failed.");
+    if ((innerKeyLen == 0) || (innerKeyLen > BIG_PRIME_LEN_384)) {
+        LOGE("Not support prime number len.");
         return false;
     }
-    if (HexStringToByte(primeHex, primeByte, innerKeyLen) != HAL_SUCCESS) {
+    uint8_t primeByte[BIG_PRIME_LEN_384] = { 0 };
+    const uint8_t *prime = NULL;
+    if (GetDlPrimeByte(primeHex, innerKeyLen, primeByte, &prime) != HAL_SUCCESS) {
         LOGE("Convert prime number from hex string to byte failed.");
-        HcFree(primeByte);
+        return false;
+    }
+    if ((prime != primeByte) && (memcpy_s(primeByte, sizeof(primeByte), prime, innerKeyLen) != EOK)) {
+        LOGE("Copy prime number failed.");
         return false;
     }
     /*
@@ -1013,18 +1048,14 @@ static bool CheckDlPublicKey(const Uint8Buff *key, const char *primeHex)
     Uint8Buff minBuff = { &min, sizeof(uint8_t) };
     if (BigNumCompare(key, &minBuff) >= 0) {
         LOGE("Pubkey is invalid, key <= 1.");
-        HcFree(primeByte);
         return false;
     }
 
     Uint8Buff primeBuff = { primeByte, innerKeyLen };
     if (BigNumCompare(key, &primeBuff) <= 0) {
         LOGE("Pubkey is invalid, key >= p - 1.");
-        HcFree(primeByte);
         return false;
     }
-
-    HcFree(primeByte);
     return true;
 }
 
@@ -1058,6 +1089,7 @@ static int32_t ImportSymmetricKey(const KeyParams *keyParams, const Uint8Buff *a
     struct HksBlob keyAliasBlob = { keyParams->keyBuff.keyLen, keyParams->keyBuff.key };
     struct HksBlob symKeyBlob = { authToken->length, authToken->val };
 
+    uint64_t generation = GetKeyExistCacheGeneration();
     LOGI("[HUKS]: HksImportKey enter.");
     res = HksImportKey(&keyAliasBlob, paramSet, &symKeyBlob);
     FreeParamSet(paramSet);
@@ -1066,11 +1098,45 @@ static int32_t ImportSymmetricKey(const KeyParams *keyParams, const Uint8Buff *a
         LOGE("[HUKS]: HksImportKey fail. [Res]: %" LOG_PUB "d", res);
         return HAL_ERR_HUKS;
     }
+    Uint8Buff keyAlias = { keyParams->keyBuff.key, keyParams->keyBuff.keyLen };
+    AddKeyExistCache(&keyAlias, keyParams->isDeStorage, keyParams->osAccountId, generation);
     return HAL_SUCCESS;
 }
 
+static int32_t InitAlg(void)
+{
+    int32_t res = InitHks();
+    if (res != HKS_SUCCESS) {
+        return res;
+    }
+    if (InitMbedtlsRng() != HAL_SUCCESS) {
+        LOGW("Init shared rng failed, mbedtls operations will seed their own.");
+    }
+    if (InitMbedtlsBigNumCtx() != HAL_SUCCESS) {
+        LOGW("Init big number context failed, the constants will be built per operation.");
+    }
+    if (InitParamSetCache() != HAL_SUCCESS) {
+        LOGW("Init param set cache failed, the param sets will be built per operation.");
+    }
+    if (InitKeyExistCache() != HAL_SUCCESS) {
+        LOGW("Init key exist cache failed, every check will query huks.");
+    }
+    return HAL_SUCCESS;
+}
+
+#ifdef DEV_AUTH_ENABLE_MBEDTLS_EXP_MOD
+static int32_t DlBigNumExpMod(const Uint8Buff *base, const Uint8Buff *exp, const char *bigNumHex, Uint8Buff *outNum)
+{
+    int32_t res = MbedtlsBigNumExpMod(base, exp, bigNumHex, outNum);
+    if (res != HAL_ERR_NOT_SUPPORTED) {
+        return res;
+    }
+    return BigNumExpMod(base, exp, bigNumHex, outNum);
+}
+#endif
+
 static const AlgLoader g_huksLoader = {
-    .initAlg = InitHks,
+    .initAlg = InitAlg,
     .sha256 = Sha256,
     .generateRandom = GenerateRandom,
     .computeHmac = ComputeHmac,
@@ -1086,7 +1152,11 @@ static const AlgLoader g_huksLoader = {
     .hashToPoint = HashToPoint,
     .agreeSharedSecretWithStorage = AgreeSharedSecretWithStorage,
     .agreeSharedSecret = AgreeSharedSecret,
+#ifdef DEV_AUTH_ENABLE_MBEDTLS_EXP_MOD
+    .bigNumExpMod = DlBigNumExpMod,
+#else
     .bigNumExpMod = BigNumExpMod,
+#endif
     .generateKeyPairWithStorage = GenerateKeyPairWithStorage,
     .exportPublicKey = ExportPublicKey,
     .sign = Sign,
@@ -1096,7 +1166,9 @@ static const AlgLoader g_huksLoader = {
     .checkEcPublicKey = CheckEcPublicKey,
     .bigNumCompare = BigNumCompare,
     .base64Encode = MbedtlsBase64Encode,
-    .base64Decode = MbedtlsBase64Decode
+    .base64Decode = MbedtlsBase64Decode,
+    .clearKeyExistCache = ClearKeyExistCache,
+    .getKeyExistCacheStats = GetKeyExistCacheStats
 };
 
 const AlgLoader *GetRealLoaderInstance(void)
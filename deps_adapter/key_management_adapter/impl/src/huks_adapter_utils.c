@@ -15,6 +15,7 @@
 #include "huks_adapter_utils.h"
 
 #include "hc_log.h"
+#include "hc_mutex.h"
 #include "mbedtls_ec_adapter.h"
 #include "string_util.h"
 
@@ -39,6 +40,8 @@
 #define EXT_CE_PARAMS_LEN 2
 #define PSEUDONYM_KEY_FACTOR "hichain_pseudonym_psk_key"
 #define PSEUDONYM_KEY_LEBEL "hichain_pseudonym_psk_label"
+#define PARAM_SET_CACHE_SIZE 32
+#define KEY_EXIST_CACHE_SIZE 64
 
 static uint32_t g_purposeToHksKeyPurpose[] = {
     HKS_KEY_PURPOSE_MAC,
@@ -54,6 +57,101 @@ static enum HksKeyAlg g_algToHksAlgorithm[] = {
     HKS_ALG_AES,
 };
 
+/* Binary form of DL_PRIME_HEX_384 and DL_PRIME_HEX_256, so that the primes needn't be converted per call. */
+static const uint8_t DL_PRIME_384[BIG_PRIME_LEN_384] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xC9, 0x0F, 0xDA, 0xA2,
+    0x21, 0x68, 0xC2, 0x34, 0xC4, 0xC6, 0x62, 0x8B, 0x80, 0xDC, 0x1C, 0xD1,
+    0x29, 0x02, 0x4E, 0x08, 0x8A, 0x67, 0xCC, 0x74, 0x02, 0x0B, 0xBE, 0xA6,
+    0x3B, 0x13, 0x9B, 0x22, 0x51, 0x4A, 0x08, 0x79, 0x8E, 0x34, 0x04, 0xDD,
+    0xEF, 0x95, 0x19, 0xB3, 0xCD, 0x3A, 0x43, 0x1B, 0x30, 0x2B, 0x0A, 0x6D,
+    0xF2, 0x5F, 0x14, 0x37, 0x4F, 0xE1, 0x35, 0x6D, 0x6D, 0x51, 0xC2, 0x45,
+    0xE4, 0x85, 0xB5, 0x76, 0x62, 0x5E, 0x7E, 0xC6, 0xF4, 0x4C, 0x42, 0xE9,
+    0xA6, 0x37, 0xED, 0x6B, 0x0B, 0xFF, 0x5C, 0xB6, 0xF4, 0x06, 0xB7, 0xED,
+    0xEE, 0x38, 0x6B, 0xFB, 0x5A, 0x89, 0x9F, 0xA5, 0xAE, 0x9F, 0x24, 0x11,
+    0x7C, 0x4B, 0x1F, 0xE6, 0x49, 0x28, 0x66, 0x51, 0xEC, 0xE4, 0x5B, 0x3D,
+    0xC2, 0x00, 0x7C, 0xB8, 0xA1, 0x63, 0xBF, 0x05, 0x98, 0xDA, 0x48, 0x36,
+    0x1C, 0x55, 0xD3, 0x9A, 0x69, 0x16, 0x3F, 0xA8, 0xFD, 0x24, 0xCF, 0x5F,
+    0x83, 0x65, 0x5D, 0x23, 0xDC, 0xA3, 0xAD, 0x96, 0x1C, 0x62, 0xF3, 0x56,
+    0x20, 0x85, 0x52, 0xBB, 0x9E, 0xD5, 0x29, 0x07, 0x70, 0x96, 0x96, 0x6D,
+    0x67, 0x0C, 0x35, 0x4E, 0x4A, 0xBC, 0x98, 0x04, 0xF1, 0x74, 0x6C, 0x08,
+    0xCA, 0x18, 0x21, 0x7C, 0x32, 0x90, 0x5E, 0x46, 0x2E, 0x36, 0xCE, 0x3B,
+    0xE3, 0x9E, 0x77, 0x2C, 0x18, 0x0E, 0x86, 0x03, 0x9B, 0x27, 0x83, 0xA2,
+    0xEC, 0x07, 0xA2, 0x8F, 0xB5, 0xC5, 0x5D, 0xF0, 0x6F, 0x4C, 0x52, 0xC9,
+    0xDE, 0x2B, 0xCB, 0xF6, 0x95, 0x58, 0x17, 0x18, 0x39, 0x95, 0x49, 0x7C,
+    0xEA, 0x95, 0x6A, 0xE5, 0x15, 0xD2, 0x26, 0x18, 0x98, 0xFA, 0x05, 0x10,
+    0x15, 0x72, 0x8E, 0x5A, 0x8A, 0xAA, 0xC4, 0x2D, 0xAD, 0x33, 0x17, 0x0D,
+    0x04, 0x50, 0x7A, 0x33, 0xA8, 0x55, 0x21, 0xAB, 0xDF, 0x1C, 0xBA, 0x64,
+    0xEC, 0xFB, 0x85, 0x04, 0x58, 0xDB, 0xEF, 0x0A, 0x8A, 0xEA, 0x71, 0x57,
+    0x5D, 0x06, 0x0C, 0x7D, 0xB3, 0x97, 0x0F, 0x85, 0xA6, 0xE1, 0xE4, 0xC7,
+    0xAB, 0xF5, 0xAE, 0x8C, 0xDB, 0x09, 0x33, 0xD7, 0x1E, 0x8C, 0x94, 0xE0,
+    0x4A, 0x25, 0x61, 0x9D, 0xCE, 0xE3, 0xD2, 0x26, 0x1A, 0xD2, 0xEE, 0x6B,
+    0xF1, 0x2F, 0xFA, 0x06, 0xD9, 0x8A, 0x08, 0x64, 0xD8, 0x76, 0x02, 0x73,
+    0x3E, 0xC8, 0x6A, 0x64, 0x52, 0x1F, 0x2B, 0x18, 0x17, 0x7B, 0x20, 0x0C,
+    0xBB, 0xE1, 0x17, 0x57, 0x7A, 0x61, 0x5D, 0x6C, 0x77, 0x09, 0x88, 0xC0,
+    0xBA, 0xD9, 0x46, 0xE2, 0x08, 0xE2, 0x4F, 0xA0, 0x74, 0xE5, 0xAB, 0x31,
+    0x43, 0xDB, 0x5B, 0xFC, 0xE0, 0xFD, 0x10, 0x8E, 0x4B, 0x82, 0xD1, 0x20,
+    0xA9, 0x3A, 0xD2, 0xCA, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+static const uint8_t DL_PRIME_256[BIG_PRIME_LEN_256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xC9, 0x0F, 0xDA, 0xA2,
+    0x21, 0x68, 0xC2, 0x34, 0xC4, 0xC6, 0x62, 0x8B, 0x80, 0xDC, 0x1C, 0xD1,
+    0x29, 0x02, 0x4E, 0x08, 0x8A, 0x67, 0xCC, 0x74, 0x02, 0x0B, 0xBE, 0xA6,
+    0x3B, 0x13, 0x9B, 0x22, 0x51, 0x4A, 0x08, 0x79, 0x8E, 0x34, 0x04, 0xDD,
+    0xEF, 0x95, 0x19, 0xB3, 0xCD, 0x3A, 0x43, 0x1B, 0x30, 0x2B, 0x0A, 0x6D,
+    0xF2, 0x5F, 0x14, 0x37, 0x4F, 0xE1, 0x35, 0x6D, 0x6D, 0x51, 0xC2, 0x45,
+    0xE4, 0x85, 0xB5, 0x76, 0x62, 0x5E, 0x7E, 0xC6, 0xF4, 0x4C, 0x42, 0xE9,
+    0xA6, 0x37, 0xED, 0x6B, 0x0B, 0xFF, 0x5C, 0xB6, 0xF4, 0x06, 0xB7, 0xED,
+    0xEE, 0x38, 0x6B, 0xFB, 0x5A, 0x89, 0x9F, 0xA5, 0xAE, 0x9F, 0x24, 0x11,
+    0x7C, 0x4B, 0x1F, 0xE6, 0x49, 0x28, 0x66, 0x51, 0xEC, 0xE4, 0x5B, 0x3D,
+    0xC2, 0x00, 0x7C, 0xB8, 0xA1, 0x63, 0xBF, 0x05, 0x98, 0xDA, 0x48, 0x36,
+    0x1C, 0x55, 0xD3, 0x9A, 0x69, 0x16, 0x3F, 0xA8, 0xFD, 0x24, 0xCF, 0x5F,
+    0x83, 0x65, 0x5D, 0x23, 0xDC, 0xA3, 0xAD, 0x96, 0x1C, 0x62, 0xF3, 0x56,
+    0x20, 0x85, 0x52, 0xBB, 0x9E, 0xD5, 0x29, 0x07, 0x70, 0x96, 0x96, 0x6D,
+    0x67, 0x0C, 0x35, 0x4E, 0x4A, 0xBC, 0x98, 0x04, 0xF1, 0x74, 0x6C, 0x08,
+    0xCA, 0x18, 0x21, 0x7C, 0x32, 0x90, 0x5E, 0x46, 0x2E, 0x36, 0xCE, 0x3B,
+    0xE3, 0x9E, 0x77, 0x2C, 0x18, 0x0E, 0x86, 0x03, 0x9B, 0x27, 0x83, 0xA2,
+    0xEC, 0x07, 0xA2, 0x8F, 0xB5, 0xC5, 0x5D, 0xF0, 0x6F, 0x4C, 0x52, 0xC9,
+    0xDE, 0x2B, 0xCB, 0xF6, 0x95, 0x58, 0x17, 0x18, 0x39, 0x95, 0x49, 0x7C,
+    0xEA, 0x95, 0x6A, 0xE5, 0x15, 0xD2, 0x26, 0x18, 0x98, 0xFA, 0x05, 0x10,
+    0x15, 0x72, 0x8E, 0x5A, 0x8A, 0xAC, 0xAA, 0x68, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+typedef struct {
+    const char *primeHex;
+    const uint8_t *primeByte;
+    uint32_t primeLen;
+} DlPrimeInfo;
+
+static const DlPrimeInfo DL_PRIME_LIST[] = {
+    { DL_PRIME_HEX_384, DL_PRIME_384, BIG_PRIME_LEN_384 },
+    { DL_PRIME_HEX_256, DL_PRIME_256, BIG_PRIME_LEN_256 },
+};
+
+/* Param sets whose tags all hold inline values, built once and shared, never freed by FreeParamSet. */
+static struct HksParamSet *g_paramSetCache[PARAM_SET_CACHE_SIZE] = { NULL };
+static uint32_t g_paramSetCacheCount = 0;
+static HcMutex g_paramSetCacheMutex;
+static bool g_isParamSetCacheInit = false;
+
+typedef struct {
+    uint8_t *alias;
+    uint32_t aliasLen;
+    int32_t osAccountId;
+    bool isDeStorage;
+} KeyExistCacheEntry;
+
+/* Aliases known to exist in huks, replaced round robin once full. Only positive results are kept. */
+static KeyExistCacheEntry g_keyExistCache[KEY_EXIST_CACHE_SIZE] = { { NULL, 0, 0, false } };
+static uint32_t g_keyExistCacheNext = 0;
+static uint64_t g_keyExistCacheHit = 0;
+static uint64_t g_keyExistCacheMiss = 0;
+/* Bumped on every removal, so a lookup that raced with a delete does not cache a stale positive result. */
+static uint64_t g_keyExistCacheGeneration = 0;
+static HcMutex g_keyExistCacheMutex;
+static bool g_isKeyExistCacheInit = false;
+
 int32_t CheckKeyParams(const KeyParams *keyParams)
 {
     CHECK_PTR_RETURN_HAL_ERROR_CODE(keyParams, "keyParams");
@@ -72,6 +170,23 @@ static int32_t BaseCheckParams(const Uint8Buff **inParams, const char **paramTag
     return HAL_SUCCESS;
 }
 
+int32_t GetDlPrimeByte(const char *primeHex, uint32_t primeLen, uint8_t *primeBuf, const uint8_t **primeByte)
+{
+    for (uint32_t i = 0; i < CAL_ARRAY_SIZE(DL_PRIME_LIST); i++) {
+        if ((DL_PRIME_LIST[i].primeLen == primeLen) &&
+            (memcmp(DL_PRIME_LIST[i].primeHex, primeHex, primeLen * BYTE_TO_HEX_OPER_LENGTH) == 0)) {
+            *primeByte = DL_PRIME_LIST[i].primeByte;
+            return HAL_SUCCESS;
+        }
+    }
+    int32_t res = HexStringToByte(primeHex, primeBuf, primeLen);
+    if (res != HAL_SUCCESS) {
+        return res;
+    }
+    *primeByte = primeBuf;
+    return HAL_SUCCESS;
+}
+
 int32_t BigNumExpMod(const Uint8Buff *base, const Uint8Buff *exp, const char *bigNumHex, Uint8Buff *outNum)
 {
     const Uint8Buff *inParams[] = { base, exp, outNum };
@@ -92,34 +207,44 @@ int32_t BigNumExpMod(const Uint8Buff *base, const Uint8Buff *exp, const char *bi
     struct HksBlob baseBlob = { base->length, base->val };
     struct HksBlob expBlob = { exp->length, exp->val };
     struct HksBlob outNumBlob = { outNum->length, outNum->val };
-    struct HksBlob bigNumBlob = { 0, NULL };
-    bigNumBlob.size = outNum->length;
-    bigNumBlob.data = (uint8_t *)HcMalloc(bigNumBlob.size, 0);
-    if (bigNumBlob.data == NULL) {
-        LOGE("malloc bigNumBlob.data failed.");
-        return HAL_ERR_BAD_ALLOC;
-    }
-    res = HexStringToByte(bigNumHex, bigNumBlob.data, bigNumBlob.size);
+    uint8_t primeBuf[BIG_PRIME_LEN_384] = { 0 };
+    const uint8_t *primeByte = NULL;
+    res = GetDlPrimeByte(bigNumHex, primeLen, primeBuf, &primeByte);
     if (res != HAL_SUCCESS) {
         LOGE("HexStringToByte for bigNumHex failed.");
-        HcFree(bigNumBlob.data);
         return res;
     }
+    struct HksBlob bigNumBlob = { primeLen, (uint8_t *)primeByte };
 
     res = HksBnExpMod(&outNumBlob, &baseBlob, &expBlob, &bigNumBlob);
     if (res != HKS_SUCCESS) {
         LOGE("Huks calculate big number exp mod failed, res = %" LOG_PUB "d", res);
-        HcFree(bigNumBlob.data);
         return HAL_FAILED;
     }
     outNum->length = outNumBlob.size;
-    HcFree(bigNumBlob.data);
     return HAL_SUCCESS;
 }
 
+static bool IsCachedParamSet(const struct HksParamSet *paramSet)
+{
+    if (!g_isParamSetCacheInit) {
+        return false;
+    }
+    bool isCached = false;
+    LockHcMutex(&g_paramSetCacheMutex);
+    for (uint32_t i = 0; i < g_paramSetCacheCount; i++) {
+        if (g_paramSetCache[i] == paramSet) {
+            isCached = true;
+            break;
+        }
+    }
+    UnlockHcMutex(&g_paramSetCacheMutex);
+    return isCached;
+}
+
 void FreeParamSet(struct HksParamSet *paramSet)
 {
-    if (paramSet == NULL) {
+    if (paramSet == NULL || IsCachedParamSet(paramSet)) {
         return;
     }
     HksFreeParamSet(&paramSet);
@@ -138,14 +263,14 @@ int32_t ConstructParamSet(struct HksParamSet **out, const struct HksParam *inPar
     res = HksAddParams(paramSet, inParam, inParamNum);
     if (res != HKS_SUCCESS) {
         LOGE("add param failed, res = %" LOG_PUB "d", res);
-        FreeParamSet(paramSet);
+        HksFreeParamSet(&paramSet);
         return HAL_ERR_ADD_PARAM_FAILED;
     }
 
     res = HksBuildParamSet(&paramSet);
     if (res != HKS_SUCCESS) {
         LOGE("build param set failed, res = %" LOG_PUB "d", res);
-        FreeParamSet(paramSet);
+        HksFreeParamSet(&paramSet);
         return HAL_ERR_BUILD_PARAM_SET_FAILED;
     }
 
@@ -153,6 +278,255 @@ int32_t ConstructParamSet(struct HksParamSet **out, const struct HksParam *inPar
     return HAL_SUCCESS;
 }
 
+int32_t InitParamSetCache(void)
+{
+    if (g_isParamSetCacheInit) {
+        return HAL_SUCCESS;
+    }
+    if (InitHcMutex(&g_paramSetCacheMutex, false) != HAL_SUCCESS) {
+        LOGE("Init param set cache mutex failed.");
+        return HAL_FAILED;
+    }
+    g_isParamSetCacheInit = true;
+    return HAL_SUCCESS;
+}
+
+static bool IsParamEqual(const struct HksParam *param, const struct HksParam *other)
+{
+    if (param->tag != other->tag) {
+        return false;
+    }
+    switch (param->tag & HKS_TAG_TYPE_MASK) {
+        case HKS_TAG_TYPE_INT:
+            return param->int32Param == other->int32Param;
+        case HKS_TAG_TYPE_UINT:
+            return param->uint32Param == other->uint32Param;
+        case HKS_TAG_TYPE_ULONG:
+            return param->uint64Param == other->uint64Param;
+        case HKS_TAG_TYPE_BOOL:
+            return param->boolParam == other->boolParam;
+        default:
+            return false;
+    }
+}
+
+static bool IsCacheableParams(const struct HksParam *inParam, uint32_t inParamNum)
+{
+    for (uint32_t i = 0; i < inParamNum; i++) {
+        uint32_t tagType = inParam[i].tag & HKS_TAG_TYPE_MASK;
+        if (tagType != HKS_TAG_TYPE_INT && tagType != HKS_TAG_TYPE_UINT && tagType != HKS_TAG_TYPE_ULONG &&
+            tagType != HKS_TAG_TYPE_BOOL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool IsParamSetMatched(const struct HksParamSet *paramSet, const struct HksParam *inParam,
+    uint32_t inParamNum)
+{
+    if (paramSet->paramsCnt != inParamNum) {
+        return false;
+    }
+    for (uint32_t i = 0; i < inParamNum; i++) {
+        if (!IsParamEqual(&paramSet->params[i], &inParam[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* The caller holds g_paramSetCacheMutex. */
+static struct HksParamSet *FindCachedParamSet(const struct HksParam *inParam, uint32_t inParamNum)
+{
+    for (uint32_t i = 0; i < g_paramSetCacheCount; i++) {
+        if (IsParamSetMatched(g_paramSetCache[i], inParam, inParamNum)) {
+            return g_paramSetCache[i];
+        }
+    }
+    return NULL;
+}
+
+int32_t ConstructCachedParamSet(struct HksParamSet **out, const struct HksParam *inParam,
+    const uint32_t inParamNum)
+{
+    if (!g_isParamSetCacheInit || !IsCacheableParams(inParam, inParamNum)) {
+        return ConstructParamSet(out, inParam, inParamNum);
+    }
+    LockHcMutex(&g_paramSetCacheMutex);
+    struct HksParamSet *cached = FindCachedParamSet(inParam, inParamNum);
+    UnlockHcMutex(&g_paramSetCacheMutex);
+    if (cached != NULL) {
+        *out = cached;
+        return HAL_SUCCESS;
+    }
+    /* Built outside the lock, the free paths take the cache lock through FreeParamSet. */
+    struct HksParamSet *paramSet = NULL;
+    int32_t res = ConstructParamSet(&paramSet, inParam, inParamNum);
+    if (res != HAL_SUCCESS) {
+        return res;
+    }
+    LockHcMutex(&g_paramSetCacheMutex);
+    cached = FindCachedParamSet(inParam, inParamNum);
+    if (cached == NULL && g_paramSetCacheCount < PARAM_SET_CACHE_SIZE) {
+        g_paramSetCache[g_paramSetCacheCount++] = paramSet;
+    }
+    UnlockHcMutex(&g_paramSetCacheMutex);
+    if (cached != NULL) {
+        HksFreeParamSet(&paramSet);
+        paramSet = cached;
+    }
+    *out = paramSet;
+    return HAL_SUCCESS;
+}
+
+int32_t InitKeyExistCache(void)
+{
+    if (g_isKeyExistCacheInit) {
+        return HAL_SUCCESS;
+    }
+    if (InitHcMutex(&g_keyExistCacheMutex, false) != HAL_SUCCESS) {
+        LOGE("Init key exist cache mutex failed.");
+        return HAL_FAILED;
+    }
+    g_isKeyExistCacheInit = true;
+    return HAL_SUCCESS;
+}
+
+static bool IsKeyExistEntryMatched(const KeyExistCacheEntry *entry, const Uint8Buff *keyAlias,
+    int32_t osAccountId)
+{
+    return entry->alias != NULL && entry->osAccountId == osAccountId && entry->aliasLen == keyAlias->length &&
+        memcmp(entry->alias, keyAlias->val, keyAlias->length) == 0;
+}
+
+static void ClearKeyExistEntry(KeyExistCacheEntry *entry)
+{
+    HcFree(entry->alias);
+    entry->alias = NULL;
+    entry->aliasLen = 0;
+}
+
+bool IsKeyExistCached(const Uint8Buff *keyAlias, bool isDeStorage, int32_t osAccountId)
+{
+    if (!g_isKeyExistCacheInit) {
+        return false;
+    }
+    bool isCached = false;
+    LockHcMutex(&g_keyExistCacheMutex);
+    for (uint32_t i = 0; i < KEY_EXIST_CACHE_SIZE; i++) {
+        if (g_keyExistCache[i].isDeStorage == isDeStorage &&
+            IsKeyExistEntryMatched(&g_keyExistCache[i], keyAlias, osAccountId)) {
+            isCached = true;
+            break;
+        }
+    }
+    if (isCached) {
+        g_keyExistCacheHit++;
+    } else {
+        g_keyExistCacheMiss++;
+    }
+    UnlockHcMutex(&g_keyExistCacheMutex);
+    return isCached;
+}
+
+uint64_t GetKeyExistCacheGeneration(void)
+{
+    if (!g_isKeyExistCacheInit) {
+        return 0;
+    }
+    LockHcMutex(&g_keyExistCacheMutex);
+    uint64_t generation = g_keyExistCacheGeneration;
+    UnlockHcMutex(&g_keyExistCacheMutex);
+    return generation;
+}
+
+void AddKeyExistCache(const Uint8Buff *keyAlias, bool isDeStorage, int32_t osAccountId, uint64_t generation)
+{
+    if (!g_isKeyExistCacheInit) {
+        return;
+    }
+    LockHcMutex(&g_keyExistCacheMutex);
+    if (generation != g_keyExistCacheGeneration) {
+        UnlockHcMutex(&g_keyExistCacheMutex);
+        return;
+    }
+    for (uint32_t i = 0; i < KEY_EXIST_CACHE_SIZE; i++) {
+        if (g_keyExistCache[i].isDeStorage == isDeStorage &&
+            IsKeyExistEntryMatched(&g_keyExistCache[i], keyAlias, osAccountId)) {
+            UnlockHcMutex(&g_keyExistCacheMutex);
+            return;
+        }
+    }
+    uint8_t *alias = (uint8_t *)HcMalloc(keyAlias->length, 0);
+    if (alias == NULL || memcpy_s(alias, keyAlias->length, keyAlias->val, keyAlias->length) != EOK) {
+        LOGW("Copy key alias for cache failed.");
+        HcFree(alias);
+        UnlockHcMutex(&g_keyExistCacheMutex);
+        return;
+    }
+    KeyExistCacheEntry *entry = &g_keyExistCache[g_keyExistCacheNext];
+    g_keyExistCacheNext = (g_keyExistCacheNext + 1) % KEY_EXIST_CACHE_SIZE;
+    ClearKeyExistEntry(entry);
+    entry->alias = alias;
+    entry->aliasLen = keyAlias->length;
+    entry->osAccountId = osAccountId;
+    entry->isDeStorage = isDeStorage;
+    UnlockHcMutex(&g_keyExistCacheMutex);
+}
+
+void RemoveKeyExistCache(const Uint8Buff *keyAlias, int32_t osAccountId)
+{
+    if (!g_isKeyExistCacheInit) {
+        return;
+    }
+    LockHcMutex(&g_keyExistCacheMutex);
+    g_keyExistCacheGeneration++;
+    for (uint32_t i = 0; i < KEY_EXIST_CACHE_SIZE; i++) {
+        if (IsKeyExistEntryMatched(&g_keyExistCache[i], keyAlias, osAccountId)) {
+            ClearKeyExistEntry(&g_keyExistCache[i]);
+        }
+    }
+    UnlockHcMutex(&g_keyExistCacheMutex);
+}
+
+void ClearKeyExistCache(int32_t osAccountId)
+{
+    if (!g_isKeyExistCacheInit) {
+        return;
+    }
+    LockHcMutex(&g_keyExistCacheMutex);
+    g_keyExistCacheGeneration++;
+    for (uint32_t i = 0; i < KEY_EXIST_CACHE_SIZE; i++) {
+        if (g_keyExistCache[i].osAccountId == osAccountId) {
+            ClearKeyExistEntry(&g_keyExistCache[i]);
+        }
+    }
+    UnlockHcMutex(&g_keyExistCacheMutex);
+}
+
+void GetKeyExistCacheStats(KeyExistCacheStats *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    stats->hitCount = 0;
+    stats->missCount = 0;
+    stats->entryCount = 0;
+    if (!g_isKeyExistCacheInit) {
+        return;
+    }
+    LockHcMutex(&g_keyExistCacheMutex);
+    stats->hitCount = g_keyExistCacheHit;
+    stats->missCount = g_keyExistCacheMiss;
+    for (uint32_t i = 0; i < KEY_EXIST_CACHE_SIZE; i++) {
+        if (g_keyExistCache[i].alias != NULL) {
+            stats->entryCount++;
+        }
+    }
+    UnlockHcMutex(&g_keyExistCacheMutex);
+}
+
 static uint32_t GetParamLen(bool isDeStorage, uint32_t baseLen)
 {
 #ifdef DEV_AUTH_ENABLE_CE
@@ -196,7 +570,7 @@ static int32_t ConstructDeParamSet(struct HksParamSet **paramSet)
         }
     };
 
-    int32_t res = ConstructParamSet(paramSet, keyParam, CAL_ARRAY_SIZE(keyParam));
+    int32_t res = ConstructCachedParamSet(paramSet, keyParam, CAL_ARRAY_SIZE(keyParam));
     if (res != HAL_SUCCESS) {
         LOGE("Construct de param set failed, res = %" LOG_PUB "d", res);
     }
@@ -215,7 +589,7 @@ static int32_t ConstructCeParamSet(int32_t osAccountId, struct HksParamSet **par
         }
     };
 
-    int32_t res = ConstructParamSet(paramSet, keyParam, CAL_ARRAY_SIZE(keyParam));
+    int32_t res = ConstructCachedParamSet(paramSet, keyParam, CAL_ARRAY_SIZE(keyParam));
     if (res != HAL_SUCCESS) {
         LOGE("Construct ce param set failed, res = %" LOG_PUB "d", res);
     }
@@ -270,7 +644,7 @@ int32_t ConstructCheckParamSet(bool isDeStorage, int32_t osAccountId, struct Hks
     }
     uint32_t idx = 0;
     AddStorageExtParams(checkParams, isDeStorage, &idx, osAccountId);
-    int32_t res = ConstructParamSet(paramSet, checkParams, idx);
+    int32_t res = ConstructCachedParamSet(paramSet, checkParams, idx);
     HcFree(checkParams);
     if (res != HAL_SUCCESS) {
         LOGE("Failed to construct check param set, res: %" LOG_PUB "d", res);
@@ -291,7 +665,7 @@ int32_t ConstructDeleteParamSet(bool isDeStorage, int32_t osAccountId, struct Hk
     }
     uint32_t idx = 0;
     AddStorageExtParams(deleteParams, isDeStorage, &idx, osAccountId);
-    int32_t res = ConstructParamSet(paramSet, deleteParams, idx);
+    int32_t res = ConstructCachedParamSet(paramSet, deleteParams, idx);
     HcFree(deleteParams);
     if (res != HAL_SUCCESS) {
         LOGE("Failed to construct delete param set, res: %" LOG_PUB "d", res);
@@ -316,7 +690,7 @@ int32_t ConstructHmacParamSet(bool isDeStorage, int32_t osAccountId, bool isAlia
     hmacParams[idx].tag = HKS_TAG_IS_KEY_ALIAS;
     hmacParams[idx++].boolParam = isAlias;
     AddStorageExtParams(hmacParams, isDeStorage, &idx, osAccountId);
-    int32_t res = ConstructParamSet(hmacParamSet, hmacParams, idx);
+    int32_t res = ConstructCachedParamSet(hmacParamSet, hmacParams, idx);
     HcFree(hmacParams);
     if (res != HAL_SUCCESS) {
         LOGE("Construct hmac param set failed, res = %" LOG_PUB "d", res);
@@ -897,7 +1271,7 @@ int32_t ConstructExportParams(bool isDeStorage, int32_t osAccountId, struct HksP
     }
     uint32_t idx = 0;
     AddStorageExtParams(exportParams, isDeStorage, &idx, osAccountId);
-    int32_t res = ConstructParamSet(paramSet, exportParams, idx);
+    int32_t res = ConstructCachedParamSet(paramSet, exportParams, idx);
     HcFree(exportParams);
     if (res != HAL_SUCCESS) {
         LOGE("Failed to construct export param set, res: %" LOG_PUB "d", res);
@@ -934,7 +1308,7 @@ int32_t ConstructSignParams(bool isDeStorage, int32_t osAccountId, struct HksPar
     signParams[idx].tag = HKS_TAG_DIGEST;
     signParams[idx++].uint32Param = HKS_DIGEST_SHA256;
     AddStorageExtParams(signParams, isDeStorage, &idx, osAccountId);
-    int32_t res = ConstructParamSet(paramSet, signParams, idx);
+    int32_t res = ConstructCachedParamSet(paramSet, signParams, idx);
     HcFree(signParams);
     if (res != HAL_SUCCESS) {
         LOGE("Construct sign param set failed, res = %" LOG_PUB "d", res);
@@ -972,7 +1346,7 @@ int32_t ConstructVerifyParams(struct HksParamSet **paramSet, const KeyParams *ke
     verifyParams[idx].tag = HKS_TAG_DIGEST;
     verifyParams[idx++].uint32Param = HKS_DIGEST_SHA256;
     AddStorageExtParams(verifyParams, keyParams->isDeStorage, &idx, keyParams->osAccountId);
-    int32_t res = ConstructParamSet(paramSet, verifyParams, idx);
+    int32_t res = ConstructCachedParamSet(paramSet, verifyParams, idx);
     HcFree(verifyParams);
     if (res != HAL_SUCCESS) {
         LOGE("Construct verify param set failed, res = %" LOG_PUB "d", res);
@@ -15,6 +15,7 @@
 
 #include "crypto_hash_to_point.h"
 #include <openssl/bn.h>
+#include <openssl/crypto.h>
 #include <openssl/evp.h>
 #include <openssl/rand.h>
 #include "hal_error.h"
@@ -23,6 +24,7 @@
 #include "hks_type.h"
 
 #define KEY_BYTES_CURVE25519                 32
+#define BN_CTX_POOL_SIZE                     4
 
 struct CurveConstPara {
     BIGNUM *p;
@@ -83,6 +85,14 @@ static const uint8_t g_curveParamQ[KEY_BYTES_CURVE25519] = {
     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf6
 };
 
+/* The constants are built once and only read afterwards, the BN_CTX pool is guarded by g_bnCtxPoolLock. */
+static struct CurveConstPara g_curvePara;
+static int32_t g_curveParaRes = HAL_FAILED;
+static CRYPTO_ONCE g_curveParaOnce = CRYPTO_ONCE_STATIC_INIT;
+static CRYPTO_RWLOCK *g_bnCtxPoolLock = NULL;
+static BN_CTX *g_bnCtxPool[BN_CTX_POOL_SIZE];
+static uint32_t g_bnCtxPoolCount = 0;
+
 static void HcBnFree(BIGNUM *p)
 {
     if (p == NULL) {
@@ -158,13 +168,13 @@ static int32_t CurveInitConstPara(struct CurveConstPara *para)
 static int32_t CurveHashToPointCalcB(const struct HksBlob *hash,
     const struct CurveConstPara *curvePara, BIGNUM *b, BN_CTX *ctx)
 {
-    BIGNUM *swap = BN_new();
-    if (swap == NULL) {
-        return HAL_FAILED;
-    }
-    
+    BN_CTX_start(ctx);
+    BIGNUM *swap = BN_CTX_get(ctx);
     int32_t ret = HAL_FAILED;
     do {
+        if (swap == NULL) {
+            break;
+        }
         if (BN_bin2bn(hash->data, hash->size, swap) == NULL) {
             break;
         }
@@ -197,26 +207,21 @@ static int32_t CurveHashToPointCalcB(const struct HksBlob *hash,
         }
         ret = HAL_SUCCESS;
     } while (0);
-    HcBnFree(swap);
+    BN_CTX_end(ctx);
     return ret;
 }
 
 static int32_t CurveHashToPointCalcA(const BIGNUM *b,
     const struct CurveConstPara *curvePara, BIGNUM *a, BN_CTX *ctx)
 {
-    BIGNUM *swap = BN_new();
-    if (swap == NULL) {
-        return HAL_FAILED;
-    }
-
-    BIGNUM *result = BN_new();
-    if (result == NULL) {
-        HcBnFree(swap);
-        return HAL_FAILED;
-    }
-
+    BN_CTX_start(ctx);
+    BIGNUM *swap = BN_CTX_get(ctx);
+    BIGNUM *result = BN_CTX_get(ctx);
     int32_t ret = HAL_FAILED;
     do {
+        if ((swap == NULL) || (result == NULL)) {
+            break;
+        }
         if (BN_mul(result, b, b, ctx) <= 0) {
             break;
         }
@@ -249,22 +254,20 @@ static int32_t CurveHashToPointCalcA(const BIGNUM *b,
         }
         ret = HAL_SUCCESS;
     } while (0);
-
-    HcBnFree(swap);
-    HcBnFree(result);
+    BN_CTX_end(ctx);
     return ret;
 }
 
 static int32_t CurveHashToPointCalcC(const BIGNUM *a, BIGNUM *b,
     const struct CurveConstPara *curvePara, BIGNUM *c, BN_CTX *ctx)
 {
-    BIGNUM *result = BN_new();
-    if (result == NULL) {
-        return HAL_FAILED;
-    }
-
+    BN_CTX_start(ctx);
+    BIGNUM *result = BN_CTX_get(ctx);
     int32_t ret = HAL_FAILED;
     do {
+        if (result == NULL) {
+            break;
+        }
         /* If a is a quadratic residue modulo p, c := b and high_y := 1 Otherwise c := -b - A and high_y := 0 */
         if (BN_sub(c, curvePara->p, b) <= 0) {
             break;
@@ -287,8 +290,7 @@ static int32_t CurveHashToPointCalcC(const BIGNUM *a, BIGNUM *b,
         }
         ret = HAL_SUCCESS;
     } while (0);
-
-    HcBnFree(result);
+    BN_CTX_end(ctx);
     return ret;
 }
 
@@ -326,36 +328,91 @@ static int32_t CurveSetConstPara(struct CurveConstPara *para)
     return ret;
 }
 
+static void CurveInitConstParaOnce(void)
+{
+    (void)memset_s(&g_curvePara, sizeof(g_curvePara), 0, sizeof(g_curvePara));
+    if (CurveInitConstPara(&g_curvePara) != HAL_SUCCESS) {
+        LOGE("Init curve const para failed.");
+        return;
+    }
+    if (CurveSetConstPara(&g_curvePara) != HAL_SUCCESS) {
+        LOGE("Set curve const para failed.");
+        CurveFreeConstPara(&g_curvePara);
+        return;
+    }
+    /* Without the lock every call simply allocates its own BN_CTX. */
+    g_bnCtxPoolLock = CRYPTO_THREAD_lock_new();
+    g_curveParaRes = HAL_SUCCESS;
+}
+
+static const struct CurveConstPara *GetCurveConstPara(void)
+{
+    if (CRYPTO_THREAD_run_once(&g_curveParaOnce, CurveInitConstParaOnce) != 1) {
+        LOGE("Run curve const para init failed.");
+        return NULL;
+    }
+    return (g_curveParaRes == HAL_SUCCESS) ? &g_curvePara : NULL;
+}
+
+static BN_CTX *AcquireBnCtx(void)
+{
+    BN_CTX *ctx = NULL;
+    if ((g_bnCtxPoolLock != NULL) && (CRYPTO_THREAD_write_lock(g_bnCtxPoolLock) == 1)) {
+        if (g_bnCtxPoolCount > 0) {
+            g_bnCtxPoolCount--;
+            ctx = g_bnCtxPool[g_bnCtxPoolCount];
+            g_bnCtxPool[g_bnCtxPoolCount] = NULL;
+        }
+        (void)CRYPTO_THREAD_unlock(g_bnCtxPoolLock);
+    }
+    if (ctx == NULL) {
+        ctx = BN_CTX_new();
+    }
+    return ctx;
+}
+
+static void ReleaseBnCtx(BN_CTX *ctx)
+{
+    if ((g_bnCtxPoolLock != NULL) && (CRYPTO_THREAD_write_lock(g_bnCtxPoolLock) == 1)) {
+        if (g_bnCtxPoolCount < BN_CTX_POOL_SIZE) {
+            g_bnCtxPool[g_bnCtxPoolCount] = ctx;
+            g_bnCtxPoolCount++;
+            ctx = NULL;
+        }
+        (void)CRYPTO_THREAD_unlock(g_bnCtxPoolLock);
+    }
+    HcBnCTXFree(ctx);
+}
+
 static int32_t CurveHashToPoint(const struct HksBlob *hash, struct HksBlob *point)
 {
-    struct CurveConstPara curvePara;
-    (void)memset_s(&curvePara, sizeof(curvePara), 0, sizeof(curvePara));
-    int32_t ret = CurveInitConstPara(&curvePara);
-    if (ret != HAL_SUCCESS) {
+    const struct CurveConstPara *curvePara = GetCurveConstPara();
+    if (curvePara == NULL) {
         return HAL_ERR_BAD_ALLOC;
     }
-    BIGNUM *a = BN_new();
-    BIGNUM *b = BN_new();
-    BIGNUM *c = BN_new();
-    BN_CTX *ctx = BN_CTX_new();
+    BN_CTX *ctx = AcquireBnCtx();
+    if (ctx == NULL) {
+        return HAL_ERR_BAD_ALLOC;
+    }
+    BN_CTX_start(ctx);
+    BIGNUM *a = BN_CTX_get(ctx);
+    BIGNUM *b = BN_CTX_get(ctx);
+    BIGNUM *c = BN_CTX_get(ctx);
+    int32_t ret;
     do {
-        if (a == NULL || b == NULL || c == NULL || ctx == NULL) {
+        if (a == NULL || b == NULL || c == NULL) {
             ret = HAL_ERR_BAD_ALLOC;
             break;
         }
-        ret = CurveSetConstPara(&curvePara);
+        ret = CurveHashToPointCalcB(hash, curvePara, b, ctx);
         if (ret != HAL_SUCCESS) {
             break;
         }
-        ret = CurveHashToPointCalcB(hash, &curvePara, b, ctx);
+        ret = CurveHashToPointCalcA(b, curvePara, a, ctx);
         if (ret != HAL_SUCCESS) {
             break;
         }
-        ret = CurveHashToPointCalcA(b, &curvePara, a, ctx);
-        if (ret != HAL_SUCCESS) {
-            break;
-        }
-        ret = CurveHashToPointCalcC(a, b, &curvePara, c, ctx);
+        ret = CurveHashToPointCalcC(a, b, curvePara, c, ctx);
         if (ret != HAL_SUCCESS) {
             break;
         }
@@ -365,11 +422,8 @@ static int32_t CurveHashToPoint(const struct HksBlob *hash, struct HksBlob *poin
         }
         ret = HAL_SUCCESS;
     } while (0);
-    CurveFreeConstPara(&curvePara);
-    HcBnFree(a);
-    HcBnFree(b);
-    HcBnFree(c);
-    HcBnCTXFree(ctx);
+    BN_CTX_end(ctx);
+    ReleaseBnCtx(ctx);
     return ret;
 }
 
@@ -20,23 +20,102 @@
 #include "hc_thread.h"
 
 #define TASK_ALLOC_UINT 5
+#define TASK_RING_MASK (HC_TASK_RING_SIZE - 1)
 
 IMPLEMENT_HC_VECTOR(TaskVec, HcTaskWrap, TASK_ALLOC_UINT)
 
+/*
+ * The ring is a bounded multi-producer queue: a producer claims a position with a CAS on pushPos and
+ * publishes the task by advancing the sequence of the slot, a consumer does the same on popPos.
+ * Clear may race with the task loop, so popping is lock-free for several consumers as well.
+ */
+static bool PushTaskToRing(HcTaskThread* thread, HcTaskBase* task)
+{
+    uint32_t pos = __atomic_load_n(&thread->pushPos, __ATOMIC_RELAXED);
+    HcTaskSlot* slot = NULL;
+    while (true) {
+        slot = &thread->ring[pos & TASK_RING_MASK];
+        int32_t diff = (int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff < 0) {
+            return false;
+        }
+        if (diff == 0 && __atomic_compare_exchange_n(&thread->pushPos, &pos, pos + 1, true,
+            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            break;
+        }
+        if (diff > 0) {
+            pos = __atomic_load_n(&thread->pushPos, __ATOMIC_RELAXED);
+        }
+    }
+    slot->task = task;
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_SEQ_CST);
+    return true;
+}
+
+static HcTaskBase* PopTaskFromRing(HcTaskThread* thread)
+{
+    uint32_t pos = __atomic_load_n(&thread->popPos, __ATOMIC_RELAXED);
+    HcTaskSlot* slot = NULL;
+    while (true) {
+        slot = &thread->ring[pos & TASK_RING_MASK];
+        int32_t diff = (int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - (pos + 1));
+        if (diff < 0) {
+            return NULL;
+        }
+        if (diff == 0 && __atomic_compare_exchange_n(&thread->popPos, &pos, pos + 1, true,
+            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            break;
+        }
+        if (diff > 0) {
+            pos = __atomic_load_n(&thread->popPos, __ATOMIC_RELAXED);
+        }
+    }
+    HcTaskBase* task = slot->task;
+    __atomic_store_n(&slot->seq, pos + HC_TASK_RING_SIZE, __ATOMIC_RELEASE);
+    return task;
+}
+
+static bool HasPendingTask(HcTaskThread* thread)
+{
+    uint32_t pos = __atomic_load_n(&thread->popPos, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&thread->ring[pos & TASK_RING_MASK].seq, __ATOMIC_SEQ_CST) == pos + 1) {
+        return true;
+    }
+    return __atomic_load_n(&thread->overflowNum, __ATOMIC_SEQ_CST) > 0;
+}
+
 static HcTaskBase* PopTask(HcTaskThread* thread)
 {
     if (thread == NULL) {
         return NULL;
     }
 
+    HcTaskBase* task = PopTaskFromRing(thread);
+    if (task != NULL || __atomic_load_n(&thread->overflowNum, __ATOMIC_SEQ_CST) == 0) {
+        return task;
+    }
+    /* the ring has been drained, the overflowed tasks are the oldest ones left */
     (void)LockHcMutex(&thread->queueLock);
-    HcTaskWrap task;
-    HcBool ret = thread->tasks.popFront(&thread->tasks, &task);
+    HcTaskWrap taskWarp;
+    if (thread->tasks.popFront(&thread->tasks, &taskWarp)) {
+        __atomic_sub_fetch(&thread->overflowNum, 1, __ATOMIC_SEQ_CST);
+        task = taskWarp.task;
+    }
     UnlockHcMutex(&thread->queueLock);
-    if (ret) {
-        return task.task;
+    return task;
+}
+
+static void PushTaskToOverflow(HcTaskThread* thread, HcTaskBase* task)
+{
+    (void)LockHcMutex(&thread->queueLock);
+    HcTaskWrap taskWarp;
+    taskWarp.task = task;
+    if (thread->tasks.pushBack(&thread->tasks, &taskWarp) != NULL) {
+        __atomic_add_fetch(&thread->overflowNum, 1, __ATOMIC_SEQ_CST);
+    } else {
+        LOGE("Failed to push task to overflow queue!");
     }
-    return NULL;
+    UnlockHcMutex(&thread->queueLock);
 }
 
 static void PushTask(struct HcTaskThreadT* thread, HcTaskBase* task)
@@ -45,27 +124,39 @@ static void PushTask(struct HcTaskThreadT* thread, HcTaskBase* task)
         return;
     }
 
-    (void)LockHcMutex(&thread->queueLock);
-    HcTaskWrap taskWarp;
-    taskWarp.task = task;
-    thread->tasks.pushBack(&thread->tasks, &taskWarp);
-    thread->thread.notify(&thread->thread);
-    UnlockHcMutex(&thread->queueLock);
+    /* once a task has overflowed, later ones queue behind it to keep the order */
+    if (__atomic_load_n(&thread->overflowNum, __ATOMIC_SEQ_CST) > 0 || !PushTaskToRing(thread, task)) {
+        PushTaskToOverflow(thread, task);
+    }
+    if (__atomic_exchange_n(&thread->isWaiting, 0, __ATOMIC_SEQ_CST) != 0) {
+        thread->thread.notify(&thread->thread);
+    }
+}
+
+static void DestroyTask(HcTaskBase* task)
+{
+    if (task->destroy) {
+        task->destroy(task);
+    }
+    HcFree(task);
 }
 
 static void Clear(struct HcTaskThreadT* thread)
 {
-    (void)LockHcMutex(&thread->queueLock);
-    HcTaskWrap *taskWarp = NULL;
-    uint32_t index;
-    FOR_EACH_HC_VECTOR(thread->tasks, index, taskWarp) {
-        if (taskWarp->task->destroy) {
-            taskWarp->task->destroy(taskWarp->task);
-        }
-        HcFree(taskWarp->task);
+    HcTaskBase* task = NULL;
+    while ((task = PopTask(thread)) != NULL) {
+        DestroyTask(task);
     }
-    thread->tasks.clear(&thread->tasks);
-    UnlockHcMutex(&thread->queueLock);
+}
+
+static void WaitForTask(HcTaskThread* thread)
+{
+    /* a producer that misses the flag has published its task before, so the check below sees it */
+    __atomic_store_n(&thread->isWaiting, 1, __ATOMIC_SEQ_CST);
+    if (!HasPendingTask(thread)) {
+        thread->thread.wait(&thread->thread);
+    }
+    __atomic_store_n(&thread->isWaiting, 0, __ATOMIC_SEQ_CST);
 }
 
 static void StopAndClear(struct HcTaskThreadT* thread)
@@ -112,12 +203,9 @@ static int TaskThreadLoop(void* args)
             if (task->doAction) {
                 task->doAction(task);
             }
-            if (task->destroy) {
-                task->destroy(task);
-            }
-            HcFree(task);
+            DestroyTask(task);
         } else {
-            thread->thread.wait(&thread->thread);
+            WaitForTask(thread);
         }
     }
     LOGI("task loop finish.");
@@ -143,6 +231,14 @@ int32_t InitHcTaskThread(HcTaskThread* thread, size_t stackSize, const char* thr
         DestroyThread(&thread->thread);
         return res;
     }
+    for (uint32_t i = 0; i < HC_TASK_RING_SIZE; i++) {
+        thread->ring[i].seq = i;
+        thread->ring[i].task = NULL;
+    }
+    thread->pushPos = 0;
+    thread->popPos = 0;
+    thread->overflowNum = 0;
+    thread->isWaiting = 0;
     thread->tasks = CREATE_HC_VECTOR(TaskVec);
     return 0;
 }
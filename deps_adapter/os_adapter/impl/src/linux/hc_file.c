@@ -16,6 +16,7 @@
 #include "hc_file.h"
 #include <dirent.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -192,6 +193,68 @@ void HcFileRemove(const char *path)
     (void)remove(path);
 }
 
+static void SyncParentDirectory(const char *path)
+{
+    const char *lastSlash = strrchr(path, '/');
+    if (lastSlash == NULL || lastSlash == path) {
+        return;
+    }
+    char dirPath[MAX_FOLDER_NAME_SIZE] = { 0 };
+    unsigned long len = (unsigned long)((uintptr_t)lastSlash - (uintptr_t)path);
+    if (len >= MAX_FOLDER_NAME_SIZE || memcpy_s(dirPath, sizeof(dirPath), path, len) != EOK) {
+        LOGW("[OS]: Failed to get parent directory!");
+        return;
+    }
+    int fd = open(dirPath, O_RDONLY | O_DIRECTORY);
+    if (fd < 0) {
+        LOGW("[OS]: open directory fail. [errno]: %" LOG_PUB "d", errno);
+        return;
+    }
+    if (fsync(fd) != 0) {
+        LOGW("[OS]: fsync directory fail. [errno]: %" LOG_PUB "d", errno);
+    }
+    (void)close(fd);
+}
+
+int HcFileRename(const char *srcPath, const char *dstPath)
+{
+    if (srcPath == NULL || dstPath == NULL) {
+        LOGE("Invalid file path");
+        return -1;
+    }
+    if (rename(srcPath, dstPath) != 0) {
+        LOGE("[OS]: rename fail. [errno]: %" LOG_PUB "d", errno);
+        return -1;
+    }
+    /* make the new directory entry durable, otherwise the rename may be lost on power failure */
+    SyncParentDirectory(dstPath);
+    return 0;
+}
+
+char *HcFileMapRead(FileHandle file, int size)
+{
+    FILE *fp = (FILE *)file.pfd;
+    if (fp == NULL || size <= 0) {
+        return NULL;
+    }
+    void *addr = mmap(NULL, (size_t)size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+    if (addr == MAP_FAILED) {
+        LOGW("[OS]: mmap fail. [errno]: %" LOG_PUB "d", errno);
+        return NULL;
+    }
+    return (char *)addr;
+}
+
+void HcFileUnmap(char *addr, uint32_t size)
+{
+    if (addr == NULL || size == 0) {
+        return;
+    }
+    if (munmap(addr, size) != 0) {
+        LOGW("[OS]: munmap fail. [errno]: %" LOG_PUB "d", errno);
+    }
+}
+
 void HcFileGetSubFileName(const char *path, StringVector *nameVec)
 {
     DIR *dir = NULL;
@@ -111,6 +111,31 @@ void HcFileRemove(const char *path)
     LOGI("File delete result:%" LOG_PUB "d", ret);
 }
 
+int HcFileRename(const char *srcPath, const char *dstPath)
+{
+    if (srcPath == NULL || dstPath == NULL) {
+        LOGE("Invalid file path");
+        return HAL_FAILED;
+    }
+    int ret = UtilsFileMove(srcPath, dstPath);
+    LOGI("File rename result:%" LOG_PUB "d", ret);
+    return (ret == 0) ? HAL_SUCCESS : HAL_FAILED;
+}
+
+char *HcFileMapRead(FileHandle file, int size)
+{
+    /* file mapping is not supported on the liteOS device, the content has to be read */
+    (void)file;
+    (void)size;
+    return NULL;
+}
+
+void HcFileUnmap(char *addr, uint32_t size)
+{
+    (void)addr;
+    (void)size;
+}
+
 void HcFileGetSubFileName(const char *path, StringVector *nameVec)
 {
     /* Since the liteOS device does not support retrieving files in the directory, the default file is used. */
@@ -193,6 +193,34 @@ void HcFileRemove(const char *path)
     }
 }
 
+int HcFileRename(const char *srcPath, const char *dstPath)
+{
+    if (srcPath == NULL || dstPath == NULL) {
+        LOGE("Invalid file path");
+        return -1;
+    }
+    int res = rename(srcPath, dstPath);
+    if (res != 0) {
+        LOGW("[OS]: rename file fail. [Res]: %" LOG_PUB "d", res);
+        return -1;
+    }
+    return 0;
+}
+
+char *HcFileMapRead(FileHandle file, int size)
+{
+    /* file mapping is not supported on the liteOS device, the content has to be read */
+    (void)file;
+    (void)size;
+    return NULL;
+}
+
+void HcFileUnmap(char *addr, uint32_t size)
+{
+    (void)addr;
+    (void)size;
+}
+
 void HcFileGetSubFileName(const char *path, StringVector *nameVec)
 {
     DIR *dir = NULL;
@@ -30,9 +30,22 @@ typedef struct {
 
 DECLARE_HC_VECTOR(TaskVec, HcTaskWrap)
 
+/* capacity of the lock-free task ring, must be a power of two */
+#define HC_TASK_RING_SIZE 32
+
+typedef struct {
+    uint32_t seq;
+    HcTaskBase* task;
+} HcTaskSlot;
+
 typedef struct HcTaskThreadT {
     HcThread thread;
-    TaskVec tasks;
+    HcTaskSlot ring[HC_TASK_RING_SIZE];
+    uint32_t pushPos;
+    uint32_t popPos;
+    uint32_t overflowNum;
+    uint32_t isWaiting;
+    TaskVec tasks; /* overflow queue, only used while the ring is full, guarded by queueLock */
     int32_t (*startThread)(struct HcTaskThreadT* thread);
     void (*pushTask) (struct HcTaskThreadT* thread, HcTaskBase* task);
     void (*clear) (struct HcTaskThreadT* thread);
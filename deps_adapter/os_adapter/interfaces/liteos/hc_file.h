@@ -42,6 +42,10 @@ int HcFileRead(FileHandle file, void *dst, int dstSize);
 int HcFileWrite(FileHandle file, const void *src, int srcSize);
 void HcFileClose(FileHandle file);
 void HcFileRemove(const char *path);
+int HcFileRename(const char *srcPath, const char *dstPath);
+/* returns NULL if the file can not be mapped, the caller should fall back to HcFileRead */
+char *HcFileMapRead(FileHandle file, int size);
+void HcFileUnmap(char *addr, uint32_t size);
 void HcFileGetSubFileName(const char *path, StringVector *nameVec);
 
 #ifdef __cplusplus
@@ -18,6 +18,7 @@
 
 #include <stdbool.h>
 #include "hc_string_vector.h"
+#include "hc_task_thread.h"
 #include "json_utils.h"
 
 #define MAX_STRING_LEN 256
@@ -76,7 +77,12 @@ int32_t AddCredToDb(int32_t osAccountId, const Credential *credential);
 int32_t DelCredential(int32_t osAccountId, const QueryCredentialParams *delParams);
 int32_t QueryCredentials(int32_t osAccountId, const QueryCredentialParams *queryParams,
     CredentialVec *vec);
+/*
+ * Once a flush scheduler is set, SaveOsAccountCredDb only marks the database dirty and the write is
+ * deferred to a single flush task. Without a scheduler the database is saved synchronously.
+ */
 int32_t SaveOsAccountCredDb(int32_t osAccountId);
+void SetCredDbFlushScheduler(int32_t (*pushTask)(HcTaskBase *task));
 
 Credential *DeepCopyCredential(const Credential *credential);
 
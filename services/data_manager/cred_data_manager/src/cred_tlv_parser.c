@@ -382,11 +382,19 @@ int64_t ParseCredTlvString(CredTlvBase *tlv, HcParcel *parcel, HcBool strict)
     (void)strict;
     CredTlvString *realTlv = (CredTlvString *)(tlv);
     ClearParcel(&realTlv->data.parcel);
-    if (tlv->length == 0 || ParcelReadParcel(parcel, &realTlv->data.parcel, tlv->length, HC_FALSE)) {
+    if (tlv->length == 0) {
         return tlv->length;
-    } else {
+    }
+    if (!ParcelReadParcel(parcel, &realTlv->data.parcel, tlv->length, HC_FALSE)) {
+        return CRED_TLV_FAIL;
+    }
+    /* the string is used in place, so it must carry its own terminator */
+    const char *lastChar = GetParcelLastChar(&realTlv->data.parcel);
+    if (lastChar == NULL || *lastChar != '\0') {
+        ClearParcel(&realTlv->data.parcel);
         return CRED_TLV_FAIL;
     }
+    return tlv->length;
 }
 
 int64_t GetlenCredTlvString(CredTlvBase *tlv)
@@ -20,10 +20,11 @@
 #include "hc_dev_info.h"
 #include "hc_file.h"
 #include "hc_log.h"
-#include "hc_mutex.h"
+#include "hc_rwlock.h"
 #include "hc_types.h"
 #include "securec.h"
 #include "hidump_adapter.h"
+#include "hisysevent_adapter.h"
 #include "os_account_adapter.h"
 #include "security_label_adapter.h"
 #include "account_task_manager.h"
@@ -93,14 +94,20 @@ IMPLEMENT_HC_VECTOR(CredentialVec, Credential*, 1)
 typedef struct {
     int32_t osAccountId;
     CredentialVec credentials;
+    bool isDirty; /* modified in memory, waiting for the deferred flush */
 } OsAccountCredInfo;
 
 DECLARE_HC_VECTOR(DevAuthCredDb, OsAccountCredInfo)
 IMPLEMENT_HC_VECTOR(DevAuthCredDb, OsAccountCredInfo, 1)
 
 #define MAX_DB_PATH_LEN 256
+#define MAX_FLUSH_RETRY_NUM 3
 
-static HcMutex *g_credMutex = NULL;
+static HcRwLock *g_credLock = NULL;
+static int32_t (*g_pushFlushTask)(HcTaskBase *task) = NULL;
+static bool g_isFlushTaskPending = false;
+static uint32_t g_coalescedSaveNum = 0;
+static uint32_t g_flushRetryNum = 0;
 static DevAuthCredDb g_devauthCredDb;
 const uint8_t DEFAULT_CRED_PARAM_VAL = 0;
 
@@ -357,6 +364,12 @@ static bool ReadCredInfoFromParcel(HcParcel *parcel, OsAccountCredInfo *info)
     return ret;
 }
 
+static void FreeFileData(char *data, uint32_t length)
+{
+    (void)length;
+    HcFree(data);
+}
+
 static bool ReadParcelFromFile(const char *filePath, HcParcel *parcel)
 {
     FileHandle file;
@@ -372,7 +385,14 @@ static bool ReadParcelFromFile(const char *filePath, HcParcel *parcel)
         HcFileClose(file);
         return false;
     }
-    char *fileData = (char *)HcMalloc(fileSize, 0);
+    /* decode straight from the mapped file, the mapping stays valid after the file is closed */
+    char *fileData = HcFileMapRead(file, fileSize);
+    if (fileData != NULL) {
+        HcFileClose(file);
+        *parcel = CreateReadOnlyParcel(fileData, (uint32_t)fileSize, HcFileUnmap);
+        return true;
+    }
+    fileData = (char *)HcMalloc(fileSize, 0);
     if (fileData == NULL) {
         LOGE("[CRED#DB]: Failed to allocate fileData memory!");
         HcFileClose(file);
@@ -385,12 +405,7 @@ static bool ReadParcelFromFile(const char *filePath, HcParcel *parcel)
         return false;
     }
     HcFileClose(file);
-    if (!ParcelWrite(parcel, fileData, fileSize)) {
-        LOGE("[CRED#DB]: parcel write error!");
-        HcFree(fileData);
-        return false;
-    }
-    HcFree(fileData);
+    *parcel = CreateReadOnlyParcel(fileData, (uint32_t)fileSize, FreeFileData);
     return true;
 }
 
@@ -415,6 +430,42 @@ static bool SaveParcelToFile(const char *filePath, HcParcel *parcel)
     }
 }
 
+static bool SaveCredInfoToParcel(const OsAccountCredInfo *info, HcParcel *parcel);
+
+static int32_t SaveCredInfoToFile(OsAccountCredInfo *info)
+{
+    HcParcel parcel = CreateParcel(0, 0);
+    if (!SaveCredInfoToParcel(info, &parcel)) {
+        DeleteParcel(&parcel);
+        return IS_ERR_MEMORY_COPY;
+    }
+    char filePath[MAX_DB_PATH_LEN] = { 0 };
+    if (!GetOsAccountCredInfoPath(info->osAccountId, filePath, MAX_DB_PATH_LEN)) {
+        DeleteParcel(&parcel);
+        return IS_ERR_CONVERT_FAILED;
+    }
+    if (!SaveParcelToFile(filePath, &parcel)) {
+        DeleteParcel(&parcel);
+        return IS_ERR_MEMORY_COPY;
+    }
+    DeleteParcel(&parcel);
+    info->isDirty = false;
+    LOGI("[CRED#DB]: Save an os account cred database successfully! [Id]: %" LOG_PUB "d", info->osAccountId);
+    return IS_SUCCESS;
+}
+
+static void FlushOsAccountCredInfo(int32_t osAccountId)
+{
+    uint32_t index;
+    OsAccountCredInfo *info;
+    FOR_EACH_HC_VECTOR(g_devauthCredDb, index, info) {
+        if (info != NULL && info->osAccountId == osAccountId && info->isDirty) {
+            (void)SaveCredInfoToFile(info);
+            return;
+        }
+    }
+}
+
 static void LoadOsAccountCredDb(int32_t osAccountId)
 {
     char filePath[MAX_DB_PATH_LEN] = { 0 };
@@ -430,6 +481,7 @@ static void LoadOsAccountCredDb(int32_t osAccountId)
     OsAccountCredInfo info;
     info.osAccountId = osAccountId;
     info.credentials = CreateCredentialVec();
+    info.isDirty = false;
     if (!ReadCredInfoFromParcel(&parcel, &info)) {
         DestroyCredentialVec(&info.credentials);
         DeleteParcel(&parcel);
@@ -460,30 +512,37 @@ static void RemoveOsAccountCredInfo(int32_t osAccountId)
 
 static void OnOsAccountUnlocked(int32_t osAccountId)
 {
-    (void)LockHcMutex(g_credMutex);
+    (void)WriteLockHcRwLock(g_credLock);
+    /* the cache is about to be replaced by the file content, persist the pending changes first */
+    FlushOsAccountCredInfo(osAccountId);
     RemoveOsAccountCredInfo(osAccountId);
     LoadOsAccountCredDb(osAccountId);
-    UnlockHcMutex(g_credMutex);
+    UnlockHcRwLock(g_credLock);
 }
 
 static void OnOsAccountRemoved(int32_t osAccountId)
 {
     LOGI("[CRED#DB]: os account is removed, osAccountId: %" LOG_PUB "d", osAccountId);
-    (void)LockHcMutex(g_credMutex);
+    (void)WriteLockHcRwLock(g_credLock);
     RemoveOsAccountCredInfo(osAccountId);
-    UnlockHcMutex(g_credMutex);
+    UnlockHcRwLock(g_credLock);
 }
 
-static bool IsOsAccountCredDataLoaded(int32_t osAccountId)
+static OsAccountCredInfo *FindLoadedCredInfo(int32_t osAccountId)
 {
     uint32_t index = 0;
     OsAccountCredInfo *info = NULL;
     FOR_EACH_HC_VECTOR(g_devauthCredDb, index, info) {
         if (info != NULL && info->osAccountId == osAccountId) {
-            return true;
+            return info;
         }
     }
-    return false;
+    return NULL;
+}
+
+static bool IsOsAccountCredDataLoaded(int32_t osAccountId)
+{
+    return FindLoadedCredInfo(osAccountId) != NULL;
 }
 
 static void LoadDataIfNotLoaded(int32_t osAccountId)
@@ -511,6 +570,7 @@ static OsAccountCredInfo *GetCredInfoByOsAccountId(int32_t osAccountId)
     OsAccountCredInfo newInfo;
     newInfo.osAccountId = osAccountId;
     newInfo.credentials = CreateCredentialVec();
+    newInfo.isDirty = false;
     OsAccountCredInfo *returnInfo = g_devauthCredDb.pushBackT(&g_devauthCredDb, newInfo);
     if (returnInfo == NULL) {
         LOGE("[CRED#DB]: Failed to push osAccountInfo to database!");
@@ -519,12 +579,25 @@ static OsAccountCredInfo *GetCredInfoByOsAccountId(int32_t osAccountId)
     return returnInfo;
 }
 
+/* Queries on a cached os account share the read lock, loading the cache of a new os account needs the write lock. */
+static OsAccountCredInfo *LockCredInfoForRead(int32_t osAccountId)
+{
+    (void)ReadLockHcRwLock(g_credLock);
+    OsAccountCredInfo *info = FindLoadedCredInfo(osAccountId);
+    if (info != NULL) {
+        return info;
+    }
+    UnlockHcRwLock(g_credLock);
+    (void)WriteLockHcRwLock(g_credLock);
+    return GetCredInfoByOsAccountId(osAccountId);
+}
+
 static void LoadDevAuthCredDb(void)
 {
     if (IsOsAccountSupported()) {
         return;
     }
-    (void)LockHcMutex(g_credMutex);
+    (void)WriteLockHcRwLock(g_credLock);
     StringVector osAccountDbNameVec = CreateStrVector();
     HcFileGetSubFileName(GetStorageDirPath(), &osAccountDbNameVec);
     uint32_t index;
@@ -542,7 +615,7 @@ static void LoadDevAuthCredDb(void)
         }
     }
     DestroyStrVector(&osAccountDbNameVec);
-    UnlockHcMutex(g_credMutex);
+    UnlockHcRwLock(g_credLock);
 }
 
 static bool SetCredentialElement(TlvCredentialElement *element, Credential *entry)
@@ -1177,15 +1250,15 @@ static void DeleteCredRelation(int32_t osAccountId, const char *subProfileIdStr,
 
 static int32_t AddCredToDbInner(int32_t osAccountId, const char *subProfileIdStr, const Credential *entry)
 {
-    (void)LockHcMutex(g_credMutex);
+    (void)WriteLockHcRwLock(g_credLock);
     OsAccountCredInfo *info = GetCredInfoByOsAccountId(osAccountId);
     if (info == NULL) {
-        UnlockHcMutex(g_credMutex);
+        UnlockHcRwLock(g_credLock);
         return IS_ERR_INVALID_PARAMS;
     }
     Credential *newEntry = DeepCopyCredential(entry);
     if (newEntry == NULL) {
-        UnlockHcMutex(g_credMutex);
+        UnlockHcRwLock(g_credLock);
         return IS_ERR_MEMORY_COPY;
     }
     QueryCredentialParams params = InitQueryCredentialParams();
@@ -1198,13 +1271,13 @@ static int32_t AddCredToDbInner(int32_t osAccountId, const char *subProfileIdStr
     #ifdef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
         AddCredRelation(osAccountId, subProfileIdStr, StringGet(&newEntry->credId));
     #endif
-        UnlockHcMutex(g_credMutex);
+        UnlockHcRwLock(g_credLock);
         LOGI("[CRED#DB]: Update an old credential successfully! [credType]: %" LOG_PUB "u", entry->credType);
         return IS_SUCCESS;
     }
     if (info->credentials.pushBackT(&info->credentials, newEntry) == NULL) {
         DestroyCredential(newEntry);
-        UnlockHcMutex(g_credMutex);
+        UnlockHcRwLock(g_credLock);
         LOGE("[CRED#DB]: Failed to push credential to vec!");
         return IS_ERR_MEMORY_COPY;
     }
@@ -1212,7 +1285,7 @@ static int32_t AddCredToDbInner(int32_t osAccountId, const char *subProfileIdStr
 #ifdef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
     AddCredRelation(osAccountId, subProfileIdStr, StringGet(&newEntry->credId));
 #endif
-    UnlockHcMutex(g_credMutex);
+    UnlockHcRwLock(g_credLock);
     LOGI("[CRED#DB]: Add a credential to database successfully! [credType]: %" LOG_PUB "u", entry->credType);
     return IS_SUCCESS;
 }
@@ -1241,10 +1314,10 @@ static int32_t DelCredentialInner(int32_t osAccountId, const char *subProfileIdS
 #ifndef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
     (void)shouldPostInactive;
 #endif
-    (void)LockHcMutex(g_credMutex);
+    (void)WriteLockHcRwLock(g_credLock);
     OsAccountCredInfo *info = GetCredInfoByOsAccountId(osAccountId);
     if (info == NULL) {
-        UnlockHcMutex(g_credMutex);
+        UnlockHcRwLock(g_credLock);
         return IS_ERR_INVALID_PARAMS;
     }
     int32_t count = 0;
@@ -1272,7 +1345,7 @@ static int32_t DelCredentialInner(int32_t osAccountId, const char *subProfileIdS
         DestroyCredential(popEntry);
         count++;
     }
-    UnlockHcMutex(g_credMutex);
+    UnlockHcRwLock(g_credLock);
     LOGI("[CRED#DB]: Number of credentials deleted: %" LOG_PUB "d", count);
     return IS_SUCCESS;
 }
@@ -1302,10 +1375,9 @@ static int32_t QueryCredentialsInner(int32_t osAccountId, bool isProfileDelete,
     (void)subProfileIdStr;
     (void)isProfileDelete;
 #endif
-    (void)LockHcMutex(g_credMutex);
-    OsAccountCredInfo *info = GetCredInfoByOsAccountId(osAccountId);
+    OsAccountCredInfo *info = LockCredInfoForRead(osAccountId);
     if (info == NULL) {
-        UnlockHcMutex(g_credMutex);
+        UnlockHcRwLock(g_credLock);
         return IS_ERR_INVALID_PARAMS;
     }
     uint32_t index;
@@ -1329,7 +1401,7 @@ static int32_t QueryCredentialsInner(int32_t osAccountId, bool isProfileDelete,
             DestroyCredential(newEntry);
         }
     }
-    UnlockHcMutex(g_credMutex);
+    UnlockHcRwLock(g_credLock);
     return IS_SUCCESS;
 }
 
@@ -1350,37 +1422,122 @@ int32_t QueryCredentials(int32_t osAccountId, const QueryCredentialParams *param
     return QueryCredentialsInner(osAccountId, false, subProfileIdStr, params, vec);
 }
 
+static int32_t FlushAllCredInfo(void)
+{
+    int32_t res = IS_SUCCESS;
+    (void)WriteLockHcRwLock(g_credLock);
+    g_isFlushTaskPending = false;
+    uint32_t index;
+    OsAccountCredInfo *info;
+    FOR_EACH_HC_VECTOR(g_devauthCredDb, index, info) {
+        if (info == NULL || !info->isDirty) {
+            continue;
+        }
+        int32_t saveRes = SaveCredInfoToFile(info);
+        if (saveRes != IS_SUCCESS) {
+            LOGE("[CRED#DB]: Failed to flush an os account cred database! [Id]: %" LOG_PUB "d", info->osAccountId);
+            res = saveRes;
+        }
+    }
+    UnlockHcRwLock(g_credLock);
+    return res;
+}
+
+static int32_t PushFlushTask(void);
+
+/*
+ * The caller got success when the save was deferred, so a failed flush is queued again behind the work
+ * pushed in the meantime. Once the retries are used up the failure is reported and the data stays dirty,
+ * the next save or the flush on destroy writes it.
+ */
+static void RetryFlushTask(int32_t res)
+{
+    if (g_flushRetryNum >= MAX_FLUSH_RETRY_NUM) {
+        LOGE("[CRED#DB]: Failed to flush the cred database after retries! [Res]: %" LOG_PUB "d", res);
+        DEV_AUTH_REPORT_FAULT_EVENT_WITH_ERR_CODE(FLUSH_DATABASE_EVENT, PROCESS_FLUSH_DATABASE, res);
+        g_flushRetryNum = 0;
+        return;
+    }
+    g_flushRetryNum++;
+    (void)WriteLockHcRwLock(g_credLock);
+    bool shouldPushTask = !g_isFlushTaskPending;
+    g_isFlushTaskPending = true;
+    UnlockHcRwLock(g_credLock);
+    if (shouldPushTask && PushFlushTask() != IS_SUCCESS) {
+        LOGE("[CRED#DB]: Failed to push the flush retry task!");
+        (void)WriteLockHcRwLock(g_credLock);
+        g_isFlushTaskPending = false;
+        UnlockHcRwLock(g_credLock);
+    }
+}
+
+static void DoFlushTask(HcTaskBase *task)
+{
+    (void)task;
+    if (g_credLock == NULL) {
+        return;
+    }
+    int32_t res = FlushAllCredInfo();
+    if (res == IS_SUCCESS) {
+        g_flushRetryNum = 0;
+        return;
+    }
+    RetryFlushTask(res);
+}
+
+static void DestroyFlushTask(HcTaskBase *task)
+{
+    (void)task;
+}
+
+static int32_t PushFlushTask(void)
+{
+    HcTaskBase *task = (HcTaskBase *)HcMalloc(sizeof(HcTaskBase), 0);
+    if (task == NULL) {
+        LOGE("[CRED#DB]: Failed to allocate flush task!");
+        return IS_ERR_ALLOC_MEMORY;
+    }
+    task->doAction = DoFlushTask;
+    task->destroy = DestroyFlushTask;
+    int32_t res = g_pushFlushTask(task);
+    if (res != IS_SUCCESS) {
+        HcFree(task);
+    }
+    return res;
+}
+
 int32_t SaveOsAccountCredDb(int32_t osAccountId)
 {
-    (void)LockHcMutex(g_credMutex);
+    (void)WriteLockHcRwLock(g_credLock);
     OsAccountCredInfo *info = GetCredInfoByOsAccountId(osAccountId);
     if (info == NULL) {
-        UnlockHcMutex(g_credMutex);
+        UnlockHcRwLock(g_credLock);
         return IS_ERR_INVALID_PARAMS;
     }
-    HcParcel parcel = CreateParcel(0, 0);
-    if (!SaveCredInfoToParcel(info, &parcel)) {
-        DeleteParcel(&parcel);
-        UnlockHcMutex(g_credMutex);
-        return IS_ERR_MEMORY_COPY;
+    if (g_pushFlushTask == NULL) {
+        int32_t res = SaveCredInfoToFile(info);
+        UnlockHcRwLock(g_credLock);
+        return res;
     }
-    char filePath[MAX_DB_PATH_LEN] = { 0 };
-    if (!GetOsAccountCredInfoPath(osAccountId, filePath, MAX_DB_PATH_LEN)) {
-        DeleteParcel(&parcel);
-        UnlockHcMutex(g_credMutex);
-        return IS_ERR_CONVERT_FAILED;
+    if (info->isDirty) {
+        g_coalescedSaveNum++;
     }
-    if (!SaveParcelToFile(filePath, &parcel)) {
-        DeleteParcel(&parcel);
-        UnlockHcMutex(g_credMutex);
-        return IS_ERR_MEMORY_COPY;
+    info->isDirty = true;
+    bool shouldPushTask = !g_isFlushTaskPending;
+    g_isFlushTaskPending = true;
+    UnlockHcRwLock(g_credLock);
+    if (shouldPushTask && PushFlushTask() != IS_SUCCESS) {
+        LOGW("[CRED#DB]: Failed to defer the flush, save the database synchronously!");
+        return FlushAllCredInfo();
     }
-    DeleteParcel(&parcel);
-    UnlockHcMutex(g_credMutex);
-    LOGI("[CRED#DB]: Save an os account cred database successfully! [Id]: %" LOG_PUB "d", osAccountId);
     return IS_SUCCESS;
 }
 
+void SetCredDbFlushScheduler(int32_t (*pushTask)(HcTaskBase *task))
+{
+    g_pushFlushTask = pushTask;
+}
+
 #ifdef DEV_AUTH_HIVIEW_ENABLE
 static void DumpCredential(int fd, const Credential *credential)
 {
@@ -1444,11 +1601,11 @@ static void LoadAllAccountsData(void)
 
 static void DevAuthDataBaseDump(int fd)
 {
-    if (g_credMutex == NULL) {
-        LOGE("[CRED#DB]: Init mutex failed");
+    if (g_credLock == NULL) {
+        LOGE("[CRED#DB]: Init lock failed");
         return;
     }
-    (void)LockHcMutex(g_credMutex);
+    (void)WriteLockHcRwLock(g_credLock);
     if (IsOsAccountSupported()) {
         LoadAllAccountsData();
     }
@@ -1460,7 +1617,8 @@ static void DevAuthDataBaseDump(int fd)
         }
         DumpDb(fd, info);
     }
-    UnlockHcMutex(g_credMutex);
+    dprintf(fd, "|%-13s = %-66u|\n", "savedFsyncs", g_coalescedSaveNum);
+    UnlockHcRwLock(g_credLock);
 }
 #endif
 
@@ -1503,16 +1661,16 @@ static void OnSubProfileDeleted(int32_t osAccountId, const char *subProfileIdStr
 
 int32_t InitCredDatabase(void)
 {
-    if (g_credMutex == NULL) {
-        g_credMutex = (HcMutex *)HcMalloc(sizeof(HcMutex), 0);
-        if (g_credMutex == NULL) {
-            LOGE("[CRED#DB]: Alloc cred databaseMutex failed");
+    if (g_credLock == NULL) {
+        g_credLock = (HcRwLock *)HcMalloc(sizeof(HcRwLock), 0);
+        if (g_credLock == NULL) {
+            LOGE("[CRED#DB]: Alloc cred database lock failed");
             return IS_ERR_ALLOC_MEMORY;
         }
-        if (InitHcMutex(g_credMutex, false) != IS_SUCCESS) {
-            LOGE("[CRED#DB]: Init mutex failed");
-            HcFree(g_credMutex);
-            g_credMutex = NULL;
+        if (InitHcRwLock(g_credLock) != IS_SUCCESS) {
+            LOGE("[CRED#DB]: Init rwlock failed");
+            HcFree(g_credLock);
+            g_credLock = NULL;
             return IS_ERR_INIT_FAILED;
         }
     }
@@ -1534,7 +1692,9 @@ void DestroyCredDatabase(void)
     SetCredRelationChangeCallback(NULL);
     SetProfileDeleteCallbackForCred(NULL);
 #endif
-    (void)LockHcMutex(g_credMutex);
+    g_pushFlushTask = NULL;
+    (void)FlushAllCredInfo();
+    (void)WriteLockHcRwLock(g_credLock);
     uint32_t index;
     OsAccountCredInfo *info;
     FOR_EACH_HC_VECTOR(g_devauthCredDb, index, info) {
@@ -1544,8 +1704,8 @@ void DestroyCredDatabase(void)
         ClearCredentialVec(&info->credentials);
     }
     DESTROY_HC_VECTOR(DevAuthCredDb, &g_devauthCredDb);
-    UnlockHcMutex(g_credMutex);
-    DestroyHcMutex(g_credMutex);
-    HcFree(g_credMutex);
-    g_credMutex = NULL;
+    UnlockHcRwLock(g_credLock);
+    DestroyHcRwLock(g_credLock);
+    HcFree(g_credLock);
+    g_credLock = NULL;
 }
\ No newline at end of file
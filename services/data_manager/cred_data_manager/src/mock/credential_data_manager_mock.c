@@ -87,6 +87,11 @@ int32_t SaveOsAccountCredDb(int32_t osAccountId)
     return IS_ERR_NOT_SUPPORT;
 }
 
+void SetCredDbFlushScheduler(int32_t (*pushTask)(HcTaskBase *task))
+{
+    (void)pushTask;
+}
+
 int32_t InitCredDatabase(void)
 {
     return IS_ERR_NOT_SUPPORT;
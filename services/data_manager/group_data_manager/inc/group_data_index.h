@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GROUP_DATA_INDEX_H
+#define GROUP_DATA_INDEX_H
+
+#include "group_data_manager.h"
+
+typedef enum {
+    DEVICE_INDEX_UDID = 0,
+    DEVICE_INDEX_AUTH_ID,
+    DEVICE_INDEX_GROUP_ID,
+    DEVICE_INDEX_GROUP_UDID,
+    DEVICE_INDEX_TYPE_NUM
+} DeviceIndexType;
+
+typedef struct TrustedIndexNodeT {
+    struct TrustedIndexNodeT *next;
+    uint32_t hash;
+    uint32_t seq; /* insertion order of the entry, chains are sorted by it to keep the vector order */
+    void *entry;
+} TrustedIndexNode;
+
+typedef struct {
+    TrustedIndexNode **buckets;
+    uint32_t bucketNum;
+    uint32_t count;
+} TrustedIndexTable;
+
+typedef struct {
+    TrustedIndexTable groupIndex; /* key: groupId */
+    TrustedIndexTable deviceIndex[DEVICE_INDEX_TYPE_NUM];
+    uint32_t nextSeq;
+} TrustedDataIndex;
+
+typedef struct {
+    const TrustedIndexNode *node;
+    uint32_t hash;
+} TrustedIndexIter;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void InitTrustedDataIndex(TrustedDataIndex *index);
+void DestroyTrustedDataIndex(TrustedDataIndex *index);
+
+bool AddGroupToIndex(TrustedDataIndex *index, TrustedGroupEntry *entry);
+void RemoveGroupFromIndex(TrustedDataIndex *index, const TrustedGroupEntry *entry);
+void ReplaceGroupInIndex(TrustedDataIndex *index, const TrustedGroupEntry *oldEntry, TrustedGroupEntry *newEntry);
+TrustedGroupEntry *FindGroupInIndex(const TrustedDataIndex *index, const char *groupId);
+
+bool AddDeviceToIndex(TrustedDataIndex *index, TrustedDeviceEntry *entry);
+void RemoveDeviceFromIndex(TrustedDataIndex *index, const TrustedDeviceEntry *entry);
+void ReplaceDeviceInIndex(TrustedDataIndex *index, const TrustedDeviceEntry *oldEntry, TrustedDeviceEntry *newEntry);
+TrustedDeviceEntry *FindDeviceInIndex(const TrustedDataIndex *index, const char *groupId, const char *udid);
+
+/*
+ * Select the most selective index for the query params and position the iterator on its chain.
+ * Returns false if none of the indexed fields is set, the caller should fall back to a full scan.
+ * The iterator only narrows down the candidates, the caller still has to compare the query params.
+ */
+bool BeginDeviceIndexIter(const TrustedDataIndex *index, const QueryDeviceParams *params, TrustedIndexIter *iter);
+TrustedDeviceEntry *NextIndexedDevice(TrustedIndexIter *iter);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
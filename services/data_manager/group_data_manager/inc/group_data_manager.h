@@ -19,6 +19,7 @@
 #include <stdbool.h>
 #include "hc_string.h"
 #include "hc_string_vector.h"
+#include "hc_task_thread.h"
 #include "hc_tlv_parser.h"
 #include "hc_vector.h"
 #include "json_utils.h"
@@ -75,6 +76,14 @@ typedef struct {
     const char *userId;
 } QueryDeviceParams;
 
+/*
+ * Visitors borrow the entries stored in the database and are invoked with the database lock held.
+ * They must not keep the entry pointer after returning or call back into the database.
+ * Return false to stop the traversal.
+ */
+typedef bool (*GroupEntryVisitor)(const TrustedGroupEntry *entry, void *ctx);
+typedef bool (*DeviceEntryVisitor)(const TrustedDeviceEntry *entry, void *ctx);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -89,7 +98,14 @@ int32_t AddTrustedDevice(int32_t osAccountId, const TrustedDeviceEntry *deviceEn
 int32_t DelTrustedDevice(int32_t osAccountId, const QueryDeviceParams *params);
 int32_t QueryGroups(int32_t osAccountId, const QueryGroupParams *params, GroupEntryVec *vec);
 int32_t QueryDevices(int32_t osAccountId, const QueryDeviceParams *params, DeviceEntryVec *vec);
+int32_t VisitGroups(int32_t osAccountId, const QueryGroupParams *params, GroupEntryVisitor visitor, void *ctx);
+int32_t VisitDevices(int32_t osAccountId, const QueryDeviceParams *params, DeviceEntryVisitor visitor, void *ctx);
+/*
+ * Once a flush scheduler is set, SaveOsAccountDb only marks the database dirty and the write is
+ * deferred to a single flush task. Without a scheduler the database is saved synchronously.
+ */
 int32_t SaveOsAccountDb(int32_t osAccountId);
+void SetGroupDbFlushScheduler(int32_t (*pushTask)(HcTaskBase *task));
 bool GenerateGroupEntryFromEntry(const TrustedGroupEntry *entry, TrustedGroupEntry *returnEntry);
 bool GenerateDeviceEntryFromEntry(const TrustedDeviceEntry *entry, TrustedDeviceEntry *returnEntry);
 
@@ -0,0 +1,330 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "group_data_index.h"
+
+#include "hc_log.h"
+#include "hc_types.h"
+#include "string_util.h"
+
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME 16777619U
+#define INDEX_INIT_BUCKET_NUM 16
+#define INDEX_MAX_BUCKET_NUM (1U << 16)
+#define INDEX_MAX_LOAD_FACTOR 2
+
+static uint32_t HashStep(uint32_t hash, const char *str)
+{
+    if (str == NULL) {
+        return hash;
+    }
+    while (*str != '\0') {
+        hash ^= (uint8_t)(*str);
+        hash *= FNV_PRIME;
+        str++;
+    }
+    return hash;
+}
+
+static uint32_t HashKey(const char *key)
+{
+    return HashStep(FNV_OFFSET_BASIS, key);
+}
+
+static uint32_t HashPairKey(const char *first, const char *second)
+{
+    /* mix in a separator so that ("ab", "c") and ("a", "bc") do not collide systematically */
+    uint32_t hash = HashStep(FNV_OFFSET_BASIS, first) * FNV_PRIME;
+    return HashStep(hash, second);
+}
+
+static uint32_t GetDeviceKeyHash(DeviceIndexType type, const TrustedDeviceEntry *entry)
+{
+    switch (type) {
+        case DEVICE_INDEX_UDID:
+            return HashKey(StringGet(&entry->udid));
+        case DEVICE_INDEX_AUTH_ID:
+            return HashKey(StringGet(&entry->authId));
+        case DEVICE_INDEX_GROUP_ID:
+            return HashKey(StringGet(&entry->groupId));
+        default:
+            return HashPairKey(StringGet(&entry->groupId), StringGet(&entry->udid));
+    }
+}
+
+static uint32_t GetBucketIndex(const TrustedIndexTable *table, uint32_t hash)
+{
+    return hash & (table->bucketNum - 1);
+}
+
+static void LinkNode(TrustedIndexTable *table, TrustedIndexNode *node)
+{
+    TrustedIndexNode **pos = &table->buckets[GetBucketIndex(table, node->hash)];
+    while ((*pos != NULL) && ((*pos)->seq < node->seq)) {
+        pos = &(*pos)->next;
+    }
+    node->next = *pos;
+    *pos = node;
+}
+
+static bool ResizeTable(TrustedIndexTable *table, uint32_t newBucketNum)
+{
+    TrustedIndexNode **newBuckets = (TrustedIndexNode **)HcMalloc(newBucketNum * sizeof(TrustedIndexNode *), 0);
+    if (newBuckets == NULL) {
+        LOGE("[DB]: Failed to allocate index buckets!");
+        return false;
+    }
+    TrustedIndexNode **oldBuckets = table->buckets;
+    uint32_t oldBucketNum = table->bucketNum;
+    table->buckets = newBuckets;
+    table->bucketNum = newBucketNum;
+    for (uint32_t i = 0; i < oldBucketNum; i++) {
+        TrustedIndexNode *node = oldBuckets[i];
+        while (node != NULL) {
+            TrustedIndexNode *next = node->next;
+            LinkNode(table, node);
+            node = next;
+        }
+    }
+    HcFree(oldBuckets);
+    return true;
+}
+
+static bool InsertNode(TrustedIndexTable *table, uint32_t hash, uint32_t seq, void *entry)
+{
+    if (table->buckets == NULL) {
+        if (!ResizeTable(table, INDEX_INIT_BUCKET_NUM)) {
+            return false;
+        }
+    } else if ((table->count >= table->bucketNum * INDEX_MAX_LOAD_FACTOR) &&
+        (table->bucketNum < INDEX_MAX_BUCKET_NUM)) {
+        /* a failed expansion only costs longer chains, the table stays usable */
+        (void)ResizeTable(table, table->bucketNum * 2);
+    }
+    TrustedIndexNode *node = (TrustedIndexNode *)HcMalloc(sizeof(TrustedIndexNode), 0);
+    if (node == NULL) {
+        LOGE("[DB]: Failed to allocate index node!");
+        return false;
+    }
+    node->hash = hash;
+    node->seq = seq;
+    node->entry = entry;
+    LinkNode(table, node);
+    table->count++;
+    return true;
+}
+
+static TrustedIndexNode *UnlinkNodeInBucket(TrustedIndexTable *table, uint32_t bucket, const void *entry)
+{
+    TrustedIndexNode **pos = &table->buckets[bucket];
+    while (*pos != NULL) {
+        if ((*pos)->entry == entry) {
+            TrustedIndexNode *node = *pos;
+            *pos = node->next;
+            node->next = NULL;
+            return node;
+        }
+        pos = &(*pos)->next;
+    }
+    return NULL;
+}
+
+static TrustedIndexNode *UnlinkNode(TrustedIndexTable *table, uint32_t hash, const void *entry)
+{
+    if (table->buckets == NULL) {
+        return NULL;
+    }
+    TrustedIndexNode *node = UnlinkNodeInBucket(table, GetBucketIndex(table, hash), entry);
+    if (node != NULL) {
+        return node;
+    }
+    /* the key of the entry has been changed in place, fall back to a full scan to avoid a dangling node */
+    for (uint32_t i = 0; i < table->bucketNum; i++) {
+        node = UnlinkNodeInBucket(table, i, entry);
+        if (node != NULL) {
+            LOGW("[DB]: The key of an indexed entry has been modified!");
+            return node;
+        }
+    }
+    return NULL;
+}
+
+static void RemoveNode(TrustedIndexTable *table, uint32_t hash, const void *entry)
+{
+    TrustedIndexNode *node = UnlinkNode(table, hash, entry);
+    if (node != NULL) {
+        HcFree(node);
+        table->count--;
+    }
+}
+
+static void RelinkNode(TrustedIndexTable *table, uint32_t oldHash, const void *oldEntry, uint32_t newHash,
+    void *newEntry)
+{
+    TrustedIndexNode *node = UnlinkNode(table, oldHash, oldEntry);
+    if (node == NULL) {
+        LOGE("[DB]: The replaced entry is not indexed!");
+        return;
+    }
+    node->hash = newHash;
+    node->entry = newEntry;
+    LinkNode(table, node);
+}
+
+static void DestroyTable(TrustedIndexTable *table)
+{
+    for (uint32_t i = 0; i < table->bucketNum; i++) {
+        TrustedIndexNode *node = table->buckets[i];
+        while (node != NULL) {
+            TrustedIndexNode *next = node->next;
+            HcFree(node);
+            node = next;
+        }
+    }
+    HcFree(table->buckets);
+    table->buckets = NULL;
+    table->bucketNum = 0;
+    table->count = 0;
+}
+
+void InitTrustedDataIndex(TrustedDataIndex *index)
+{
+    (void)memset_s(index, sizeof(TrustedDataIndex), 0, sizeof(TrustedDataIndex));
+}
+
+void DestroyTrustedDataIndex(TrustedDataIndex *index)
+{
+    DestroyTable(&index->groupIndex);
+    for (int32_t type = 0; type < DEVICE_INDEX_TYPE_NUM; type++) {
+        DestroyTable(&index->deviceIndex[type]);
+    }
+    index->nextSeq = 0;
+}
+
+bool AddGroupToIndex(TrustedDataIndex *index, TrustedGroupEntry *entry)
+{
+    return InsertNode(&index->groupIndex, HashKey(StringGet(&entry->id)), index->nextSeq++, entry);
+}
+
+void RemoveGroupFromIndex(TrustedDataIndex *index, const TrustedGroupEntry *entry)
+{
+    RemoveNode(&index->groupIndex, HashKey(StringGet(&entry->id)), entry);
+}
+
+void ReplaceGroupInIndex(TrustedDataIndex *index, const TrustedGroupEntry *oldEntry, TrustedGroupEntry *newEntry)
+{
+    RelinkNode(&index->groupIndex, HashKey(StringGet(&oldEntry->id)), oldEntry,
+        HashKey(StringGet(&newEntry->id)), newEntry);
+}
+
+TrustedGroupEntry *FindGroupInIndex(const TrustedDataIndex *index, const char *groupId)
+{
+    const TrustedIndexTable *table = &index->groupIndex;
+    if (groupId == NULL || table->buckets == NULL) {
+        return NULL;
+    }
+    uint32_t hash = HashKey(groupId);
+    for (const TrustedIndexNode *node = table->buckets[GetBucketIndex(table, hash)]; node != NULL;
+        node = node->next) {
+        TrustedGroupEntry *entry = (TrustedGroupEntry *)node->entry;
+        if ((node->hash == hash) && IsStrEqual(groupId, StringGet(&entry->id))) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+bool AddDeviceToIndex(TrustedDataIndex *index, TrustedDeviceEntry *entry)
+{
+    uint32_t seq = index->nextSeq++;
+    for (int32_t type = 0; type < DEVICE_INDEX_TYPE_NUM; type++) {
+        if (InsertNode(&index->deviceIndex[type], GetDeviceKeyHash((DeviceIndexType)type, entry), seq, entry)) {
+            continue;
+        }
+        for (int32_t added = 0; added < type; added++) {
+            RemoveNode(&index->deviceIndex[added], GetDeviceKeyHash((DeviceIndexType)added, entry), entry);
+        }
+        return false;
+    }
+    return true;
+}
+
+void RemoveDeviceFromIndex(TrustedDataIndex *index, const TrustedDeviceEntry *entry)
+{
+    for (int32_t type = 0; type < DEVICE_INDEX_TYPE_NUM; type++) {
+        RemoveNode(&index->deviceIndex[type], GetDeviceKeyHash((DeviceIndexType)type, entry), entry);
+    }
+}
+
+void ReplaceDeviceInIndex(TrustedDataIndex *index, const TrustedDeviceEntry *oldEntry, TrustedDeviceEntry *newEntry)
+{
+    for (int32_t type = 0; type < DEVICE_INDEX_TYPE_NUM; type++) {
+        RelinkNode(&index->deviceIndex[type], GetDeviceKeyHash((DeviceIndexType)type, oldEntry), oldEntry,
+            GetDeviceKeyHash((DeviceIndexType)type, newEntry), newEntry);
+    }
+}
+
+TrustedDeviceEntry *FindDeviceInIndex(const TrustedDataIndex *index, const char *groupId, const char *udid)
+{
+    QueryDeviceParams params = InitQueryDeviceParams();
+    params.groupId = groupId;
+    params.udid = udid;
+    TrustedIndexIter iter;
+    if (!BeginDeviceIndexIter(index, &params, &iter)) {
+        return NULL;
+    }
+    TrustedDeviceEntry *entry = NULL;
+    while ((entry = NextIndexedDevice(&iter)) != NULL) {
+        if (IsStrEqual(groupId, StringGet(&entry->groupId)) && IsStrEqual(udid, StringGet(&entry->udid))) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+bool BeginDeviceIndexIter(const TrustedDataIndex *index, const QueryDeviceParams *params, TrustedIndexIter *iter)
+{
+    DeviceIndexType type;
+    if ((params->groupId != NULL) && (params->udid != NULL)) {
+        type = DEVICE_INDEX_GROUP_UDID;
+        iter->hash = HashPairKey(params->groupId, params->udid);
+    } else if (params->udid != NULL) {
+        type = DEVICE_INDEX_UDID;
+        iter->hash = HashKey(params->udid);
+    } else if (params->authId != NULL) {
+        type = DEVICE_INDEX_AUTH_ID;
+        iter->hash = HashKey(params->authId);
+    } else if (params->groupId != NULL) {
+        type = DEVICE_INDEX_GROUP_ID;
+        iter->hash = HashKey(params->groupId);
+    } else {
+        return false;
+    }
+    const TrustedIndexTable *table = &index->deviceIndex[type];
+    iter->node = (table->buckets == NULL) ? NULL : table->buckets[GetBucketIndex(table, iter->hash)];
+    return true;
+}
+
+TrustedDeviceEntry *NextIndexedDevice(TrustedIndexIter *iter)
+{
+    while (iter->node != NULL) {
+        const TrustedIndexNode *node = iter->node;
+        iter->node = node->next;
+        if (node->hash == iter->hash) {
+            return (TrustedDeviceEntry *)node->entry;
+        }
+    }
+    return NULL;
+}
@@ -22,18 +22,21 @@
 #include "hc_dev_info.h"
 #include "hc_file.h"
 #include "hc_log.h"
-#include "hc_mutex.h"
+#include "hc_rwlock.h"
 #include "hc_string_vector.h"
+#include "hc_task_thread.h"
 #include "hc_types.h"
 #include "key_manager.h"
 #include "securec.h"
 #include "hidump_adapter.h"
+#include "hisysevent_adapter.h"
 #include "os_account_adapter.h"
 #include "pseudonym_manager.h"
 #include "security_label_adapter.h"
 #include "account_task_manager.h"
 #include "string_util.h"
 #include "group_data_manager_util.h"
+#include "group_data_index.h"
 
 typedef struct {
     DECLARE_TLV_STRUCT(10)
@@ -83,6 +86,22 @@ typedef struct {
 } HCDataBaseV1;
 DECLEAR_INIT_FUNC(HCDataBaseV1)
 
+typedef struct {
+    DECLARE_TLV_STRUCT(3)
+    TlvString groupId;
+    TlvString udid;
+    TlvString authId;
+} TlvDeviceKeyElement;
+DECLEAR_INIT_FUNC(TlvDeviceKeyElement)
+
+typedef struct {
+    DECLARE_TLV_STRUCT(3)
+    TlvInt32 version;
+    TlvGroupVec groups;
+    TlvBuffer devices;
+} HCLazyDataBaseV1;
+DECLEAR_INIT_FUNC(HCLazyDataBaseV1)
+
 DEFINE_TLV_FIX_LENGTH_TYPE(TlvDevAuthFixedLenInfo, NO_REVERT)
 
 BEGIN_TLV_STRUCT_DEFINE(TlvGroupElement, 0x0001)
@@ -117,6 +136,20 @@ BEGIN_TLV_STRUCT_DEFINE(HCDataBaseV1, 0x0001)
     TLV_MEMBER(TlvDeviceVec, devices, 0x6003)
 END_TLV_STRUCT_DEFINE()
 
+/* only the index keys of a device record are decoded at load time, the other members are skipped */
+BEGIN_TLV_STRUCT_DEFINE(TlvDeviceKeyElement, 0x0002)
+    TLV_MEMBER(TlvString, groupId, 0x4101)
+    TLV_MEMBER(TlvString, udid, 0x4102)
+    TLV_MEMBER(TlvString, authId, 0x4103)
+END_TLV_STRUCT_DEFINE()
+
+/* same layout as HCDataBaseV1, except that the device records are kept as raw bytes */
+BEGIN_TLV_STRUCT_DEFINE(HCLazyDataBaseV1, 0x0001)
+    TLV_MEMBER(TlvInt32, version, 0x6001)
+    TLV_MEMBER(TlvGroupVec, groups, 0x6002)
+    TLV_MEMBER(TlvBuffer, devices, 0x6003)
+END_TLV_STRUCT_DEFINE()
+
 IMPLEMENT_HC_VECTOR(GroupEntryVec, TrustedGroupEntry*, 1)
 IMPLEMENT_HC_VECTOR(DeviceEntryVec, TrustedDeviceEntry*, 1)
 
@@ -124,14 +157,34 @@ typedef struct {
     int32_t osAccountId;
     GroupEntryVec groups;
     DeviceEntryVec devices;
+    TrustedDataIndex index;
+    bool isDirty; /* modified in memory, waiting for the deferred flush */
+    HcParcel rawDevices; /* raw TLV records of the devices loaded from file, released once all are decoded */
+    uint32_t pendingDeviceNum; /* number of devices whose record has not been decoded completely */
 } OsAccountTrustedInfo;
 
+/*
+ * Every device entry held by the database is allocated as a StoredDeviceEntry. A device loaded from file
+ * only has its index keys decoded, the rest of its record is decoded on first access.
+ */
+typedef struct {
+    TrustedDeviceEntry entry; /* must be the first member, stored entries are destroyed as TrustedDeviceEntry */
+    const char *rawRecord; /* points into rawDevices of the os account, NULL once the entry is decoded */
+    uint32_t rawRecordLen;
+} StoredDeviceEntry;
+
 DECLARE_HC_VECTOR(DeviceAuthDb, OsAccountTrustedInfo)
 IMPLEMENT_HC_VECTOR(DeviceAuthDb, OsAccountTrustedInfo, 1)
 
 #define MAX_DB_PATH_LEN 256
-
-static HcMutex *g_databaseMutex = NULL;
+#define MAX_FLUSH_RETRY_NUM 3
+#define TEMP_FILE_PREFIX "tmp_"
+
+static HcRwLock *g_databaseLock = NULL;
+static int32_t (*g_pushFlushTask)(HcTaskBase *task) = NULL;
+static bool g_isFlushTaskPending = false;
+static uint32_t g_coalescedSaveNum = 0;
+static uint32_t g_flushRetryNum = 0;
 static DeviceAuthDb g_deviceauthDb;
 static const int UPGRADE_OS_ACCOUNT_ID = 100;
 
@@ -341,6 +394,29 @@ static bool GenerateGroupEntryFromTlv(TlvGroupElement *group, TrustedGroupEntry
     return true;
 }
 
+static void InitDeviceEntry(TrustedDeviceEntry *deviceEntry)
+{
+    deviceEntry->groupId = CreateString();
+    deviceEntry->udid = CreateString();
+    deviceEntry->authId = CreateString();
+    deviceEntry->userId = CreateString();
+    deviceEntry->serviceType = CreateString();
+    deviceEntry->ext = CreateParcel(0, 0);
+}
+
+static TrustedDeviceEntry *CreateStoredDeviceEntry(void)
+{
+    StoredDeviceEntry *ptr = (StoredDeviceEntry *)HcMalloc(sizeof(StoredDeviceEntry), 0);
+    if (ptr == NULL) {
+        LOGE("[DB]: Failed to allocate deviceEntry memory!");
+        return NULL;
+    }
+    InitDeviceEntry(&ptr->entry);
+    ptr->rawRecord = NULL;
+    ptr->rawRecordLen = 0;
+    return &ptr->entry;
+}
+
 static bool GenerateDeviceEntryFromTlv(TlvDeviceElement *device, TrustedDeviceEntry *deviceEntry)
 {
     deviceEntry->groupEntry = NULL;
@@ -376,11 +452,11 @@ static bool GenerateDeviceEntryFromTlv(TlvDeviceElement *device, TrustedDeviceEn
     return true;
 }
 
-static bool LoadGroups(HCDataBaseV1 *db, GroupEntryVec *vec)
+static bool LoadGroups(TlvGroupVec *groups, GroupEntryVec *vec)
 {
     uint32_t index;
     TlvGroupElement *group = NULL;
-    FOR_EACH_HC_VECTOR(db->groups.data, index, group) {
+    FOR_EACH_HC_VECTOR(groups->data, index, group) {
         if (group == NULL) {
             continue;
         }
@@ -405,50 +481,178 @@ static bool LoadGroups(HCDataBaseV1 *db, GroupEntryVec *vec)
     return true;
 }
 
-static bool LoadDevices(HCDataBaseV1 *db, DeviceEntryVec *vec)
+static bool LoadDeviceKeys(TlvDeviceKeyElement *keys, TrustedDeviceEntry *entry)
 {
-    uint32_t index;
-    TlvDeviceElement *device = NULL;
-    FOR_EACH_HC_VECTOR(db->devices.data, index, device) {
-        if (device == NULL) {
-            continue;
-        }
-        TrustedDeviceEntry *entry = CreateDeviceEntry();
+    if (!StringSet(&entry->groupId, keys->groupId.data)) {
+        LOGE("[DB]: Failed to load groupId from tlv!");
+        return false;
+    }
+    if (!StringSet(&entry->udid, keys->udid.data)) {
+        LOGE("[DB]: Failed to load udid from tlv!");
+        return false;
+    }
+    if (!StringSet(&entry->authId, keys->authId.data)) {
+        LOGE("[DB]: Failed to load authId from tlv!");
+        return false;
+    }
+    return true;
+}
+
+static TrustedDeviceEntry *LoadPendingDevice(HcParcel *records)
+{
+    const char *rawRecord = GetParcelData(records);
+    TlvDeviceKeyElement keys;
+    TLV_INIT(TlvDeviceKeyElement, &keys)
+    int32_t recordLen = ParseTlvNode((TlvBase *)&keys, records, HC_FALSE);
+    if (recordLen < 0) {
+        LOGE("[DB]: Failed to parse device record!");
+        TLV_DEINIT(keys)
+        return NULL;
+    }
+    TrustedDeviceEntry *entry = CreateStoredDeviceEntry();
+    if (entry == NULL) {
+        TLV_DEINIT(keys)
+        return NULL;
+    }
+    if (!LoadDeviceKeys(&keys, entry)) {
+        DestroyDeviceEntry(entry);
+        TLV_DEINIT(keys)
+        return NULL;
+    }
+    TLV_DEINIT(keys)
+    StoredDeviceEntry *storedEntry = (StoredDeviceEntry *)entry;
+    storedEntry->rawRecord = rawRecord;
+    storedEntry->rawRecordLen = (uint32_t)recordLen;
+    return entry;
+}
+
+static bool LoadDevices(OsAccountTrustedInfo *info)
+{
+    if (GetParcelDataSize(&info->rawDevices) == 0) {
+        return true;
+    }
+    /* same layout as the TlvDeviceVec parser: the record count followed by the device records */
+    HcParcel records = CreateReadOnlyParcel((char *)GetParcelData(&info->rawDevices),
+        GetParcelDataSize(&info->rawDevices), NULL);
+    uint32_t count = 0;
+    if (!ParcelReadUint32(&records, &count)) {
+        LOGE("[DB]: Failed to read device count!");
+        return false;
+    }
+    for (uint32_t index = 0; index < count; index++) {
+        TrustedDeviceEntry *entry = LoadPendingDevice(&records);
         if (entry == NULL) {
-            LOGE("[DB]: Failed to allocate entry memory!");
-            ClearDeviceEntryVec(vec);
+            ClearDeviceEntryVec(&info->devices);
             return false;
         }
-        if (!GenerateDeviceEntryFromTlv(device, entry)) {
+        if (info->devices.pushBackT(&info->devices, entry) == NULL) {
+            LOGE("[DB]: Failed to push entry to vec!");
             DestroyDeviceEntry(entry);
-            ClearDeviceEntryVec(vec);
+            ClearDeviceEntryVec(&info->devices);
             return false;
         }
-        if (vec->pushBackT(vec, entry) == NULL) {
-            LOGE("[DB]: Failed to push entry to vec!");
-            DestroyDeviceEntry(entry);
-            ClearDeviceEntryVec(vec);
+        info->pendingDeviceNum++;
+    }
+    return true;
+}
+
+static bool ParseRawDeviceRecord(const StoredDeviceEntry *storedEntry, TlvDeviceElement *device)
+{
+    HcParcel record = CreateReadOnlyParcel((char *)storedEntry->rawRecord, storedEntry->rawRecordLen, NULL);
+    return ParseTlvNode((TlvBase *)device, &record, HC_FALSE) == (int32_t)storedEntry->rawRecordLen;
+}
+
+static void ReleaseRawDeviceRecord(OsAccountTrustedInfo *info, StoredDeviceEntry *storedEntry)
+{
+    if (storedEntry->rawRecord == NULL) {
+        return;
+    }
+    storedEntry->rawRecord = NULL;
+    storedEntry->rawRecordLen = 0;
+    info->pendingDeviceNum--;
+    if (info->pendingDeviceNum == 0) {
+        DeleteParcel(&info->rawDevices);
+    }
+}
+
+/* Decode the rest of a device record loaded from file, the caller must hold the write lock. */
+static void DecodePendingDevice(OsAccountTrustedInfo *info, TrustedDeviceEntry *entry)
+{
+    StoredDeviceEntry *storedEntry = (StoredDeviceEntry *)entry;
+    if (storedEntry->rawRecord == NULL) {
+        return;
+    }
+    TlvDeviceElement device;
+    TLV_INIT(TlvDeviceElement, &device)
+    if (!ParseRawDeviceRecord(storedEntry, &device) || !GenerateDeviceEntryFromTlv(&device, entry)) {
+        LOGE("[DB]: Failed to decode device record, the entry only keeps its keys!");
+    }
+    TLV_DEINIT(device)
+    ReleaseRawDeviceRecord(info, storedEntry);
+}
+
+static void DecodeAllPendingDevices(OsAccountTrustedInfo *info)
+{
+    uint32_t index;
+    TrustedDeviceEntry **entry;
+    FOR_EACH_HC_VECTOR(info->devices, index, entry) {
+        if (info->pendingDeviceNum == 0) {
+            return;
+        }
+        DecodePendingDevice(info, *entry);
+    }
+}
+
+static bool BuildTrustedInfoIndex(OsAccountTrustedInfo *info)
+{
+    uint32_t index;
+    TrustedGroupEntry **groupEntry;
+    FOR_EACH_HC_VECTOR(info->groups, index, groupEntry) {
+        if (!AddGroupToIndex(&info->index, *groupEntry)) {
+            return false;
+        }
+    }
+    TrustedDeviceEntry **deviceEntry;
+    FOR_EACH_HC_VECTOR(info->devices, index, deviceEntry) {
+        if (!AddDeviceToIndex(&info->index, *deviceEntry)) {
             return false;
         }
     }
     return true;
 }
 
+static void ClearOsAccountTrustedInfo(OsAccountTrustedInfo *info)
+{
+    DestroyTrustedDataIndex(&info->index);
+    ClearGroupEntryVec(&info->groups);
+    ClearDeviceEntryVec(&info->devices);
+    DeleteParcel(&info->rawDevices);
+    info->pendingDeviceNum = 0;
+}
+
 static bool ReadInfoFromParcel(HcParcel *parcel, OsAccountTrustedInfo *info)
 {
     bool ret = false;
-    HCDataBaseV1 dbv1;
-    TLV_INIT(HCDataBaseV1, &dbv1)
+    HCLazyDataBaseV1 dbv1;
+    TLV_INIT(HCLazyDataBaseV1, &dbv1)
     if (DecodeTlvMessage((TlvBase *)&dbv1, parcel, false)) {
-        if (!LoadGroups(&dbv1, &info->groups)) {
+        if (!LoadGroups(&dbv1.groups, &info->groups)) {
             TLV_DEINIT(dbv1)
             return false;
         }
-        if (!LoadDevices(&dbv1, &info->devices)) {
+        /* take over the raw device records, the entries point into them until they are decoded */
+        info->rawDevices = dbv1.devices.data;
+        dbv1.devices.data = CreateParcel(0, 0);
+        if (!LoadDevices(info)) {
             ClearGroupEntryVec(&info->groups);
+            DeleteParcel(&info->rawDevices);
+            info->pendingDeviceNum = 0;
             TLV_DEINIT(dbv1)
             return false;
         }
+        if (info->pendingDeviceNum == 0) {
+            DeleteParcel(&info->rawDevices);
+        }
         ret = true;
     } else {
         LOGE("[DB]: Decode Tlv Message Failed!");
@@ -457,6 +661,12 @@ static bool ReadInfoFromParcel(HcParcel *parcel, OsAccountTrustedInfo *info)
     return ret;
 }
 
+static void FreeFileData(char *data, uint32_t length)
+{
+    (void)length;
+    HcFree(data);
+}
+
 static bool ReadParcelFromFile(const char *filePath, HcParcel *parcel)
 {
     FileHandle file;
@@ -472,7 +682,14 @@ static bool ReadParcelFromFile(const char *filePath, HcParcel *parcel)
         HcFileClose(file);
         return false;
     }
-    char *fileData = (char *)HcMalloc(fileSize, 0);
+    /* decode straight from the mapped file, the mapping stays valid after the file is closed */
+    char *fileData = HcFileMapRead(file, fileSize);
+    if (fileData != NULL) {
+        HcFileClose(file);
+        *parcel = CreateReadOnlyParcel(fileData, (uint32_t)fileSize, HcFileUnmap);
+        return true;
+    }
+    fileData = (char *)HcMalloc(fileSize, 0);
     if (fileData == NULL) {
         LOGE("[DB]: Failed to allocate fileData memory!");
         HcFileClose(file);
@@ -485,34 +702,93 @@ static bool ReadParcelFromFile(const char *filePath, HcParcel *parcel)
         return false;
     }
     HcFileClose(file);
-    if (!ParcelWrite(parcel, fileData, fileSize)) {
-        HcFree(fileData);
-        LOGE("[DB]: parcel write error!");
+    *parcel = CreateReadOnlyParcel(fileData, (uint32_t)fileSize, FreeFileData);
+    return true;
+}
+
+/*
+ * The temporary file lives next to the database file so that the rename stays on the same file system.
+ * The prefix keeps it from being picked up as a database file by LoadDeviceAuthDb.
+ */
+static bool GetTempFilePath(const char *filePath, char *tempPath, uint32_t tempPathLen)
+{
+    const char *lastSlash = strrchr(filePath, '/');
+    uint32_t dirLen = (lastSlash == NULL) ? 0 : (uint32_t)(lastSlash - filePath + 1);
+    if (memcpy_s(tempPath, tempPathLen, filePath, dirLen) != EOK) {
         return false;
     }
-    HcFree(fileData);
-    return true;
+    return sprintf_s(tempPath + dirLen, tempPathLen - dirLen, "%s%s", TEMP_FILE_PREFIX, filePath + dirLen) > 0;
 }
 
+/*
+ * Write the whole parcel to a temporary file and rename it over the database file,
+ * so that a crash in the middle of the write leaves the previous database intact.
+ */
 static bool SaveParcelToFile(const char *filePath, HcParcel *parcel)
 {
+    char tempPath[MAX_DB_PATH_LEN] = { 0 };
+    if (!GetTempFilePath(filePath, tempPath, MAX_DB_PATH_LEN)) {
+        LOGE("[DB]: Failed to get temp file path!");
+        return false;
+    }
     FileHandle file;
-    int ret = HcFileOpen(filePath, MODE_FILE_WRITE, &file);
+    int ret = HcFileOpen(tempPath, MODE_FILE_WRITE, &file);
     if (ret != HC_SUCCESS) {
         LOGE("[DB]: Failed to open database file!");
         return false;
     }
-    SetSecurityLabel(filePath, SECURITY_LABEL_S2);
+    SetSecurityLabel(tempPath, SECURITY_LABEL_S2);
     int fileSize = (int)GetParcelDataSize(parcel);
     const char *fileData = GetParcelData(parcel);
     int writeSize = HcFileWrite(file, fileData, fileSize);
     HcFileClose(file);
-    if (writeSize == fileSize) {
-        return true;
-    } else {
+    if (writeSize != fileSize) {
         LOGE("[DB]: write file error!");
+        HcFileRemove(tempPath);
         return false;
     }
+    if (HcFileRename(tempPath, filePath) != 0) {
+        LOGE("[DB]: Failed to replace database file!");
+        HcFileRemove(tempPath);
+        return false;
+    }
+    return true;
+}
+
+static bool SaveInfoToParcel(const OsAccountTrustedInfo *info, HcParcel *parcel);
+
+static int32_t SaveTrustedInfoToFile(OsAccountTrustedInfo *info)
+{
+    HcParcel parcel = CreateParcel(0, 0);
+    if (!SaveInfoToParcel(info, &parcel)) {
+        DeleteParcel(&parcel);
+        return HC_ERR_MEMORY_COPY;
+    }
+    char filePath[MAX_DB_PATH_LEN] = { 0 };
+    if (!GetOsAccountInfoPath(info->osAccountId, filePath, MAX_DB_PATH_LEN)) {
+        DeleteParcel(&parcel);
+        return HC_ERROR;
+    }
+    if (!SaveParcelToFile(filePath, &parcel)) {
+        DeleteParcel(&parcel);
+        return HC_ERR_MEMORY_COPY;
+    }
+    DeleteParcel(&parcel);
+    info->isDirty = false;
+    LOGI("[DB]: Save an os account database successfully! [Id]: %" LOG_PUB "d", info->osAccountId);
+    return HC_SUCCESS;
+}
+
+static void FlushOsAccountTrustedInfo(int32_t osAccountId)
+{
+    uint32_t index;
+    OsAccountTrustedInfo *info;
+    FOR_EACH_HC_VECTOR(g_deviceauthDb, index, info) {
+        if (info->osAccountId == osAccountId && info->isDirty) {
+            (void)SaveTrustedInfoToFile(info);
+            return;
+        }
+    }
 }
 
 static void LoadOsAccountDb(int32_t osAccountId)
@@ -531,6 +807,10 @@ static void LoadOsAccountDb(int32_t osAccountId)
     info.osAccountId = osAccountId;
     info.groups = CreateGroupEntryVec();
     info.devices = CreateDeviceEntryVec();
+    InitTrustedDataIndex(&info.index);
+    info.isDirty = false;
+    info.rawDevices = CreateParcel(0, 0);
+    info.pendingDeviceNum = 0;
     if (!ReadInfoFromParcel(&parcel, &info)) {
         DestroyGroupEntryVec(&info.groups);
         DestroyDeviceEntryVec(&info.devices);
@@ -538,10 +818,14 @@ static void LoadOsAccountDb(int32_t osAccountId)
         return;
     }
     DeleteParcel(&parcel);
+    if (!BuildTrustedInfoIndex(&info)) {
+        LOGE("[DB]: Failed to build index of osAccountInfo!");
+        ClearOsAccountTrustedInfo(&info);
+        return;
+    }
     if (g_deviceauthDb.pushBackT(&g_deviceauthDb, info) == NULL) {
         LOGE("[DB]: Failed to push osAccountInfo to database!");
-        ClearGroupEntryVec(&info.groups);
-        ClearDeviceEntryVec(&info.devices);
+        ClearOsAccountTrustedInfo(&info);
         return;
     }
     LOGI("[DB]: Load os account db successfully! [Id]: %" LOG_PUB "d", osAccountId);
@@ -597,8 +881,7 @@ static void RemoveOsAccountTrustedInfo(int32_t osAccountId)
         if (info->osAccountId == osAccountId) {
             OsAccountTrustedInfo deleteInfo;
             HC_VECTOR_POPELEMENT(&g_deviceauthDb, &deleteInfo, index);
-            ClearGroupEntryVec(&deleteInfo.groups);
-            ClearDeviceEntryVec(&deleteInfo.devices);
+            ClearOsAccountTrustedInfo(&deleteInfo);
             return;
         }
     }
@@ -606,6 +889,8 @@ static void RemoveOsAccountTrustedInfo(int32_t osAccountId)
 
 static void LoadOsAccountDbCe(int32_t osAccountId)
 {
+    /* the cache is about to be replaced by the file content, persist the pending changes first */
+    FlushOsAccountTrustedInfo(osAccountId);
     TryMoveDeDataToCe(osAccountId);
     RemoveOsAccountTrustedInfo(osAccountId);
     LoadOsAccountDb(osAccountId);
@@ -699,30 +984,35 @@ static void CheckAndRemoveUpgradeData(int32_t osAccountId)
 
 static void OnOsAccountUnlocked(int32_t osAccountId)
 {
-    (void)LockHcMutex(g_databaseMutex);
+    (void)WriteLockHcRwLock(g_databaseLock);
     LoadOsAccountDbCe(osAccountId);
-    UnlockHcMutex(g_databaseMutex);
+    UnlockHcRwLock(g_databaseLock);
     CheckAndRemoveUpgradeData(osAccountId);
 }
 
 static void OnOsAccountRemoved(int32_t osAccountId)
 {
     LOGI("[DB]: os account is removed, osAccountId: %" LOG_PUB "d", osAccountId);
-    (void)LockHcMutex(g_databaseMutex);
+    (void)WriteLockHcRwLock(g_databaseLock);
     RemoveOsAccountTrustedInfo(osAccountId);
-    UnlockHcMutex(g_databaseMutex);
+    UnlockHcRwLock(g_databaseLock);
 }
 
-static bool IsOsAccountGroupDataLoaded(int32_t osAccountId)
+static OsAccountTrustedInfo *FindLoadedTrustedInfo(int32_t osAccountId)
 {
     uint32_t index = 0;
     OsAccountTrustedInfo *info = NULL;
     FOR_EACH_HC_VECTOR(g_deviceauthDb, index, info) {
         if (info->osAccountId == osAccountId) {
-            return true;
+            return info;
         }
     }
-    return false;
+    return NULL;
+}
+
+static bool IsOsAccountGroupDataLoaded(int32_t osAccountId)
+{
+    return FindLoadedTrustedInfo(osAccountId) != NULL;
 }
 
 static void LoadDataIfNotLoaded(int32_t osAccountId)
@@ -751,6 +1041,10 @@ static OsAccountTrustedInfo *GetTrustedInfoByOsAccountId(int32_t osAccountId)
     newInfo.osAccountId = osAccountId;
     newInfo.groups = CreateGroupEntryVec();
     newInfo.devices = CreateDeviceEntryVec();
+    InitTrustedDataIndex(&newInfo.index);
+    newInfo.isDirty = false;
+    newInfo.rawDevices = CreateParcel(0, 0);
+    newInfo.pendingDeviceNum = 0;
     OsAccountTrustedInfo *returnInfo = g_deviceauthDb.pushBackT(&g_deviceauthDb, newInfo);
     if (returnInfo == NULL) {
         LOGE("[DB]: Failed to push osAccountInfo to database!");
@@ -760,12 +1054,34 @@ static OsAccountTrustedInfo *GetTrustedInfoByOsAccountId(int32_t osAccountId)
     return returnInfo;
 }
 
+/*
+ * Lock the database for a query. Queries on a cached os account share the read lock, the first query
+ * of an os account has to load or create its cache and therefore falls back to the write lock.
+ * The first device query also falls back to the write lock while device records are still to be decoded,
+ * and decodes all of them so that the following device queries share the read lock again.
+ */
+static OsAccountTrustedInfo *LockTrustedInfoForRead(int32_t osAccountId, bool needDecodedDevices)
+{
+    (void)ReadLockHcRwLock(g_databaseLock);
+    OsAccountTrustedInfo *info = FindLoadedTrustedInfo(osAccountId);
+    if ((info != NULL) && (!needDecodedDevices || info->pendingDeviceNum == 0)) {
+        return info;
+    }
+    UnlockHcRwLock(g_databaseLock);
+    (void)WriteLockHcRwLock(g_databaseLock);
+    info = GetTrustedInfoByOsAccountId(osAccountId);
+    if ((info != NULL) && needDecodedDevices) {
+        DecodeAllPendingDevices(info);
+    }
+    return info;
+}
+
 static void LoadDeviceAuthDb(void)
 {
     if (IsOsAccountSupported()) {
         return;
     }
-    (void)LockHcMutex(g_databaseMutex);
+    (void)WriteLockHcRwLock(g_databaseLock);
     StringVector osAccountDbNameVec = CreateStrVector();
     HcFileGetSubFileName(GetStorageDirPath(), &osAccountDbNameVec);
     HcString *dbName;
@@ -784,7 +1100,7 @@ static void LoadDeviceAuthDb(void)
         }
     }
     DestroyStrVector(&osAccountDbNameVec);
-    UnlockHcMutex(g_databaseMutex);
+    UnlockHcRwLock(g_databaseLock);
 }
 
 static bool SetGroupElement(TlvGroupElement *element, TrustedGroupEntry *entry)
@@ -884,7 +1200,11 @@ static bool SaveDevices(const DeviceEntryVec *vec, HCDataBaseV1 *db)
             return false;
         }
         TLV_INIT(TlvDeviceElement, element);
-        if (!SetDeviceElement(element, *entry)) {
+        /* a device that has not been accessed is written back from its raw record without decoding the entry */
+        const StoredDeviceEntry *storedEntry = (const StoredDeviceEntry *)(*entry);
+        bool isSet = (storedEntry->rawRecord != NULL) ? ParseRawDeviceRecord(storedEntry, element) :
+            SetDeviceElement(element, *entry);
+        if (!isSet) {
             TLV_DEINIT((*element));
             return false;
         }
@@ -961,30 +1281,64 @@ static bool CompareQueryDeviceParams(const QueryDeviceParams *params, const Trus
     return true;
 }
 
-static TrustedGroupEntry **QueryGroupEntryPtrIfMatch(const GroupEntryVec *vec, const QueryGroupParams *params)
+/*
+ * The keys are compared first, so that only the candidates are decoded. Only write lock holders can meet a
+ * pending record, LockTrustedInfoForRead decodes all of them before device queries share the read lock.
+ */
+static bool MatchStoredDevice(OsAccountTrustedInfo *info, const QueryDeviceParams *params, TrustedDeviceEntry *entry)
+{
+    if (((StoredDeviceEntry *)entry)->rawRecord != NULL) {
+        QueryDeviceParams keyParams = *params;
+        keyParams.userId = NULL;
+        if (!CompareQueryDeviceParams(&keyParams, entry)) {
+            return false;
+        }
+        DecodePendingDevice(info, entry);
+    }
+    return CompareQueryDeviceParams(params, entry);
+}
+
+static TrustedGroupEntry **GetGroupEntrySlot(const GroupEntryVec *vec, const TrustedGroupEntry *entry)
 {
     uint32_t index;
-    TrustedGroupEntry **entry;
-    FOR_EACH_HC_VECTOR(*vec, index, entry) {
-        if (CompareQueryGroupParams(params, *entry)) {
-            return entry;
+    TrustedGroupEntry **slot;
+    FOR_EACH_HC_VECTOR(*vec, index, slot) {
+        if (*slot == entry) {
+            return slot;
         }
     }
     return NULL;
 }
 
-static TrustedDeviceEntry **QueryDeviceEntryPtrIfMatch(const DeviceEntryVec *vec, const QueryDeviceParams *params)
+static TrustedDeviceEntry **GetDeviceEntrySlot(const DeviceEntryVec *vec, const TrustedDeviceEntry *entry)
 {
     uint32_t index;
-    TrustedDeviceEntry **entry;
-    FOR_EACH_HC_VECTOR(*vec, index, entry) {
-        if (CompareQueryDeviceParams(params, *entry)) {
-            return entry;
+    TrustedDeviceEntry **slot;
+    FOR_EACH_HC_VECTOR(*vec, index, slot) {
+        if (*slot == entry) {
+            return slot;
         }
     }
     return NULL;
 }
 
+static bool IsDeviceExistInDb(const OsAccountTrustedInfo *info, const char *udid)
+{
+    QueryDeviceParams params = InitQueryDeviceParams();
+    params.udid = udid;
+    TrustedIndexIter iter;
+    if (!BeginDeviceIndexIter(&info->index, &params, &iter)) {
+        return false;
+    }
+    TrustedDeviceEntry *entry = NULL;
+    while ((entry = NextIndexedDevice(&iter)) != NULL) {
+        if (CompareQueryDeviceParams(&params, entry)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static void PostGroupCreatedMsg(int32_t osAccountId, const char *subProfileIdStr, const TrustedGroupEntry *groupEntry)
 {
     if (!IsBroadcastSupported()) {
@@ -1017,12 +1371,10 @@ static void PostDeviceBoundMsg(OsAccountTrustedInfo *info, const char *subProfil
     if (!IsBroadcastSupported()) {
         return;
     }
-    QueryGroupParams groupParams = InitQueryGroupParams();
-    groupParams.groupId = StringGet(&deviceEntry->groupId);
-    TrustedGroupEntry **groupEntryPtr = QueryGroupEntryPtrIfMatch(&info->groups, &groupParams);
-    if (groupEntryPtr != NULL) {
+    TrustedGroupEntry *groupEntry = FindGroupInIndex(&info->index, StringGet(&deviceEntry->groupId));
+    if (groupEntry != NULL) {
         char *messageStr = NULL;
-        if (GenerateMessage(info->osAccountId, subProfileIdStr, *groupEntryPtr, &messageStr) != HC_SUCCESS) {
+        if (GenerateMessage(info->osAccountId, subProfileIdStr, groupEntry, &messageStr) != HC_SUCCESS) {
             return;
         }
         GetBroadcaster()->postOnDeviceBound(StringGet(&deviceEntry->udid), messageStr);
@@ -1038,21 +1390,16 @@ static void PostDeviceUnBoundMsg(OsAccountTrustedInfo *info, const char *subProf
     }
     const char *groupId = StringGet(&deviceEntry->groupId);
     const char *udid = StringGet(&deviceEntry->udid);
-    QueryGroupParams groupParams = InitQueryGroupParams();
-    groupParams.groupId = groupId;
-    TrustedGroupEntry **groupEntryPtr = QueryGroupEntryPtrIfMatch(&info->groups, &groupParams);
-    if (groupEntryPtr != NULL) {
+    TrustedGroupEntry *groupEntry = FindGroupInIndex(&info->index, groupId);
+    if (groupEntry != NULL) {
         char *messageStr = NULL;
-        if (GenerateMessage(info->osAccountId, subProfileIdStr, *groupEntryPtr,
-            &messageStr) != HC_SUCCESS) {
+        if (GenerateMessage(info->osAccountId, subProfileIdStr, groupEntry, &messageStr) != HC_SUCCESS) {
             return;
         }
         GetBroadcaster()->postOnDeviceUnBound(udid, messageStr);
         FreeJsonString(messageStr);
     }
-    QueryDeviceParams deviceParams = InitQueryDeviceParams();
-    deviceParams.udid = udid;
-    if (QueryDeviceEntryPtrIfMatch(&info->devices, &deviceParams) == NULL) {
+    if (!IsDeviceExistInDb(info, udid)) {
         GetBroadcaster()->postOnDeviceNotTrusted(udid);
         if (!IsSelfDeviceEntry(deviceEntry)) {
             (void)DeleteMk(info->osAccountId, udid);
@@ -1069,13 +1416,11 @@ static int32_t GenerateMessageForSubProfile(int32_t osAccountId, const char *sub
     if (info == NULL) {
         return HC_ERR_NULL_PTR;
     }
-    QueryGroupParams groupParams = InitQueryGroupParams();
-    groupParams.groupId = groupId;
-    TrustedGroupEntry **groupEntry = QueryGroupEntryPtrIfMatch(&info->groups, &groupParams);
+    TrustedGroupEntry *groupEntry = FindGroupInIndex(&info->index, groupId);
     if (groupEntry == NULL) {
         return HC_ERR_NULL_PTR;
     }
-    return GenerateMessage(osAccountId, subProfileIdStr, *groupEntry, messageStr);
+    return GenerateMessage(osAccountId, subProfileIdStr, groupEntry, messageStr);
 }
 
 static void PostGroupActive(int32_t osAccountId, const char *subProfileIdStr, const char *groupId)
@@ -1256,12 +1601,7 @@ TrustedDeviceEntry *CreateDeviceEntry(void)
         LOGE("[DB]: Failed to allocate deviceEntry memory!");
         return NULL;
     }
-    ptr->groupId = CreateString();
-    ptr->udid = CreateString();
-    ptr->authId = CreateString();
-    ptr->userId = CreateString();
-    ptr->serviceType = CreateString();
-    ptr->ext = CreateParcel(0, 0);
+    InitDeviceEntry(ptr);
     return ptr;
 }
 
@@ -1317,42 +1657,50 @@ void ClearDeviceEntryVec(DeviceEntryVec *vec)
 
 static int32_t AddGroupInner(int32_t osAccountId, const char *subProfileIdStr, const TrustedGroupEntry *groupEntry)
 {
-    (void)LockHcMutex(g_databaseMutex);
+    (void)WriteLockHcRwLock(g_databaseLock);
     OsAccountTrustedInfo *info = GetTrustedInfoByOsAccountId(osAccountId);
     if (info == NULL) {
-        UnlockHcMutex(g_databaseMutex);
+        UnlockHcRwLock(g_databaseLock);
         return HC_ERR_INVALID_PARAMS;
     }
     TrustedGroupEntry *newEntry = DeepCopyGroupEntry(groupEntry);
     if (newEntry == NULL) {
-        UnlockHcMutex(g_databaseMutex);
+        UnlockHcRwLock(g_databaseLock);
         return HC_ERR_MEMORY_COPY;
     }
-    QueryGroupParams params = InitQueryGroupParams();
-    params.groupId = StringGet(&groupEntry->id);
-    TrustedGroupEntry **oldEntryPtr = QueryGroupEntryPtrIfMatch(&info->groups, &params);
+    TrustedGroupEntry *oldEntry = FindGroupInIndex(&info->index, StringGet(&groupEntry->id));
+    TrustedGroupEntry **oldEntryPtr = (oldEntry != NULL) ? GetGroupEntrySlot(&info->groups, oldEntry) : NULL;
     if (oldEntryPtr != NULL) {
-        DestroyGroupEntry(*oldEntryPtr);
+        ReplaceGroupInIndex(&info->index, oldEntry, newEntry);
+        DestroyGroupEntry(oldEntry);
         *oldEntryPtr = newEntry;
         PostGroupCreatedMsg(osAccountId, subProfileIdStr, newEntry);
     #ifdef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
         PostGroupActive(osAccountId, subProfileIdStr, StringGet(&newEntry->id));
     #endif
-        UnlockHcMutex(g_databaseMutex);
+        UnlockHcRwLock(g_databaseLock);
         LOGI("[DB]: Replace an old group successfully! [GroupType]: %" LOG_PUB "u", groupEntry->type);
         return HC_SUCCESS;
     }
     if (info->groups.pushBackT(&info->groups, newEntry) == NULL) {
         DestroyGroupEntry(newEntry);
-        UnlockHcMutex(g_databaseMutex);
+        UnlockHcRwLock(g_databaseLock);
         LOGE("[DB]: Failed to push groupEntry to vec!");
         return HC_ERR_MEMORY_COPY;
     }
+    if (!AddGroupToIndex(&info->index, newEntry)) {
+        TrustedGroupEntry *popEntry = NULL;
+        HC_VECTOR_POPELEMENT(&info->groups, &popEntry, HC_VECTOR_SIZE(&info->groups) - 1);
+        DestroyGroupEntry(newEntry);
+        UnlockHcRwLock(g_databaseLock);
+        LOGE("[DB]: Failed to add groupEntry to index!");
+        return HC_ERR_ALLOC_MEMORY;
+    }
     PostGroupCreatedMsg(osAccountId, subProfileIdStr, newEntry);
 #ifdef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
     PostGroupActive(osAccountId, subProfileIdStr, StringGet(&newEntry->id));
 #endif
-    UnlockHcMutex(g_databaseMutex);
+    UnlockHcRwLock(g_databaseLock);
     LOGI("[DB]: Add a group to database successfully! [GroupType]: %" LOG_PUB "u", groupEntry->type);
     return HC_SUCCESS;
 }
@@ -1410,44 +1758,58 @@ static void DeleteDeviceRelation(int32_t osAccountId, const char *subProfileIdSt
 static int32_t AddTrustedDeviceInner(int32_t osAccountId, const char *subProfileIdStr,
     const TrustedDeviceEntry *deviceEntry)
 {
-    (void)LockHcMutex(g_databaseMutex);
+    (void)WriteLockHcRwLock(g_databaseLock);
     OsAccountTrustedInfo *info = GetTrustedInfoByOsAccountId(osAccountId);
     if (info == NULL) {
-        UnlockHcMutex(g_databaseMutex);
+        UnlockHcRwLock(g_databaseLock);
         return HC_ERR_INVALID_PARAMS;
     }
-    TrustedDeviceEntry *newEntry = DeepCopyDeviceEntry(deviceEntry);
+    TrustedDeviceEntry *newEntry = CreateStoredDeviceEntry();
     if (newEntry == NULL) {
-        UnlockHcMutex(g_databaseMutex);
+        UnlockHcRwLock(g_databaseLock);
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    if (!GenerateDeviceEntryFromEntry(deviceEntry, newEntry)) {
+        DestroyDeviceEntry(newEntry);
+        UnlockHcRwLock(g_databaseLock);
         return HC_ERR_MEMORY_COPY;
     }
-    QueryDeviceParams params = InitQueryDeviceParams();
-    params.udid = StringGet(&deviceEntry->udid);
-    params.groupId = StringGet(&deviceEntry->groupId);
-    TrustedDeviceEntry **oldEntryPtr = QueryDeviceEntryPtrIfMatch(&info->devices, &params);
+    TrustedDeviceEntry *oldEntry = FindDeviceInIndex(&info->index, StringGet(&deviceEntry->groupId),
+        StringGet(&deviceEntry->udid));
+    TrustedDeviceEntry **oldEntryPtr = (oldEntry != NULL) ? GetDeviceEntrySlot(&info->devices, oldEntry) : NULL;
     if (oldEntryPtr != NULL) {
-        DestroyDeviceEntry(*oldEntryPtr);
+        ReplaceDeviceInIndex(&info->index, oldEntry, newEntry);
+        ReleaseRawDeviceRecord(info, (StoredDeviceEntry *)oldEntry);
+        DestroyDeviceEntry(oldEntry);
         *oldEntryPtr = newEntry;
         PostDeviceBoundMsg(info, subProfileIdStr, newEntry);
     #ifdef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
         AddDeviceRelation(osAccountId, subProfileIdStr, newEntry);
     #endif
-        UnlockHcMutex(g_databaseMutex);
+        UnlockHcRwLock(g_databaseLock);
         LOGI("[DB]: Replace an old trusted device successfully!");
         return HC_SUCCESS;
     }
     if (info->devices.pushBackT(&info->devices, newEntry) == NULL) {
         DestroyDeviceEntry(newEntry);
-        UnlockHcMutex(g_databaseMutex);
+        UnlockHcRwLock(g_databaseLock);
         LOGE("[DB]: Failed to push deviceEntry to vec!");
         return HC_ERR_MEMORY_COPY;
     }
+    if (!AddDeviceToIndex(&info->index, newEntry)) {
+        TrustedDeviceEntry *popEntry = NULL;
+        HC_VECTOR_POPELEMENT(&info->devices, &popEntry, HC_VECTOR_SIZE(&info->devices) - 1);
+        DestroyDeviceEntry(newEntry);
+        UnlockHcRwLock(g_databaseLock);
+        LOGE("[DB]: Failed to add deviceEntry to index!");
+        return HC_ERR_ALLOC_MEMORY;
+    }
     RecordAddTrustDeviceEvent(osAccountId, deviceEntry);
     PostDeviceBoundMsg(info, subProfileIdStr, newEntry);
 #ifdef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
     AddDeviceRelation(osAccountId, subProfileIdStr, newEntry);
 #endif
-    UnlockHcMutex(g_databaseMutex);
+    UnlockHcRwLock(g_databaseLock);
     LOGI("[DB]: Add a trusted device to database successfully!");
     return HC_SUCCESS;
 }
@@ -1476,10 +1838,10 @@ static int32_t DelGroupInner(int32_t osAccountId, const char *subProfileIdStr, b
 #ifndef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
     (void)shouldPostInactive;
 #endif
-    (void)LockHcMutex(g_databaseMutex);
+    (void)WriteLockHcRwLock(g_databaseLock);
     OsAccountTrustedInfo *info = GetTrustedInfoByOsAccountId(osAccountId);
     if (info == NULL) {
-        UnlockHcMutex(g_databaseMutex);
+        UnlockHcRwLock(g_databaseLock);
         LOGE("[DB]: GetTrustedInfoByOsAccountId occurred error!");
         return HC_ERR_INVALID_PARAMS;
     }
@@ -1504,12 +1866,13 @@ static int32_t DelGroupInner(int32_t osAccountId, const char *subProfileIdStr, b
     #endif
         TrustedGroupEntry *popEntry;
         HC_VECTOR_POPELEMENT(&info->groups, &popEntry, index);
+        RemoveGroupFromIndex(&info->index, popEntry);
         PostGroupDeletedMsg(osAccountId, subProfileIdStr, popEntry);
         LOGI("[DB]: Delete a group from database successfully! [GroupType]: %" LOG_PUB "u", popEntry->type);
         DestroyGroupEntry(popEntry);
         count++;
     }
-    UnlockHcMutex(g_databaseMutex);
+    UnlockHcRwLock(g_databaseLock);
     LOGI("[DB]: Number of groups deleted: %" LOG_PUB "d", count);
     return HC_SUCCESS;
 }
@@ -1538,10 +1901,10 @@ static int32_t DelTrustedDeviceInner(int32_t osAccountId, const char *subProfile
 #ifndef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
     (void)shouldPostInactive;
 #endif
-    (void)LockHcMutex(g_databaseMutex);
+    (void)WriteLockHcRwLock(g_databaseLock);
     OsAccountTrustedInfo *info = GetTrustedInfoByOsAccountId(osAccountId);
     if (info == NULL) {
-        UnlockHcMutex(g_databaseMutex);
+        UnlockHcRwLock(g_databaseLock);
         return HC_ERR_INVALID_PARAMS;
     }
     int32_t count = 0;
@@ -1549,7 +1912,7 @@ static int32_t DelTrustedDeviceInner(int32_t osAccountId, const char *subProfile
     TrustedDeviceEntry **entry = NULL;
     while (index < HC_VECTOR_SIZE(&info->devices)) {
         entry = info->devices.getp(&info->devices, index);
-        if ((entry == NULL) || (*entry == NULL) || (!CompareQueryDeviceParams(params, *entry))) {
+        if ((entry == NULL) || (*entry == NULL) || (!MatchStoredDevice(info, params, *entry))) {
             index++;
             continue;
         }
@@ -1563,13 +1926,14 @@ static int32_t DelTrustedDeviceInner(int32_t osAccountId, const char *subProfile
     #endif
         TrustedDeviceEntry *popEntry;
         HC_VECTOR_POPELEMENT(&info->devices, &popEntry, index);
+        RemoveDeviceFromIndex(&info->index, popEntry);
         PostDeviceUnBoundMsg(info, subProfileIdStr, popEntry);
         DeletePdidByDeviceEntry(osAccountId, popEntry);
         LOGI("[DB]: Delete a trusted device from database successfully!");
         DestroyDeviceEntry(popEntry);
         count++;
     }
-    UnlockHcMutex(g_databaseMutex);
+    UnlockHcRwLock(g_databaseLock);
     LOGI("[DB]: Number of trusted devices deleted: %" LOG_PUB "d", count);
     return HC_SUCCESS;
 }
@@ -1592,39 +1956,154 @@ int32_t DelTrustedDevice(int32_t osAccountId, const QueryDeviceParams *params)
     return DelTrustedDeviceInner(osAccountId, subProfileIdStr, true, params);
 }
 
-static int32_t QueryGroupsInner(int32_t osAccountId, const char *subProfileIdStr, const QueryGroupParams *params,
-    GroupEntryVec *vec)
+static bool IsGroupVisibleToUser(int32_t osAccountId, const char *subProfileIdStr, const TrustedGroupEntry *entry)
 {
-#ifndef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
+#ifdef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
+    return IsSelfDeviceExistInGroupForUser(osAccountId, subProfileIdStr, StringGet(&entry->id));
+#else
+    (void)osAccountId;
     (void)subProfileIdStr;
+    (void)entry;
+    return true;
 #endif
-    (void)LockHcMutex(g_databaseMutex);
-    OsAccountTrustedInfo *info = GetTrustedInfoByOsAccountId(osAccountId);
+}
+
+static bool IsDeviceVisibleToUser(int32_t osAccountId, const char *subProfileIdStr, const TrustedDeviceEntry *entry)
+{
+#ifdef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
+    return IsDeviceExistInGroupForUser(osAccountId, subProfileIdStr, StringGet(&entry->groupId),
+        StringGet(&entry->udid));
+#else
+    (void)osAccountId;
+    (void)subProfileIdStr;
+    (void)entry;
+    return true;
+#endif
+}
+
+static int32_t VisitGroupsInner(int32_t osAccountId, const char *subProfileIdStr, const QueryGroupParams *params,
+    GroupEntryVisitor visitor, void *ctx)
+{
+    OsAccountTrustedInfo *info = LockTrustedInfoForRead(osAccountId, false);
     if (info == NULL) {
-        UnlockHcMutex(g_databaseMutex);
+        UnlockHcRwLock(g_databaseLock);
         return HC_ERR_INVALID_PARAMS;
     }
+    if (params->groupId != NULL) {
+        TrustedGroupEntry *entry = FindGroupInIndex(&info->index, params->groupId);
+        if ((entry != NULL) && CompareQueryGroupParams(params, entry) &&
+            IsGroupVisibleToUser(osAccountId, subProfileIdStr, entry)) {
+            (void)visitor(entry, ctx);
+        }
+        UnlockHcRwLock(g_databaseLock);
+        return HC_SUCCESS;
+    }
     uint32_t index;
     TrustedGroupEntry **entry;
     FOR_EACH_HC_VECTOR(info->groups, index, entry) {
-        if (!CompareQueryGroupParams(params, *entry)) {
+        if (!CompareQueryGroupParams(params, *entry) || !IsGroupVisibleToUser(osAccountId, subProfileIdStr, *entry)) {
             continue;
         }
-    #ifdef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
-        if (!IsSelfDeviceExistInGroupForUser(osAccountId, subProfileIdStr, StringGet(&(*entry)->id))) {
-            continue;
+        if (!visitor(*entry, ctx)) {
+            break;
         }
-    #endif
-        TrustedGroupEntry *newEntry = DeepCopyGroupEntry(*entry);
-        if (newEntry == NULL) {
+    }
+    UnlockHcRwLock(g_databaseLock);
+    return HC_SUCCESS;
+}
+
+static int32_t VisitDevicesInner(int32_t osAccountId, const QueryDeviceParams *params, DeviceEntryVisitor visitor,
+    void *ctx)
+{
+    OsAccountTrustedInfo *info = LockTrustedInfoForRead(osAccountId, true);
+    if (info == NULL) {
+        UnlockHcRwLock(g_databaseLock);
+        return HC_ERR_INVALID_PARAMS;
+    }
+    char subProfileIdStr[SUB_PROFILE_ID_CHAR_MAX_LEN + 1] = { 0 };
+#ifdef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
+    int32_t res = GetForegroundSubProfileIdStr(osAccountId, subProfileIdStr, SUB_PROFILE_ID_CHAR_MAX_LEN);
+    if (res != HC_SUCCESS) {
+        LOGE("[DB]: Failed to get foreground subProfileId string!");
+        UnlockHcRwLock(g_databaseLock);
+        return res;
+    }
+#endif
+    TrustedIndexIter iter;
+    if (BeginDeviceIndexIter(&info->index, params, &iter)) {
+        TrustedDeviceEntry *indexedEntry = NULL;
+        while ((indexedEntry = NextIndexedDevice(&iter)) != NULL) {
+            if (!MatchStoredDevice(info, params, indexedEntry) ||
+                !IsDeviceVisibleToUser(osAccountId, subProfileIdStr, indexedEntry)) {
+                continue;
+            }
+            if (!visitor(indexedEntry, ctx)) {
+                break;
+            }
+        }
+        UnlockHcRwLock(g_databaseLock);
+        return HC_SUCCESS;
+    }
+    uint32_t index;
+    TrustedDeviceEntry **entry;
+    FOR_EACH_HC_VECTOR(info->devices, index, entry) {
+        if (!MatchStoredDevice(info, params, *entry) || !IsDeviceVisibleToUser(osAccountId, subProfileIdStr, *entry)) {
             continue;
         }
-        if (vec->pushBackT(vec, newEntry) == NULL) {
-            LOGE("[DB]: Failed to push entry to vec!");
-            DestroyGroupEntry(newEntry);
+        if (!visitor(*entry, ctx)) {
+            break;
         }
     }
-    UnlockHcMutex(g_databaseMutex);
+    UnlockHcRwLock(g_databaseLock);
+    return HC_SUCCESS;
+}
+
+static bool CopyGroupEntryToVec(const TrustedGroupEntry *entry, void *ctx)
+{
+    GroupEntryVec *vec = (GroupEntryVec *)ctx;
+    TrustedGroupEntry *newEntry = DeepCopyGroupEntry(entry);
+    if (newEntry == NULL) {
+        return true;
+    }
+    if (vec->pushBackT(vec, newEntry) == NULL) {
+        LOGE("[DB]: Failed to push entry to vec!");
+        DestroyGroupEntry(newEntry);
+    }
+    return true;
+}
+
+static bool CopyDeviceEntryToVec(const TrustedDeviceEntry *entry, void *ctx)
+{
+    DeviceEntryVec *vec = (DeviceEntryVec *)ctx;
+    TrustedDeviceEntry *newEntry = DeepCopyDeviceEntry(entry);
+    if (newEntry == NULL) {
+        return true;
+    }
+    if (vec->pushBackT(vec, newEntry) == NULL) {
+        LOGE("[DB]: Failed to push entry to vec!");
+        DestroyDeviceEntry(newEntry);
+    }
+    return true;
+}
+
+static int32_t QueryGroupsInner(int32_t osAccountId, const char *subProfileIdStr, const QueryGroupParams *params,
+    GroupEntryVec *vec)
+{
+    return VisitGroupsInner(osAccountId, subProfileIdStr, params, CopyGroupEntryToVec, vec);
+}
+
+static int32_t GetForegroundSubProfile(int32_t osAccountId, char *subProfileIdStr)
+{
+#ifdef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
+    int32_t res = GetForegroundSubProfileIdStr(osAccountId, subProfileIdStr, SUB_PROFILE_ID_CHAR_MAX_LEN);
+    if (res != HC_SUCCESS) {
+        LOGE("[DB]: Failed to get foreground subProfileId string!");
+        return res;
+    }
+#else
+    (void)osAccountId;
+    (void)subProfileIdStr;
+#endif
     return HC_SUCCESS;
 }
 
@@ -1635,13 +2114,10 @@ int32_t QueryGroups(int32_t osAccountId, const QueryGroupParams *params, GroupEn
         return HC_ERR_NULL_PTR;
     }
     char subProfileIdStr[SUB_PROFILE_ID_CHAR_MAX_LEN + 1] = { 0 };
-#ifdef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
-    int32_t res = GetForegroundSubProfileIdStr(osAccountId, subProfileIdStr, SUB_PROFILE_ID_CHAR_MAX_LEN);
+    int32_t res = GetForegroundSubProfile(osAccountId, subProfileIdStr);
     if (res != HC_SUCCESS) {
-        LOGE("[DB]: Failed to get foreground subProfileId string!");
         return res;
     }
-#endif
     return QueryGroupsInner(osAccountId, subProfileIdStr, params, vec);
 }
 
@@ -1651,86 +2127,171 @@ int32_t QueryDevices(int32_t osAccountId, const QueryDeviceParams *params, Devic
         LOGE("[DB]: The input query devices params or vec is NULL!");
         return HC_ERR_NULL_PTR;
     }
-    (void)LockHcMutex(g_databaseMutex);
-    OsAccountTrustedInfo *info = GetTrustedInfoByOsAccountId(osAccountId);
-    if (info == NULL) {
-        UnlockHcMutex(g_databaseMutex);
-        return HC_ERR_INVALID_PARAMS;
+    return VisitDevicesInner(osAccountId, params, CopyDeviceEntryToVec, vec);
+}
+
+int32_t VisitGroups(int32_t osAccountId, const QueryGroupParams *params, GroupEntryVisitor visitor, void *ctx)
+{
+    if ((params == NULL) || (visitor == NULL)) {
+        LOGE("[DB]: The input params or visitor is NULL!");
+        return HC_ERR_NULL_PTR;
     }
-#ifdef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
     char subProfileIdStr[SUB_PROFILE_ID_CHAR_MAX_LEN + 1] = { 0 };
-    int32_t res = GetForegroundSubProfileIdStr(osAccountId, subProfileIdStr, SUB_PROFILE_ID_CHAR_MAX_LEN);
+    int32_t res = GetForegroundSubProfile(osAccountId, subProfileIdStr);
     if (res != HC_SUCCESS) {
-        LOGE("[DB]: Failed to get foreground subProfileId string!");
-        UnlockHcMutex(g_databaseMutex);
         return res;
     }
-#endif
+    return VisitGroupsInner(osAccountId, subProfileIdStr, params, visitor, ctx);
+}
+
+int32_t VisitDevices(int32_t osAccountId, const QueryDeviceParams *params, DeviceEntryVisitor visitor, void *ctx)
+{
+    if ((params == NULL) || (visitor == NULL)) {
+        LOGE("[DB]: The input params or visitor is NULL!");
+        return HC_ERR_NULL_PTR;
+    }
+    return VisitDevicesInner(osAccountId, params, visitor, ctx);
+}
+
+static int32_t SaveTrustedInfoById(int32_t osAccountId)
+{
+    OsAccountTrustedInfo *info = GetTrustedInfoByOsAccountId(osAccountId);
+    if (info == NULL) {
+        return HC_ERR_INVALID_PARAMS;
+    }
+    return SaveTrustedInfoToFile(info);
+}
+
+static int32_t FlushAllTrustedInfo(void)
+{
+    int32_t res = HC_SUCCESS;
+    (void)WriteLockHcRwLock(g_databaseLock);
+    g_isFlushTaskPending = false;
     uint32_t index;
-    TrustedDeviceEntry **entry;
-    FOR_EACH_HC_VECTOR(info->devices, index, entry) {
-        if (!CompareQueryDeviceParams(params, *entry)) {
-            continue;
-        }
-    #ifdef DEVAUTH_ENABLE_OS_ACCOUNT_MULTI_PROFILE
-        if (!IsDeviceExistInGroupForUser(osAccountId, subProfileIdStr, StringGet(&(*entry)->groupId),
-            StringGet(&(*entry)->udid))) {
-            continue;
-        }
-    #endif
-        TrustedDeviceEntry *newEntry = DeepCopyDeviceEntry(*entry);
-        if (newEntry == NULL) {
+    OsAccountTrustedInfo *info;
+    FOR_EACH_HC_VECTOR(g_deviceauthDb, index, info) {
+        if (!info->isDirty) {
             continue;
         }
-        if (vec->pushBackT(vec, newEntry) == NULL) {
-            LOGE("[DB]: Failed to push entry to vec!");
-            DestroyDeviceEntry(newEntry);
+        int32_t saveRes = SaveTrustedInfoToFile(info);
+        if (saveRes != HC_SUCCESS) {
+            LOGE("[DB]: Failed to flush an os account database! [Id]: %" LOG_PUB "d", info->osAccountId);
+            res = saveRes;
         }
     }
-    UnlockHcMutex(g_databaseMutex);
-    return HC_SUCCESS;
+    UnlockHcRwLock(g_databaseLock);
+    return res;
+}
+
+static int32_t PushFlushTask(void);
+
+/*
+ * The caller got success when the save was deferred, so a failed flush is queued again behind the work
+ * pushed in the meantime. Once the retries are used up the failure is reported and the data stays dirty,
+ * the next save or the flush on destroy writes it.
+ */
+static void RetryFlushTask(int32_t res)
+{
+    if (g_flushRetryNum >= MAX_FLUSH_RETRY_NUM) {
+        LOGE("[DB]: Failed to flush the database after retries! [Res]: %" LOG_PUB "d", res);
+        DEV_AUTH_REPORT_FAULT_EVENT_WITH_ERR_CODE(FLUSH_DATABASE_EVENT, PROCESS_FLUSH_DATABASE, res);
+        g_flushRetryNum = 0;
+        return;
+    }
+    g_flushRetryNum++;
+    (void)WriteLockHcRwLock(g_databaseLock);
+    bool shouldPushTask = !g_isFlushTaskPending;
+    g_isFlushTaskPending = true;
+    UnlockHcRwLock(g_databaseLock);
+    if (shouldPushTask && PushFlushTask() != HC_SUCCESS) {
+        LOGE("[DB]: Failed to push the flush retry task!");
+        (void)WriteLockHcRwLock(g_databaseLock);
+        g_isFlushTaskPending = false;
+        UnlockHcRwLock(g_databaseLock);
+    }
+}
+
+static void DoFlushTask(HcTaskBase *task)
+{
+    (void)task;
+    if (g_databaseLock == NULL) {
+        return;
+    }
+    int32_t res = FlushAllTrustedInfo();
+    if (res == HC_SUCCESS) {
+        g_flushRetryNum = 0;
+        return;
+    }
+    RetryFlushTask(res);
+}
+
+static void DestroyFlushTask(HcTaskBase *task)
+{
+    (void)task;
+}
+
+/*
+ * The flush runs on the task thread after the tasks queued before it, so all saves requested
+ * by the running task, e.g. a batch of member additions, are written with a single fsync.
+ */
+static int32_t PushFlushTask(void)
+{
+    HcTaskBase *task = (HcTaskBase *)HcMalloc(sizeof(HcTaskBase), 0);
+    if (task == NULL) {
+        LOGE("[DB]: Failed to allocate flush task!");
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    task->doAction = DoFlushTask;
+    task->destroy = DestroyFlushTask;
+    int32_t res = g_pushFlushTask(task);
+    if (res != HC_SUCCESS) {
+        HcFree(task);
+    }
+    return res;
 }
 
 int32_t SaveOsAccountDb(int32_t osAccountId)
 {
-    (void)LockHcMutex(g_databaseMutex);
+    if (g_pushFlushTask == NULL) {
+        (void)WriteLockHcRwLock(g_databaseLock);
+        int32_t res = SaveTrustedInfoById(osAccountId);
+        UnlockHcRwLock(g_databaseLock);
+        return res;
+    }
+    (void)WriteLockHcRwLock(g_databaseLock);
     OsAccountTrustedInfo *info = GetTrustedInfoByOsAccountId(osAccountId);
     if (info == NULL) {
-        UnlockHcMutex(g_databaseMutex);
+        UnlockHcRwLock(g_databaseLock);
         return HC_ERR_INVALID_PARAMS;
     }
-    HcParcel parcel = CreateParcel(0, 0);
-    if (!SaveInfoToParcel(info, &parcel)) {
-        DeleteParcel(&parcel);
-        UnlockHcMutex(g_databaseMutex);
-        return HC_ERR_MEMORY_COPY;
-    }
-    char filePath[MAX_DB_PATH_LEN] = { 0 };
-    if (!GetOsAccountInfoPath(osAccountId, filePath, MAX_DB_PATH_LEN)) {
-        DeleteParcel(&parcel);
-        UnlockHcMutex(g_databaseMutex);
-        return HC_ERROR;
+    if (info->isDirty) {
+        g_coalescedSaveNum++;
     }
-    if (!SaveParcelToFile(filePath, &parcel)) {
-        DeleteParcel(&parcel);
-        UnlockHcMutex(g_databaseMutex);
-        return HC_ERR_MEMORY_COPY;
+    info->isDirty = true;
+    bool shouldPushTask = !g_isFlushTaskPending;
+    g_isFlushTaskPending = true;
+    UnlockHcRwLock(g_databaseLock);
+    if (shouldPushTask && PushFlushTask() != HC_SUCCESS) {
+        LOGW("[DB]: Failed to defer the flush, save the database synchronously!");
+        return FlushAllTrustedInfo();
     }
-    DeleteParcel(&parcel);
-    UnlockHcMutex(g_databaseMutex);
-    LOGI("[DB]: Save an os account database successfully! [Id]: %" LOG_PUB "d", osAccountId);
     return HC_SUCCESS;
 }
 
+void SetGroupDbFlushScheduler(int32_t (*pushTask)(HcTaskBase *task))
+{
+    g_pushFlushTask = pushTask;
+}
+
 void ReloadOsAccountDb(int32_t osAccountId)
 {
-    if (g_databaseMutex == NULL) {
+    if (g_databaseLock == NULL) {
         LOGE("[DB]: not initialized!");
         return;
     }
-    (void)LockHcMutex(g_databaseMutex);
+    (void)WriteLockHcRwLock(g_databaseLock);
     LoadOsAccountDbCe(osAccountId);
-    UnlockHcMutex(g_databaseMutex);
+    UnlockHcRwLock(g_databaseLock);
 }
 
 #ifdef DEV_AUTH_HIVIEW_ENABLE
@@ -1751,20 +2312,22 @@ static void LoadAllAccountsData(void)
 
 static void DevAuthDataBaseDump(int fd)
 {
-    if (g_databaseMutex == NULL) {
-        LOGE("[DB]: Init mutex failed");
+    if (g_databaseLock == NULL) {
+        LOGE("[DB]: Init lock failed");
         return;
     }
-    (void)LockHcMutex(g_databaseMutex);
+    (void)WriteLockHcRwLock(g_databaseLock);
     if (IsOsAccountSupported()) {
         LoadAllAccountsData();
     }
     uint32_t index;
     OsAccountTrustedInfo *info;
     FOR_EACH_HC_VECTOR(g_deviceauthDb, index, info) {
+        DecodeAllPendingDevices(info);
         DumpGroupsAndDevices(fd, info->osAccountId, &info->groups, &info->devices);
     }
-    UnlockHcMutex(g_databaseMutex);
+    dprintf(fd, "|%-12s = %-67u|\n", "savedFsyncs", g_coalescedSaveNum);
+    UnlockHcRwLock(g_databaseLock);
 }
 #endif
 
@@ -1859,16 +2422,16 @@ static void OnSubProfileDeleted(int32_t osAccountId, const char *subProfileIdStr
 
 int32_t InitDatabase(void)
 {
-    if (g_databaseMutex == NULL) {
-        g_databaseMutex = (HcMutex *)HcMalloc(sizeof(HcMutex), 0);
-        if (g_databaseMutex == NULL) {
-            LOGE("[DB]: Alloc databaseMutex failed");
+    if (g_databaseLock == NULL) {
+        g_databaseLock = (HcRwLock *)HcMalloc(sizeof(HcRwLock), 0);
+        if (g_databaseLock == NULL) {
+            LOGE("[DB]: Alloc databaseLock failed");
             return HC_ERR_ALLOC_MEMORY;
         }
-        if (InitHcMutex(g_databaseMutex, false) != HC_SUCCESS) {
-            LOGE("[DB]: Init mutex failed");
-            HcFree(g_databaseMutex);
-            g_databaseMutex = NULL;
+        if (InitHcRwLock(g_databaseLock) != HC_SUCCESS) {
+            LOGE("[DB]: Init rwlock failed");
+            HcFree(g_databaseLock);
+            g_databaseLock = NULL;
             return HC_ERROR;
         }
     }
@@ -1894,16 +2457,17 @@ void DestroyDatabase(void)
     SetProfileDeleteCallbackForGroup(NULL);
     DestroyStrVector(&g_inactiveDeviceVec);
 #endif
-    (void)LockHcMutex(g_databaseMutex);
+    g_pushFlushTask = NULL;
+    (void)FlushAllTrustedInfo();
+    (void)WriteLockHcRwLock(g_databaseLock);
     uint32_t index;
     OsAccountTrustedInfo *info;
     FOR_EACH_HC_VECTOR(g_deviceauthDb, index, info) {
-        ClearGroupEntryVec(&info->groups);
-        ClearDeviceEntryVec(&info->devices);
+        ClearOsAccountTrustedInfo(info);
     }
     DESTROY_HC_VECTOR(DeviceAuthDb, &g_deviceauthDb);
-    UnlockHcMutex(g_databaseMutex);
-    DestroyHcMutex(g_databaseMutex);
-    HcFree(g_databaseMutex);
-    g_databaseMutex = NULL;
+    UnlockHcRwLock(g_databaseLock);
+    DestroyHcRwLock(g_databaseLock);
+    HcFree(g_databaseLock);
+    g_databaseLock = NULL;
 }
\ No newline at end of file
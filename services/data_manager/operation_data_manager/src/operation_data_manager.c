@@ -266,6 +266,12 @@ static bool SaveTainedOperation(int32_t osAccountId)
     return res;
 }
 
+static void FreeFileData(char *data, uint32_t length)
+{
+    (void)length;
+    HcFree(data);
+}
+
 static bool ReadParcelFromFile(const char *filePath, HcParcel *parcel)
 {
     FileHandle file;
@@ -281,7 +287,14 @@ static bool ReadParcelFromFile(const char *filePath, HcParcel *parcel)
         HcFileClose(file);
         return false;
     }
-    char *fileData = (char*)HcMalloc(fileSize, 0);
+    /* decode straight from the mapped file, the mapping stays valid after the file is closed */
+    char *fileData = HcFileMapRead(file, fileSize);
+    if (fileData != NULL) {
+        HcFileClose(file);
+        *parcel = CreateReadOnlyParcel(fileData, (uint32_t)fileSize, HcFileUnmap);
+        return true;
+    }
+    fileData = (char *)HcMalloc(fileSize, 0);
     if (fileData == NULL) {
         LOGE("[Operation]: Failed to allocate fileData memory!");
         HcFileClose(file);
@@ -294,12 +307,7 @@ static bool ReadParcelFromFile(const char *filePath, HcParcel *parcel)
         return false;
     }
     HcFileClose(file);
-    if (!ParcelWrite(parcel, fileData, fileSize)) {
-        HcFree(fileData);
-        LOGE("[Operation]: parcel write error!");
-        return false;
-    }
-    HcFree(fileData);
+    *parcel = CreateReadOnlyParcel(fileData, (uint32_t)fileSize, FreeFileData);
     return true;
 }
 
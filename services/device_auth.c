@@ -30,6 +30,7 @@
 #include "hc_init_protection.h"
 #include "hc_log.h"
 #include "hc_time.h"
+#include "hidump_adapter.h"
 #include "hisysevent_common.h"
 #include "hitrace_adapter.h"
 #include "json_utils.h"
@@ -1067,6 +1068,8 @@ static int32_t InitAllModules(void)
     RETURN_IF_INIT_FAILED(res, InitDevSessionManager, CLEAN_IDENTITY_SERVICE);
     (void)InitGroupAuthManager();
     RETURN_IF_INIT_FAILED(res, InitTaskManager, CLEAN_DEVSESSION);
+    SetGroupDbFlushScheduler(PushTask);
+    SetCredDbFlushScheduler(PushTask);
     RETURN_IF_INIT_FAILED(res, InitLightSessionManager, CLEAN_ALL);
     return res;
 }
@@ -1081,6 +1084,42 @@ static void InitPseudonymModule(void)
     manager->loadPseudonymData();
 }
 
+static void OnOsAccountChangedForKeyCache(int32_t osAccountId)
+{
+    const AlgLoader *loader = GetLoaderInstance();
+    if (loader->clearKeyExistCache != NULL) {
+        loader->clearKeyExistCache(osAccountId);
+    }
+}
+
+#ifdef DEV_AUTH_HIVIEW_ENABLE
+static void KeyExistCacheDump(int fd)
+{
+    const AlgLoader *loader = GetLoaderInstance();
+    if (loader->getKeyExistCacheStats == NULL) {
+        dprintf(fd, "key exist cache is not supported!\n");
+        return;
+    }
+    KeyExistCacheStats stats = { 0 };
+    loader->getKeyExistCacheStats(&stats);
+    uint64_t total = stats.hitCount + stats.missCount;
+    uint64_t hitRate = (total == 0) ? 0 : (stats.hitCount * 100 / total);
+    dprintf(fd, "|-------------KeyExistCache--------------|\n");
+    dprintf(fd, "|%-12s|%-27" PRIu64 "|\n", "hit", stats.hitCount);
+    dprintf(fd, "|%-12s|%-27" PRIu64 "|\n", "miss", stats.missCount);
+    dprintf(fd, "|%-12s|%-26" PRIu64 "%%|\n", "hitRate", hitRate);
+    dprintf(fd, "|%-12s|%-27u|\n", "entries", stats.entryCount);
+    dprintf(fd, "|-------------KeyExistCache--------------|\n");
+}
+#endif
+
+static void InitKeyExistCacheEvents(void)
+{
+    AddOsAccountEventCallback(KEY_EXIST_CACHE_CALLBACK, OnOsAccountChangedForKeyCache,
+        OnOsAccountChangedForKeyCache);
+    DEV_AUTH_REG_KEY_CACHE_DUMP_FUNC(KeyExistCacheDump);
+}
+
 DEVICE_AUTH_API_PUBLIC int InitDeviceAuthService(void)
 {
     LOGI("[Service]: Start to init device auth service!");
@@ -1112,6 +1151,7 @@ DEVICE_AUTH_API_PUBLIC int InitDeviceAuthService(void)
         return res;
     }
     INIT_PERFORMANCE_DUMPER();
+    InitKeyExistCacheEvents();
     InitPseudonymModule();
     InitAccountTaskManager();
     SetInitStatus();
@@ -1143,6 +1183,7 @@ DEVICE_AUTH_API_PUBLIC void DestroyDeviceAuthService(void)
     DestroyCallbackManager();
     DESTROY_PERFORMANCE_DUMPER();
     DestroyPseudonymManager();
+    RemoveOsAccountEventCallback(KEY_EXIST_CACHE_CALLBACK);
     DestroyOsAccountAdapter();
     SetDeInitStatus();
     LOGI("[End]: [Service]: Destroy device auth service successfully!");
@@ -21,10 +21,12 @@
 
 #define PERFORM_DUMP_ARG "performance"
 #define OPERATION_DUMP_ARG "operation"
+#define KEY_CACHE_DUMP_ARG "keycache"
 
 typedef void (*DumpCallBack)(int);
 typedef void (*CredDumpCallBack)(int);
 typedef void (*OperationDumpCallBack)(int);
+typedef void (*KeyCacheDumpCallBack)(int);
 typedef void (*PerformanceDumpCallBack)(int, StringVector *);
 
 #ifndef DEV_AUTH_HIVIEW_ENABLE
@@ -33,6 +35,7 @@ typedef void (*PerformanceDumpCallBack)(int, StringVector *);
 #define DEV_AUTH_REG_DUMP_FUNC(func)
 #define DEV_AUTH_REG_CRED_DUMP_FUNC(func)
 #define DEV_AUTH_REG_OPERATION_DUMP_FUNC(func)
+#define DEV_AUTH_REG_KEY_CACHE_DUMP_FUNC(func)
 #define DEV_AUTH_REG_PERFORM_DUMP_FUNC(func)
 
 #else
@@ -41,6 +44,7 @@ typedef void (*PerformanceDumpCallBack)(int, StringVector *);
 #define DEV_AUTH_REG_DUMP_FUNC(func) RegisterDumpFunc(func)
 #define DEV_AUTH_REG_CRED_DUMP_FUNC(func) RegisterCredDumpFunc(func)
 #define DEV_AUTH_REG_OPERATION_DUMP_FUNC(func) RegisterOperationDumpFunc(func)
+#define DEV_AUTH_REG_KEY_CACHE_DUMP_FUNC(func) RegisterKeyCacheDumpFunc(func)
 #define DEV_AUTH_REG_PERFORM_DUMP_FUNC(func) RegisterPerformDumpFunc(func)
 
 #ifdef __cplusplus
@@ -52,6 +56,7 @@ void DevAuthDump(int fd, StringVector *strArgVec);
 void RegisterDumpFunc(DumpCallBack func);
 void RegisterCredDumpFunc(CredDumpCallBack func);
 void RegisterOperationDumpFunc(OperationDumpCallBack func);
+void RegisterKeyCacheDumpFunc(KeyCacheDumpCallBack func);
 void RegisterPerformDumpFunc(PerformanceDumpCallBack func);
 
 #ifdef __cplusplus
@@ -59,6 +59,8 @@
 #define COMMON_EVENT "CommonEvent"
 #define CACHE_COMMON_EVENT "CacheCommonEvent"
 
+#define FLUSH_DATABASE_EVENT "FlushDatabase"
+
 #define ANONYMOUS_UDID_LEN 12
 
 #define DEFAULT_GROUP_TYPE 0
@@ -106,6 +108,8 @@ enum DevAuthReportProcessCode {
 
     PROCESS_COMMON_EVENT = 4200,                //4200
     PROCESS_CACHE_COMMON_EVENT,                 //4201
+
+    PROCESS_FLUSH_DATABASE = 4250,              //4250
 };
 
 #define DEFAULT_PNAMEID "device_auth"
@@ -28,7 +28,8 @@ typedef enum {
     ASY_TOKEN_DATA_CALLBACK,
     SYM_TOKEN_DATA_CALLBACK,
     PSEUDONYM_DATA_CALLBACK,
-    CRED_DATA_CALLBACK
+    CRED_DATA_CALLBACK,
+    KEY_EXIST_CACHE_CALLBACK
 } EventCallbackId;
 
 typedef void (*OsAccountCallbackFunc)(int32_t osAccountId);
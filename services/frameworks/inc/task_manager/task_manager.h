@@ -25,6 +25,8 @@ extern "C" {
 int32_t InitTaskManager(void);
 void DestroyTaskManager(void);
 int32_t PushTask(HcTaskBase *baseTask);
+/* Tasks pushed with the same session id are executed in push order on the same worker thread. */
+int32_t PushSessionTask(int64_t sessionId, HcTaskBase *baseTask);
 
 #ifdef __cplusplus
 }
@@ -204,7 +204,10 @@ int32_t CreateAccountAuthSession(int32_t *sessionId, const CJson *in, CJson *out
         return HC_ERROR;
     }
     LoadAccountAuthPlugin();
+    /* Auth sessions are driven from several session workers, plugin session calls are kept one at a time. */
+    (void)LockHcMutex(&g_taskMutex);
     int32_t res = CreateAuthSession(sessionId, in, out);
+    UnlockHcMutex(&g_taskMutex);
     if (res != HC_SUCCESS) {
         LOGE("[ACCOUNT_TASK_MGR]: create auth session failed!");
         UnloadAccountAuthPlugin();
@@ -227,7 +230,10 @@ int32_t ProcessAccountAuthSession(int32_t *sessionId, const CJson *in, CJson *ou
         LOGE("[ACCOUNT_TASK_MGR]: auth session record not exist!");
         return HC_ERR_SESSION_NOT_EXIST;
     }
-    return ProcessAuthSession(sessionId, in, out, status);
+    (void)LockHcMutex(&g_taskMutex);
+    int32_t res = ProcessAuthSession(sessionId, in, out, status);
+    UnlockHcMutex(&g_taskMutex);
+    return res;
 }
 
 int32_t DestroyAccountAuthSession(int32_t sessionId)
@@ -240,7 +246,9 @@ int32_t DestroyAccountAuthSession(int32_t sessionId)
         LOGE("[ACCOUNT_TASK_MGR]: auth session record not exist!");
         return HC_ERR_SESSION_NOT_EXIST;
     }
+    (void)LockHcMutex(&g_taskMutex);
     int32_t res = DestroyAuthSession(sessionId);
+    UnlockHcMutex(&g_taskMutex);
     RemoveAuthSessionRecord(sessionId);
     UnloadAccountAuthPlugin();
     return res;
@@ -21,6 +21,7 @@
 static DumpCallBack g_dumpCallBack = NULL;
 static CredDumpCallBack g_credDumpCallBack = NULL;
 static OperationDumpCallBack g_operationDumpCallBack = NULL;
+static KeyCacheDumpCallBack g_keyCacheDumpCallBack = NULL;
 static PerformanceDumpCallBack g_performDumpCallback = NULL;
 
 static void DumpByArgs(int fd, StringVector *strArgVec)
@@ -32,6 +33,8 @@ static void DumpByArgs(int fd, StringVector *strArgVec)
         }
     } else if (IsStrEqual(StringGet(&strArg), OPERATION_DUMP_ARG) && g_operationDumpCallBack != NULL) {
         g_operationDumpCallBack(fd);
+    } else if (IsStrEqual(StringGet(&strArg), KEY_CACHE_DUMP_ARG) && g_keyCacheDumpCallBack != NULL) {
+        g_keyCacheDumpCallBack(fd);
     } else {
         LOGE("Invalid dumper command!");
     }
@@ -70,6 +73,11 @@ void RegisterOperationDumpFunc(OperationDumpCallBack func)
     g_operationDumpCallBack = func;
 }
 
+void RegisterKeyCacheDumpFunc(KeyCacheDumpCallBack func)
+{
+    g_keyCacheDumpCallBack = func;
+}
+
 void RegisterPerformDumpFunc(PerformanceDumpCallBack func)
 {
     g_performDumpCallback = func;
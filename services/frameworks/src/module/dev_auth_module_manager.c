@@ -17,6 +17,7 @@
 #include "common_defs.h"
 #include "das_module.h"
 #include "hc_log.h"
+#include "hc_mutex.h"
 #include "hc_types.h"
 #include "hc_vector.h"
 #include "account_module.h"
@@ -29,6 +30,11 @@ IMPLEMENT_HC_VECTOR(AuthModuleVec, AuthModuleBase *, 2)
 
 static AuthModuleVec g_authModuleVec;
 static VersionStruct g_version;
+/*
+ * Session steps run on several workers, while the legacy das and account modules keep their task tables
+ * in unlocked globals. Every call into a module is serialized here, reentrant for modules calling back.
+ */
+static HcMutex g_moduleMutex;
 
 static AuthModuleBase *GetModule(int moduleType)
 {
@@ -92,7 +98,9 @@ int32_t RegisterLocalIdentity(const AuthModuleParams *moduleParams, int moduleTy
     }
     TokenManagerParams params = BuildTokenManagerParams(moduleParams);
     DasAuthModule *dasModule = (DasAuthModule *)module;
+    (void)LockHcMutex(&g_moduleMutex);
     int32_t res = dasModule->registerLocalIdentity(&params);
+    UnlockHcMutex(&g_moduleMutex);
     if (res != HC_SUCCESS) {
         LOGE("Register local identity failed, res: %" LOG_PUB "x", res);
         return res;
@@ -114,7 +122,9 @@ int32_t UnregisterLocalIdentity(const AuthModuleParams *moduleParams, int module
     }
     TokenManagerParams params = BuildTokenManagerParams(moduleParams);
     DasAuthModule *dasModule = (DasAuthModule *)module;
+    (void)LockHcMutex(&g_moduleMutex);
     int32_t res = dasModule->unregisterLocalIdentity(&params);
+    UnlockHcMutex(&g_moduleMutex);
     if (res != HC_SUCCESS) {
         LOGE("Unregister local identity failed, res: %" LOG_PUB "x", res);
         return res;
@@ -136,7 +146,9 @@ int32_t DeletePeerAuthInfo(const AuthModuleParams *moduleParams, int moduleType)
     }
     TokenManagerParams params = BuildTokenManagerParams(moduleParams);
     DasAuthModule *dasModule = (DasAuthModule *)module;
+    (void)LockHcMutex(&g_moduleMutex);
     int32_t res = dasModule->deletePeerAuthInfo(&params);
+    UnlockHcMutex(&g_moduleMutex);
     if (res != HC_SUCCESS) {
         LOGE("Delete peer authInfo failed, res: %" LOG_PUB "x", res);
         return res;
@@ -159,7 +171,9 @@ int32_t GetPublicKey(int moduleType, AuthModuleParams *moduleParams, Uint8Buff *
     }
     TokenManagerParams params = BuildTokenManagerParams(moduleParams);
     DasAuthModule *dasModule = (DasAuthModule *)module;
+    (void)LockHcMutex(&g_moduleMutex);
     int32_t res = dasModule->getPublicKey(&params, returnPk);
+    UnlockHcMutex(&g_moduleMutex);
     if (res != HC_SUCCESS) {
         LOGE("Get public key failed, res: %" LOG_PUB "d", res);
         return res;
@@ -178,7 +192,10 @@ int32_t CheckMsgRepeatability(const CJson *in, int moduleType)
         LOGE("Failed to get module for das.");
         return HC_ERR_MODULE_NOT_FOUNT;
     }
-    return module->isMsgNeedIgnore(in) ? HC_ERR_IGNORE_MSG : HC_SUCCESS;
+    (void)LockHcMutex(&g_moduleMutex);
+    bool isNeedIgnore = module->isMsgNeedIgnore(in);
+    UnlockHcMutex(&g_moduleMutex);
+    return isNeedIgnore ? HC_ERR_IGNORE_MSG : HC_SUCCESS;
 }
 
 int32_t CreateTask(int32_t *taskId, const CJson *in, CJson *out, int moduleType)
@@ -193,7 +210,9 @@ int32_t CreateTask(int32_t *taskId, const CJson *in, CJson *out, int moduleType)
         LOGE("Failed to get module!");
         return HC_ERR_MODULE_NOT_FOUNT;
     }
+    (void)LockHcMutex(&g_moduleMutex);
     int32_t res = module->createTask(taskId, in, out);
+    UnlockHcMutex(&g_moduleMutex);
     if (res != HC_SUCCESS) {
         LOGE("Create task failed, taskId: %" LOG_PUB "d, moduleType: %" LOG_PUB "d, res: %" LOG_PUB "d", *taskId,
             moduleType, res);
@@ -214,7 +233,9 @@ int32_t ProcessTask(int taskId, const CJson *in, CJson *out, int32_t *status, in
         LOGE("Failed to get module!");
         return HC_ERR_MODULE_NOT_FOUNT;
     }
+    (void)LockHcMutex(&g_moduleMutex);
     int32_t res = module->processTask(taskId, in, out, status);
+    UnlockHcMutex(&g_moduleMutex);
     if (res != HC_SUCCESS) {
         LOGE("Process task failed, taskId: %" LOG_PUB "d, moduleType: %" LOG_PUB "d, res: %" LOG_PUB "d.",
             taskId, moduleType, res);
@@ -235,14 +256,20 @@ void DestroyTask(int taskId, int moduleType)
     if (module == NULL) {
         return;
     }
+    (void)LockHcMutex(&g_moduleMutex);
     module->destroyTask(taskId);
+    UnlockHcMutex(&g_moduleMutex);
 }
 
 int32_t InitModules(void)
 {
+    int32_t res = InitHcMutex(&g_moduleMutex, true);
+    if (res != HC_SUCCESS) {
+        LOGE("[ModuleMgr]: Init module mutex fail. [Res]: %" LOG_PUB "d", res);
+        return res;
+    }
     g_authModuleVec = CREATE_HC_VECTOR(AuthModuleVec);
     InitGroupAndModuleVersion(&g_version);
-    int32_t res;
     const AuthModuleBase *dasModule = GetDasModule();
     if (dasModule != NULL) {
         res = dasModule->init();
@@ -281,11 +308,14 @@ void DestroyModules(void)
 {
     uint32_t index;
     AuthModuleBase **module;
+    (void)LockHcMutex(&g_moduleMutex);
     FOR_EACH_HC_VECTOR(g_authModuleVec, index, module) {
         (*module)->destroy();
     }
     DESTROY_HC_VECTOR(AuthModuleVec, &g_authModuleVec);
     (void)memset_s(&g_version, sizeof(VersionStruct), 0, sizeof(VersionStruct));
+    UnlockHcMutex(&g_moduleMutex);
+    DestroyHcMutex(&g_moduleMutex);
 }
 
 int32_t AddAuthModulePlugin(const AuthModuleBase *plugin)
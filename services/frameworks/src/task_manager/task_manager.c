@@ -17,53 +17,107 @@
 
 #include "device_auth_defines.h"
 #include "hc_log.h"
+#include "securec.h"
 
-static HcTaskThread *g_taskThread = NULL;
+#ifndef DEV_AUTH_WORK_THREAD_NUM
+#define DEV_AUTH_WORK_THREAD_NUM 1
+#endif
 
-int32_t PushTask(HcTaskBase *baseTask)
+#define WORK_THREAD_NAME_LEN 16
+
+/*
+ * Worker 0 runs every task without a session affinity, so those tasks keep being executed one by one
+ * in push order. Session tasks are spread over all workers by session id, all tasks of one session
+ * land on the same worker and therefore keep their order.
+ */
+static HcTaskThread *g_taskThreads[DEV_AUTH_WORK_THREAD_NUM] = { NULL };
+
+static uint32_t GetSessionWorkerIndex(int64_t sessionId)
+{
+    uint64_t key = (uint64_t)sessionId;
+    return (uint32_t)((key ^ (key >> 32)) % DEV_AUTH_WORK_THREAD_NUM);
+}
+
+static int32_t PushTaskToWorker(uint32_t index, HcTaskBase *baseTask)
 {
-    if (g_taskThread == NULL) {
+    HcTaskThread *taskThread = g_taskThreads[index];
+    if (taskThread == NULL) {
         LOGE("Task thread is NULL!");
         return HC_ERR_NULL_PTR;
     }
-    g_taskThread->pushTask(g_taskThread, baseTask);
+    taskThread->pushTask(taskThread, baseTask);
     return HC_SUCCESS;
 }
 
-int32_t InitTaskManager(void)
+int32_t PushTask(HcTaskBase *baseTask)
 {
-    if (g_taskThread != NULL) {
-        LOGD("Task thread is running!");
-        return HC_SUCCESS;
+    return PushTaskToWorker(0, baseTask);
+}
+
+int32_t PushSessionTask(int64_t sessionId, HcTaskBase *baseTask)
+{
+    return PushTaskToWorker(GetSessionWorkerIndex(sessionId), baseTask);
+}
+
+static HcTaskThread *CreateWorker(uint32_t index)
+{
+    char threadName[WORK_THREAD_NAME_LEN] = "DevAuthWork";
+    if (index != 0 && sprintf_s(threadName, sizeof(threadName), "DevAuthWork%u", index) <= 0) {
+        LOGE("Failed to generate thread name!");
+        return NULL;
     }
-    g_taskThread = (HcTaskThread *)HcMalloc(sizeof(HcTaskThread), 0);
-    if (g_taskThread == NULL) {
-        return HC_ERR_ALLOC_MEMORY;
+    HcTaskThread *taskThread = (HcTaskThread *)HcMalloc(sizeof(HcTaskThread), 0);
+    if (taskThread == NULL) {
+        return NULL;
     }
-    int32_t res = InitHcTaskThread(g_taskThread, DEV_AUTH_WORK_THREAD_STACK_SIZE, "DevAuthWork");
+    int32_t res = InitHcTaskThread(taskThread, DEV_AUTH_WORK_THREAD_STACK_SIZE, threadName);
     if (res != HC_SUCCESS) {
         LOGE("Failed to init task thread! res: %" LOG_PUB "d", res);
-        HcFree(g_taskThread);
-        g_taskThread = NULL;
-        return HC_ERR_INIT_FAILED;
+        HcFree(taskThread);
+        return NULL;
     }
-    res = g_taskThread->startThread(g_taskThread);
+    res = taskThread->startThread(taskThread);
     if (res != HC_SUCCESS) {
-        DestroyHcTaskThread(g_taskThread);
-        HcFree(g_taskThread);
-        g_taskThread = NULL;
+        DestroyHcTaskThread(taskThread);
+        HcFree(taskThread);
         LOGE("Failed to start thread! res: %" LOG_PUB "d", res);
-        return HC_ERR_INIT_FAILED;
+        return NULL;
+    }
+    return taskThread;
+}
+
+static void DestroyWorker(uint32_t index)
+{
+    HcTaskThread *taskThread = g_taskThreads[index];
+    if (taskThread == NULL) {
+        return;
+    }
+    taskThread->stopAndClear(taskThread);
+    DestroyHcTaskThread(taskThread);
+    HcFree(taskThread);
+    g_taskThreads[index] = NULL;
+}
+
+int32_t InitTaskManager(void)
+{
+    if (g_taskThreads[0] != NULL) {
+        LOGD("Task thread is running!");
+        return HC_SUCCESS;
+    }
+    for (uint32_t i = 0; i < DEV_AUTH_WORK_THREAD_NUM; i++) {
+        g_taskThreads[i] = CreateWorker(i);
+        if (g_taskThreads[i] == NULL) {
+            DestroyTaskManager();
+            return HC_ERR_INIT_FAILED;
+        }
     }
+    LOGI("Task manager started. [WorkerNum]: %" LOG_PUB "d", DEV_AUTH_WORK_THREAD_NUM);
     return HC_SUCCESS;
 }
 
 void DestroyTaskManager(void)
 {
-    if (g_taskThread != NULL) {
-        g_taskThread->stopAndClear(g_taskThread);
-        DestroyHcTaskThread(g_taskThread);
-        HcFree(g_taskThread);
-        g_taskThread = NULL;
+    for (uint32_t i = 0; i < DEV_AUTH_WORK_THREAD_NUM; i++) {
+        DestroyWorker(i);
     }
 }
@@ -1436,7 +1436,7 @@ static int OnChannelOpenedCb(int64_t requestId, int result)
         return HC_ERR_ALLOC_MEMORY;
     }
     InitSoftBusTask(task, requestId);
-    if (PushTask((HcTaskBase *)task) != HC_SUCCESS) {
+    if (PushSessionTask(requestId, (HcTaskBase *)task) != HC_SUCCESS) {
         HcFree(task);
         CloseDevSession(requestId);
         return HC_ERR_INIT_TASK_FAIL;
@@ -2017,6 +2017,7 @@ int32_t InitAndPushGMTask(int32_t osAccountId, int32_t opCode, int64_t reqId, CJ
     if (IsCallerExtPart(opCode, params)) {
         IncreaseLoadCount();
     }
+    /* Group tasks do not touch any device session, they stay on worker 0 to keep group changes in order. */
     if (PushTask((HcTaskBase *)task) != HC_SUCCESS) {
         if (IsCallerExtPart(opCode, params)) {
             DecreaseLoadCount();
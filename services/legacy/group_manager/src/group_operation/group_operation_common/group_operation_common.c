@@ -85,6 +85,51 @@ static bool IsGroupFriend(const char *appId, const TrustedGroupEntry *entry)
     return false;
 }
 
+static bool CountGroupVisitor(const TrustedGroupEntry *entry, void *ctx)
+{
+    (void)entry;
+    (*(uint32_t *)ctx)++;
+    return true;
+}
+
+static bool CopyGroupEntryVisitor(const TrustedGroupEntry *entry, void *ctx)
+{
+    *(TrustedGroupEntry **)ctx = DeepCopyGroupEntry(entry);
+    return false;
+}
+
+static bool CopyDeviceEntryVisitor(const TrustedDeviceEntry *entry, void *ctx)
+{
+    *(TrustedDeviceEntry **)ctx = DeepCopyDeviceEntry(entry);
+    return false;
+}
+
+static bool MarkGroupFoundVisitor(const TrustedGroupEntry *entry, void *ctx)
+{
+    (void)entry;
+    *(bool *)ctx = true;
+    return false;
+}
+
+static bool MarkDeviceFoundVisitor(const TrustedDeviceEntry *entry, void *ctx)
+{
+    (void)entry;
+    *(bool *)ctx = true;
+    return false;
+}
+
+static QueryDeviceParams BuildDeviceIdParams(const char *deviceId, bool isUdid, const char *groupId)
+{
+    QueryDeviceParams params = InitQueryDeviceParams();
+    params.groupId = groupId;
+    if (isUdid) {
+        params.udid = deviceId;
+    } else {
+        params.authId = deviceId;
+    }
+    return params;
+}
+
 static uint32_t GetGroupNumByOwner(int32_t osAccountId, const char *ownerName)
 {
     if (ownerName == NULL) {
@@ -94,43 +139,23 @@ static uint32_t GetGroupNumByOwner(int32_t osAccountId, const char *ownerName)
     uint32_t count = 0;
     QueryGroupParams queryParams = InitQueryGroupParams();
     queryParams.ownerName = ownerName;
-    GroupEntryVec groupEntryVec = CreateGroupEntryVec();
-    int32_t result = QueryGroups(osAccountId, &queryParams, &groupEntryVec);
-    if (result != HC_SUCCESS) {
+    if (VisitGroups(osAccountId, &queryParams, CountGroupVisitor, &count) != HC_SUCCESS) {
         LOGE("Failed to query groups!");
-        ClearGroupEntryVec(&groupEntryVec);
-        return count;
+        return 0;
     }
-    count = HC_VECTOR_SIZE(&groupEntryVec);
-    ClearGroupEntryVec(&groupEntryVec);
     return count;
 }
 
 TrustedDeviceEntry *GetTrustedDeviceEntryById(int32_t osAccountId, const char *deviceId, bool isUdid,
     const char *groupId)
 {
-    QueryDeviceParams params = InitQueryDeviceParams();
-    DeviceEntryVec deviceEntryVec = CreateDeviceEntryVec();
-    params.groupId = groupId;
-    if (isUdid) {
-        params.udid = deviceId;
-    } else {
-        params.authId = deviceId;
-    }
-    if (QueryDevices(osAccountId, &params, &deviceEntryVec) != HC_SUCCESS) {
-        ClearDeviceEntryVec(&deviceEntryVec);
+    QueryDeviceParams params = BuildDeviceIdParams(deviceId, isUdid, groupId);
+    TrustedDeviceEntry *returnEntry = NULL;
+    if (VisitDevices(osAccountId, &params, CopyDeviceEntryVisitor, &returnEntry) != HC_SUCCESS) {
         LOGE("Query trusted devices failed!");
         return NULL;
     }
-    uint32_t index;
-    TrustedDeviceEntry **deviceEntry;
-    FOR_EACH_HC_VECTOR(deviceEntryVec, index, deviceEntry) {
-        TrustedDeviceEntry *returnEntry = DeepCopyDeviceEntry(*deviceEntry);
-        ClearDeviceEntryVec(&deviceEntryVec);
-        return returnEntry;
-    }
-    ClearDeviceEntryVec(&deviceEntryVec);
-    return NULL;
+    return returnEntry;
 }
 
 TrustedGroupEntry *GetGroupEntryById(int32_t osAccountId, const char *groupId)
@@ -139,23 +164,14 @@ TrustedGroupEntry *GetGroupEntryById(int32_t osAccountId, const char *groupId)
         LOGE("The input groupId is NULL!");
         return NULL;
     }
-    uint32_t index;
-    TrustedGroupEntry **entry = NULL;
-    GroupEntryVec groupEntryVec = CreateGroupEntryVec();
     QueryGroupParams params = InitQueryGroupParams();
     params.groupId = groupId;
-    if (QueryGroups(osAccountId, &params, &groupEntryVec) != HC_SUCCESS) {
+    TrustedGroupEntry *returnEntry = NULL;
+    if (VisitGroups(osAccountId, &params, CopyGroupEntryVisitor, &returnEntry) != HC_SUCCESS) {
         LOGE("Failed to query groups!");
-        ClearGroupEntryVec(&groupEntryVec);
         return NULL;
     }
-    FOR_EACH_HC_VECTOR(groupEntryVec, index, entry) {
-        TrustedGroupEntry *returnEntry = DeepCopyGroupEntry(*entry);
-        ClearGroupEntryVec(&groupEntryVec);
-        return returnEntry;
-    }
-    ClearGroupEntryVec(&groupEntryVec);
-    return NULL;
+    return returnEntry;
 }
 
 bool IsTrustedDeviceInGroup(int32_t osAccountId, const char *groupId, const char *deviceId, bool isUdid)
@@ -164,12 +180,13 @@ bool IsTrustedDeviceInGroup(int32_t osAccountId, const char *groupId, const char
         LOGE("The input groupId or deviceId is NULL!");
         return false;
     }
-    TrustedDeviceEntry *entry = GetTrustedDeviceEntryById(osAccountId, deviceId, isUdid, groupId);
-    if (entry == NULL) {
+    QueryDeviceParams params = BuildDeviceIdParams(deviceId, isUdid, groupId);
+    bool isFound = false;
+    if (VisitDevices(osAccountId, &params, MarkDeviceFoundVisitor, &isFound) != HC_SUCCESS) {
+        LOGE("Query trusted devices failed!");
         return false;
     }
-    DestroyDeviceEntry(entry);
-    return true;
+    return isFound;
 }
 
 int32_t CheckGroupNumLimit(int32_t osAccountId, int32_t groupType, const char *appId)
@@ -231,12 +248,14 @@ bool IsGroupExistByGroupId(int32_t osAccountId, const char *groupId)
         LOGE("The input groupId is NULL!");
         return false;
     }
-    TrustedGroupEntry *entry = GetGroupEntryById(osAccountId, groupId);
-    if (entry == NULL) {
+    QueryGroupParams params = InitQueryGroupParams();
+    params.groupId = groupId;
+    bool isFound = false;
+    if (VisitGroups(osAccountId, &params, MarkGroupFoundVisitor, &isFound) != HC_SUCCESS) {
+        LOGE("Failed to query groups!");
         return false;
     }
-    DestroyGroupEntry(entry);
-    return true;
+    return isFound;
 }
 
 int32_t CheckGroupAccessible(int32_t osAccountId, const char *groupId, const char *appId)
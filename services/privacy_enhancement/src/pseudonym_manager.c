@@ -19,7 +19,7 @@
 #include "hc_dev_info.h"
 #include "hc_file.h"
 #include "hc_log.h"
-#include "hc_mutex.h"
+#include "hc_rwlock.h"
 #include "hc_time.h"
 #include "hc_types.h"
 #include "hc_vector.h"
@@ -50,7 +50,7 @@ DECLARE_HC_VECTOR(PseudonymDb, OsAccountPseudonymInfo)
 IMPLEMENT_HC_VECTOR(PseudonymDb, OsAccountPseudonymInfo, 1)
 
 static PseudonymDb g_pseudonymDb;
-static HcMutex *g_mutex = NULL;
+static HcRwLock *g_rwLock = NULL;
 static bool g_isInitial = false;
 
 void DestroyPseudonymInfo(PseudonymInfo *pseudonymInfo)
@@ -415,9 +415,9 @@ static void LoadOsAccountPseudonymDb(int32_t osAccountId)
 static void OnOsAccountUnlocked(int32_t osAccountId)
 {
     LOGI("Os account is unlocked, osAccountId: %" LOG_PUB "d", osAccountId);
-    (void)LockHcMutex(g_mutex);
+    (void)WriteLockHcRwLock(g_rwLock);
     LoadOsAccountPseudonymDb(osAccountId);
-    UnlockHcMutex(g_mutex);
+    UnlockHcRwLock(g_rwLock);
 }
 
 static void RemoveOsAccountPseudonymInfo(int32_t osAccountId)
@@ -437,21 +437,26 @@ static void RemoveOsAccountPseudonymInfo(int32_t osAccountId)
 static void OnOsAccountRemoved(int32_t osAccountId)
 {
     LOGI("Os account is removed, osAccountId: %" LOG_PUB "d", osAccountId);
-    (void)LockHcMutex(g_mutex);
+    (void)WriteLockHcRwLock(g_rwLock);
     RemoveOsAccountPseudonymInfo(osAccountId);
-    UnlockHcMutex(g_mutex);
+    UnlockHcRwLock(g_rwLock);
 }
 
-static bool IsOsAccountPseudonymDataLoaded(int32_t osAccountId)
+static OsAccountPseudonymInfo *FindLoadedPseudonymInfo(int32_t osAccountId)
 {
     uint32_t index = 0;
     OsAccountPseudonymInfo *info = NULL;
     FOR_EACH_HC_VECTOR(g_pseudonymDb, index, info) {
         if (info->osAccountId == osAccountId) {
-            return true;
+            return info;
         }
     }
-    return false;
+    return NULL;
+}
+
+static bool IsOsAccountPseudonymDataLoaded(int32_t osAccountId)
+{
+    return FindLoadedPseudonymInfo(osAccountId) != NULL;
 }
 
 static void LoadDataIfNotLoaded(int32_t osAccountId)
@@ -487,22 +492,35 @@ static OsAccountPseudonymInfo *GetPseudonymInfoByOsAccountId(int32_t osAccountId
     return returnInfo;
 }
 
+/* Lookups on a cached os account share the read lock, loading the cache of a new os account needs the write lock. */
+static OsAccountPseudonymInfo *LockPseudonymInfoForRead(int32_t osAccountId)
+{
+    (void)ReadLockHcRwLock(g_rwLock);
+    OsAccountPseudonymInfo *info = FindLoadedPseudonymInfo(osAccountId);
+    if (info != NULL) {
+        return info;
+    }
+    UnlockHcRwLock(g_rwLock);
+    (void)WriteLockHcRwLock(g_rwLock);
+    return GetPseudonymInfoByOsAccountId(osAccountId);
+}
+
 static int32_t SaveOsAccountPseudonymDb(int32_t osAccountId)
 {
-    (void)LockHcMutex(g_mutex);
+    (void)WriteLockHcRwLock(g_rwLock);
     OsAccountPseudonymInfo *info = GetPseudonymInfoByOsAccountId(osAccountId);
     if (info == NULL) {
         LOGE("Get pseudonym info by os account id failed");
-        UnlockHcMutex(g_mutex);
+        UnlockHcRwLock(g_rwLock);
         return HC_ERROR;
     }
     int32_t ret = SavePseudonymInfoToFile(osAccountId, &info->pseudonymInfoVec);
     if (ret != HC_SUCCESS) {
         LOGE("Save pseudonym info to file failed");
-        UnlockHcMutex(g_mutex);
+        UnlockHcRwLock(g_rwLock);
         return ret;
     }
-    UnlockHcMutex(g_mutex);
+    UnlockHcRwLock(g_rwLock);
     LOGI("Save an os account database successfully! [Id]: %" LOG_PUB "d", osAccountId);
     return HC_SUCCESS;
 }
@@ -511,11 +529,11 @@ static int32_t DeletePseudonymInner(int32_t osAccountId, const char *dataTodelet
     const char *fieldName)
 {
     LOGI("Start to delete Pseudonym from database!");
-    (void)LockHcMutex(g_mutex);
+    (void)WriteLockHcRwLock(g_rwLock);
     OsAccountPseudonymInfo *info = GetPseudonymInfoByOsAccountId(osAccountId);
     if (info == NULL) {
         LOGE("Get pseudonym info by os account id failed");
-        UnlockHcMutex(g_mutex);
+        UnlockHcRwLock(g_rwLock);
         return HC_ERROR;
     }
     int32_t count = 0;
@@ -537,7 +555,7 @@ static int32_t DeletePseudonymInner(int32_t osAccountId, const char *dataTodelet
             DestroyPseudonymInfo(deletepseudonymInfoEntry);
         }
     }
-    UnlockHcMutex(g_mutex);
+    UnlockHcRwLock(g_rwLock);
     if (count == 0) {
         LOGE("No pseudonym info deleted");
         return HC_ERROR;
@@ -548,26 +566,26 @@ static int32_t DeletePseudonymInner(int32_t osAccountId, const char *dataTodelet
 
 static void InitPseudonymManger(void)
 {
-    if (g_mutex == NULL) {
-        g_mutex = (HcMutex *)HcMalloc(sizeof(HcMutex), 0);
-        if (g_mutex == NULL) {
-            LOGE("Alloc sessionMutex failed");
+    if (g_rwLock == NULL) {
+        g_rwLock = (HcRwLock *)HcMalloc(sizeof(HcRwLock), 0);
+        if (g_rwLock == NULL) {
+            LOGE("Alloc pseudonym rwLock failed");
             return;
         }
-        if (InitHcMutex(g_mutex, false) != HC_SUCCESS) {
-            LOGE("Init mutex failed");
-            HcFree(g_mutex);
-            g_mutex = NULL;
+        if (InitHcRwLock(g_rwLock) != HC_SUCCESS) {
+            LOGE("Init rwLock failed");
+            HcFree(g_rwLock);
+            g_rwLock = NULL;
             return;
         }
     }
-    (void)LockHcMutex(g_mutex);
+    (void)WriteLockHcRwLock(g_rwLock);
     if (!g_isInitial) {
         g_pseudonymDb = CREATE_HC_VECTOR(PseudonymDb);
         AddOsAccountEventCallback(PSEUDONYM_DATA_CALLBACK, OnOsAccountUnlocked, OnOsAccountRemoved);
         g_isInitial = true;
     }
-    UnlockHcMutex(g_mutex);
+    UnlockHcRwLock(g_rwLock);
 }
 
 static void LoadPseudonymData(void)
@@ -576,7 +594,7 @@ static void LoadPseudonymData(void)
     if (IsOsAccountSupported()) {
         return;
     }
-    (void)LockHcMutex(g_mutex);
+    (void)WriteLockHcRwLock(g_rwLock);
     StringVector dbNameVec = CreateStrVector();
     HcFileGetSubFileName(GetPseudonymStoragePath(), &dbNameVec);
     uint32_t index;
@@ -594,7 +612,7 @@ static void LoadPseudonymData(void)
         }
     }
     DestroyStrVector(&dbNameVec);
-    UnlockHcMutex(g_mutex);
+    UnlockHcRwLock(g_rwLock);
 }
 
 static int32_t GetRealInfo(int32_t osAccountId, const char *pseudonymId, char **realInfo)
@@ -604,11 +622,10 @@ static int32_t GetRealInfo(int32_t osAccountId, const char *pseudonymId, char **
         return HC_ERR_INVALID_PARAMS;
     }
     InitPseudonymManger();
-    (void)LockHcMutex(g_mutex);
-    OsAccountPseudonymInfo *info = GetPseudonymInfoByOsAccountId(osAccountId);
+    OsAccountPseudonymInfo *info = LockPseudonymInfoForRead(osAccountId);
     if (info == NULL) {
         LOGE("Failed to get Pseudonym by os account id.");
-        UnlockHcMutex(g_mutex);
+        UnlockHcRwLock(g_rwLock);
         return HC_ERROR;
     }
     uint32_t index;
@@ -618,14 +635,14 @@ static int32_t GetRealInfo(int32_t osAccountId, const char *pseudonymId, char **
             (IsStrEqual((*pseudonymInfoEntry)->pseudonymId, pseudonymId))) {
             if (DeepCopyString((*pseudonymInfoEntry)->realInfo, realInfo) != HC_SUCCESS) {
                 LOGE("Failed to deep copy pseudonymInfoentry realInfo!");
-                UnlockHcMutex(g_mutex);
+                UnlockHcRwLock(g_rwLock);
                 return HC_ERR_MEMORY_COPY;
             }
-            UnlockHcMutex(g_mutex);
+            UnlockHcRwLock(g_rwLock);
             return HC_SUCCESS;
         }
     }
-    UnlockHcMutex(g_mutex);
+    UnlockHcRwLock(g_rwLock);
     return HC_SUCCESS;
 }
 
@@ -636,11 +653,10 @@ static int32_t GetPseudonymId(int32_t osAccountId, const char *indexKey, char **
         return HC_ERR_INVALID_PARAMS;
     }
     InitPseudonymManger();
-    (void)LockHcMutex(g_mutex);
-    OsAccountPseudonymInfo *info = GetPseudonymInfoByOsAccountId(osAccountId);
+    OsAccountPseudonymInfo *info = LockPseudonymInfoForRead(osAccountId);
     if (info == NULL) {
         LOGE("Get Pseudonym by os account id failed.");
-        UnlockHcMutex(g_mutex);
+        UnlockHcRwLock(g_rwLock);
         return HC_ERROR;
     }
     uint32_t index;
@@ -650,25 +666,25 @@ static int32_t GetPseudonymId(int32_t osAccountId, const char *indexKey, char **
             (IsStrEqual((*pseudonymInfoEntry)->indexKey, indexKey))) {
             if (DeepCopyString((*pseudonymInfoEntry)->pseudonymId, pseudonymId) != HC_SUCCESS) {
                 LOGE("Failed to deep copy pseudonymId!");
-                UnlockHcMutex(g_mutex);
+                UnlockHcRwLock(g_rwLock);
                 return HC_ERR_MEMORY_COPY;
             }
-            UnlockHcMutex(g_mutex);
+            UnlockHcRwLock(g_rwLock);
             return HC_SUCCESS;
         }
     }
-    UnlockHcMutex(g_mutex);
+    UnlockHcRwLock(g_rwLock);
     return HC_ERROR;
 }
 
 static int32_t AddPseudonymIdInfoToMemory(int32_t osAccountId, PseudonymInfo *pseudonymInfo)
 {
     LOGI("Start to add a pseudonymInfo to memory!");
-    (void)LockHcMutex(g_mutex);
+    (void)WriteLockHcRwLock(g_rwLock);
     OsAccountPseudonymInfo *info = GetPseudonymInfoByOsAccountId(osAccountId);
     if (info == NULL) {
         LOGE("Failed to get Pseudonym by os account id");
-        UnlockHcMutex(g_mutex);
+        UnlockHcRwLock(g_rwLock);
         return HC_ERROR;
     }
     PseudonymInfo **oldPtr = QueryPseudonymInfoPtrIfMatch(&info->pseudonymInfoVec,
@@ -676,16 +692,16 @@ static int32_t AddPseudonymIdInfoToMemory(int32_t osAccountId, PseudonymInfo *ps
     if (oldPtr != NULL) {
         DestroyPseudonymInfo(*oldPtr);
         *oldPtr = pseudonymInfo;
-        UnlockHcMutex(g_mutex);
+        UnlockHcRwLock(g_rwLock);
         LOGI("Replace an old pseudonymInfo successfully!");
         return HC_SUCCESS;
     }
     if (info->pseudonymInfoVec.pushBackT(&info->pseudonymInfoVec, pseudonymInfo) == NULL) {
-        UnlockHcMutex(g_mutex);
+        UnlockHcRwLock(g_rwLock);
         LOGE("Failed to push pseudonymInfo to vec!");
         return HC_ERR_MEMORY_COPY;
     }
-    UnlockHcMutex(g_mutex);
+    UnlockHcRwLock(g_rwLock);
     LOGI("Add pseudonymInfo to memory successfully!");
     return HC_SUCCESS;
 }
@@ -791,11 +807,11 @@ static bool IsNeedRefreshPseudonymId(int32_t osAccountId, const char *indexKey)
         return true;
     }
     InitPseudonymManger();
-    (void)LockHcMutex(g_mutex);
+    (void)WriteLockHcRwLock(g_rwLock);
     OsAccountPseudonymInfo *info = GetPseudonymInfoByOsAccountId(osAccountId);
     if (info == NULL) {
         LOGE("Failed to get Pseudonym by os account id");
-        UnlockHcMutex(g_mutex);
+        UnlockHcRwLock(g_rwLock);
         return true;
     }
     uint32_t index;
@@ -804,15 +820,15 @@ static bool IsNeedRefreshPseudonymId(int32_t osAccountId, const char *indexKey)
         if ((pseudonymInfoEntry != NULL) && (*pseudonymInfoEntry != NULL) &&
             (IsStrEqual((*pseudonymInfoEntry)->indexKey, indexKey))) {
             if (IsNeedRefresh(*pseudonymInfoEntry)) {
-                UnlockHcMutex(g_mutex);
+                UnlockHcRwLock(g_rwLock);
                 return true;
             }
             (*pseudonymInfoEntry)->refreshCount--;
-            UnlockHcMutex(g_mutex);
+            UnlockHcRwLock(g_rwLock);
             return false;
         }
     }
-    UnlockHcMutex(g_mutex);
+    UnlockHcRwLock(g_rwLock);
     return true;
 }
 
@@ -833,7 +849,7 @@ PseudonymManager *GetPseudonymInstance(void)
 
 void DestroyPseudonymManager(void)
 {
-    (void)LockHcMutex(g_mutex);
+    (void)WriteLockHcRwLock(g_rwLock);
     RemoveOsAccountEventCallback(PSEUDONYM_DATA_CALLBACK);
     uint32_t index;
     OsAccountPseudonymInfo *info = NULL;
@@ -841,8 +857,8 @@ void DestroyPseudonymManager(void)
         ClearPseudonymInfoVec(&info->pseudonymInfoVec);
     }
     DESTROY_HC_VECTOR(PseudonymDb, &g_pseudonymDb);
-    UnlockHcMutex(g_mutex);
-    DestroyHcMutex(g_mutex);
-    HcFree(g_mutex);
-    g_mutex = NULL;
+    UnlockHcRwLock(g_rwLock);
+    DestroyHcRwLock(g_rwLock);
+    HcFree(g_rwLock);
+    g_rwLock = NULL;
 }
\ No newline at end of file
@@ -19,6 +19,7 @@
 #include "auth_sub_session.h"
 #include "compatible_sub_session.h"
 #include "expand_sub_session.h"
+#include "hc_arena.h"
 #include "identity_defines.h"
 #include "dev_session_fwk.h"
 #include "hc_vector.h"
@@ -35,6 +36,8 @@
 #define FIELD_ABILITY "ability"
 #define FIELD_TYPE "type"
 #define FIELD_MSG "msg"
+#define FIELD_COMPACT_MSG "cmsg"
+#define FIELD_SUPPORT_COMPACT_MSG "spCmsg"
 
 #define FIELD_HAND_SHAKE "handshake"
 #define FIELD_AUTH_EVENT "authEvent"
@@ -45,6 +48,7 @@
 #define FIELD_SESSION_FAIL_EVENT "failEvent"
 
 #define DEV_SESSION_SALT_LEN 32
+#define DEV_SESSION_ARENA_CHUNK_SIZE 256
 
 typedef struct {
     int32_t type;
@@ -74,6 +78,8 @@ typedef struct {
     ExpandSubSession *expandSubSession;
     CompatibleBaseSubSession *compatibleSubSession;
     bool isCredAuth;
+    bool isCompactMsg; /* both sides decode the compact msg, negotiated in handshake */
+    HcArena arena; /* buffers living as long as the session, wiped and freed on destroy */
 } SessionImpl;
 
 #endif
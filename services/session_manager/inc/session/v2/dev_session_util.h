@@ -34,6 +34,8 @@ int32_t GetRealPkInfoStr(int32_t osAccountId, const CJson *credInfo, char **retu
 int32_t AddPkInfoWithPdid(const CJson *context, CJson *credInfo, bool isCredAuth, const char *realPkInfoStr);
 TrustedDeviceEntry *GetDeviceEntryById(int32_t osAccountId, const char *deviceId, bool isUdid,
     const char *groupId);
+int32_t VisitDeviceEntryById(int32_t osAccountId, const char *deviceId, bool isUdid, const char *groupId,
+    DeviceEntryVisitor visitor, void *ctx);
 int32_t BuildPeerCertInfo(const char *pkInfoStr, const char *pkInfoSignHexStr, int32_t signAlg,
     int32_t certVersion, CertInfo *peerCert);
 void DestroyCertInfo(CertInfo *certInfo);
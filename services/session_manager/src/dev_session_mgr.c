@@ -22,16 +22,48 @@
 #include "hc_log.h"
 #include "hc_mutex.h"
 #include "hc_time.h"
-#include "hc_vector.h"
+#include "hc_types.h"
 #include "task_manager.h"
 #include "critical_handler.h"
 #include "string_util.h"
 
-typedef struct {
+#define SESSION_MIN_BUCKET_NUM 8
+
+typedef struct SessionInfoT {
+    struct SessionInfoT *hashNext;
+    struct SessionInfoT *prev;
+    struct SessionInfoT *next;
     DevSession *session;
     int64_t createTime;
+    HcMutex stepMutex;
+    uint32_t pinCount;
+    bool isRemoved;
+    bool isTimeout;
 } SessionInfo;
 
+/*
+ * Sessions are looked up by id through the buckets. All sessions share one timeout, so the creation
+ * list is also the expiry order and the timeout sweep only has to look at its head.
+ *
+ * g_sessionMutex only guards the table and the pin state of each entry. A step pins its session under
+ * g_sessionMutex and runs start or process under the session's own stepMutex, so steps of different
+ * sessions run in parallel on their workers. A session closed, cancelled or timed out while pinned is
+ * unlinked at once, the last unpin then reports the timeout and frees it.
+ *
+ * Worker 0 keeps running the tasks without a session: group create, delete and member delete, the
+ * account lifecycle plugin task and the group and credential db flushes. They only touch the group and
+ * credential dbs (read-write locked), the callback, broadcast and operation record managers (each behind
+ * its own mutex), huks and the auth modules (serialized by the module manager), so they are safe to run
+ * alongside session steps.
+ */
+typedef struct {
+    SessionInfo **buckets;
+    uint32_t bucketNum;
+    uint32_t count;
+    SessionInfo *oldest;
+    SessionInfo *newest;
+} SessionTable;
+
 typedef struct {
     HcTaskBase base;
     int64_t sessionId;
@@ -43,55 +75,143 @@ typedef struct {
     CJson *receivedMsg;
 } ProcSessionTask;
 
-DECLARE_HC_VECTOR(SessionInfoList, SessionInfo)
-IMPLEMENT_HC_VECTOR(SessionInfoList, SessionInfo, 1)
-
-static SessionInfoList g_sessionInfoList;
+static SessionTable g_sessionTable;
 static HcMutex g_sessionMutex;
 
-static int32_t GetSessionInfo(int64_t sessionId, SessionInfo **returnObj)
+static uint32_t GetSessionBucketIndex(int64_t sessionId)
 {
-    uint32_t index;
-    SessionInfo *ptr;
-    FOR_EACH_HC_VECTOR(g_sessionInfoList, index, ptr) {
-        DevSession *session = ptr->session;
-        if (session->id == sessionId) {
-            *returnObj = ptr;
-            return HC_SUCCESS;
-        }
+    uint64_t key = (uint64_t)sessionId;
+    uint32_t hash = (uint32_t)(key ^ (key >> 32));
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3bU;
+    hash ^= hash >> 16;
+    return hash & (g_sessionTable.bucketNum - 1);
+}
+
+static SessionInfo *GetSessionInfo(int64_t sessionId)
+{
+    if (g_sessionTable.buckets == NULL) {
+        return NULL;
+    }
+    SessionInfo *info = g_sessionTable.buckets[GetSessionBucketIndex(sessionId)];
+    while (info != NULL && info->session->id != sessionId) {
+        info = info->hashNext;
+    }
+    return info;
+}
+
+static void LinkSessionInfo(SessionInfo *info)
+{
+    uint32_t index = GetSessionBucketIndex(info->session->id);
+    info->hashNext = g_sessionTable.buckets[index];
+    g_sessionTable.buckets[index] = info;
+    info->prev = g_sessionTable.newest;
+    info->next = NULL;
+    if (g_sessionTable.newest != NULL) {
+        g_sessionTable.newest->next = info;
+    } else {
+        g_sessionTable.oldest = info;
+    }
+    g_sessionTable.newest = info;
+    g_sessionTable.count++;
+}
+
+static void UnlinkSessionInfo(SessionInfo *info)
+{
+    SessionInfo **pos = &g_sessionTable.buckets[GetSessionBucketIndex(info->session->id)];
+    while (*pos != NULL && *pos != info) {
+        pos = &(*pos)->hashNext;
+    }
+    if (*pos != NULL) {
+        *pos = info->hashNext;
+    }
+    if (info->prev != NULL) {
+        info->prev->next = info->next;
+    } else {
+        g_sessionTable.oldest = info->next;
+    }
+    if (info->next != NULL) {
+        info->next->prev = info->prev;
+    } else {
+        g_sessionTable.newest = info->prev;
+    }
+    g_sessionTable.count--;
+}
+
+static void FreeSessionInfo(SessionInfo *info)
+{
+    if (info->isTimeout) {
+        DevSession *session = info->session;
+        ProcessErrorCallback(session->id, session->opCode, HC_ERR_TIME_OUT, NULL, &session->callback);
+    }
+    info->session->destroy(info->session);
+    DestroyHcMutex(&info->stepMutex);
+    HcFree(info);
+}
+
+static void DestroySessionInfo(SessionInfo *info, bool isTimeout)
+{
+    UnlinkSessionInfo(info);
+    info->isRemoved = true;
+    info->isTimeout = isTimeout;
+    if (info->pinCount == 0) {
+        FreeSessionInfo(info);
     }
-    return HC_ERR_SESSION_NOT_EXIST;
 }
 
 void RemoveTimeoutSession(void)
 {
-    uint32_t index = 0;
-    while (index < g_sessionInfoList.size(&(g_sessionInfoList))) {
-        SessionInfo *sessionInfo = g_sessionInfoList.getp(&(g_sessionInfoList), index);
+    while (g_sessionTable.oldest != NULL) {
+        SessionInfo *sessionInfo = g_sessionTable.oldest;
         int64_t runningTime = HcGetIntervalTime(sessionInfo->createTime);
         if (runningTime < TIME_OUT_VALUE) {
-            index++;
-            continue;
+            break;
         }
         DevSession *session = sessionInfo->session;
         LOGI("session timeout. [AppId]: %" LOG_PUB "s, [Id]: %" LOG_PUB PRId64, session->appId, session->id);
         LOGI("session timeout. [TimeLimit(/s)]: %" LOG_PUB "d, [RunningTime(/s)]: %" LOG_PUB PRId64,
             TIME_OUT_VALUE, runningTime);
-        ProcessErrorCallback(session->id, session->opCode, HC_ERR_TIME_OUT, NULL, &session->callback);
-        session->destroy(session);
-        g_sessionInfoList.eraseElement(&(g_sessionInfoList), sessionInfo, index);
+        DestroySessionInfo(sessionInfo, true);
+    }
+}
+
+static SessionInfo *PinSessionInfo(int64_t sessionId)
+{
+    (void)LockHcMutex(&g_sessionMutex);
+    RemoveTimeoutSession();
+    SessionInfo *sessionInfo = GetSessionInfo(sessionId);
+    if (sessionInfo != NULL) {
+        sessionInfo->pinCount++;
     }
+    UnlockHcMutex(&g_sessionMutex);
+    return sessionInfo;
+}
+
+static void UnpinSessionInfo(SessionInfo *sessionInfo)
+{
+    (void)LockHcMutex(&g_sessionMutex);
+    sessionInfo->pinCount--;
+    if (sessionInfo->pinCount == 0 && sessionInfo->isRemoved) {
+        FreeSessionInfo(sessionInfo);
+    }
+    UnlockHcMutex(&g_sessionMutex);
+}
+
+static bool IsSessionInfoRemoved(const SessionInfo *sessionInfo)
+{
+    (void)LockHcMutex(&g_sessionMutex);
+    bool isRemoved = sessionInfo->isRemoved;
+    UnlockHcMutex(&g_sessionMutex);
+    return isRemoved;
 }
 
 static int32_t CheckEnvForOpenSession(int64_t sessionId)
 {
-    SessionInfo *sessionInfo;
-    int32_t res = GetSessionInfo(sessionId, &sessionInfo);
-    if (res == HC_SUCCESS) {
+    if (GetSessionInfo(sessionId) != NULL) {
         LOGE("session has existed. [Id]: %" LOG_PUB PRId64, sessionId);
         return HC_ERR_REQUEST_EXIST;
     }
-    uint32_t curSessionNum = HC_VECTOR_SIZE(&g_sessionInfoList);
+    uint32_t curSessionNum = g_sessionTable.count;
     if (curSessionNum >= MAX_AUTH_SESSION_COUNT) {
         LOGE("The number of sessions has reached the maximum limit. [CurNum]: %" LOG_PUB "u, [NumLimit]: %" LOG_PUB "d",
             curSessionNum, MAX_AUTH_SESSION_COUNT);
@@ -102,13 +222,23 @@ static int32_t CheckEnvForOpenSession(int64_t sessionId)
 
 static int32_t AddNewSessionToList(DevSession *session)
 {
-    SessionInfo newSessionInfo;
-    newSessionInfo.session = session;
-    newSessionInfo.createTime = HcGetCurTime();
-    if (g_sessionInfoList.pushBackT(&g_sessionInfoList, newSessionInfo) == NULL) {
+    if (g_sessionTable.buckets == NULL) {
+        LOGE("session manager is not initialized.");
+        return HC_ERR_INIT_FAILED;
+    }
+    SessionInfo *newSessionInfo = (SessionInfo *)HcMalloc(sizeof(SessionInfo), 0);
+    if (newSessionInfo == NULL) {
         LOGE("push session to list fail.");
-        return HC_ERR_MEMORY_COPY;
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    if (InitHcMutex(&newSessionInfo->stepMutex, false) != HC_SUCCESS) {
+        LOGE("Init session step mutex failed.");
+        HcFree(newSessionInfo);
+        return HC_ERR_INIT_FAILED;
     }
+    newSessionInfo->session = session;
+    newSessionInfo->createTime = HcGetCurTime();
+    LinkSessionInfo(newSessionInfo);
     return HC_SUCCESS;
 }
 
@@ -119,19 +249,29 @@ int32_t InitDevSessionManager(void)
         LOGE("Init session mutex failed.");
         return res;
     }
-    g_sessionInfoList = CREATE_HC_VECTOR(SessionInfoList);
+    (void)memset_s(&g_sessionTable, sizeof(SessionTable), 0, sizeof(SessionTable));
+    uint32_t bucketNum = SESSION_MIN_BUCKET_NUM;
+    while (bucketNum < (uint32_t)MAX_AUTH_SESSION_COUNT) {
+        bucketNum <<= 1;
+    }
+    g_sessionTable.buckets = (SessionInfo **)HcMalloc(bucketNum * sizeof(SessionInfo *), 0);
+    if (g_sessionTable.buckets == NULL) {
+        LOGE("Failed to allocate session buckets.");
+        DestroyHcMutex(&g_sessionMutex);
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    g_sessionTable.bucketNum = bucketNum;
     return HC_SUCCESS;
 }
 
 void DestroyDevSessionManager(void)
 {
-    uint32_t index;
-    SessionInfo *ptr;
     (void)LockHcMutex(&g_sessionMutex);
-    FOR_EACH_HC_VECTOR(g_sessionInfoList, index, ptr) {
-        ptr->session->destroy(ptr->session);
+    while (g_sessionTable.oldest != NULL) {
+        DestroySessionInfo(g_sessionTable.oldest, false);
     }
-    DESTROY_HC_VECTOR(SessionInfoList, &g_sessionInfoList);
+    HcFree(g_sessionTable.buckets);
+    (void)memset_s(&g_sessionTable, sizeof(SessionTable), 0, sizeof(SessionTable));
     UnlockHcMutex(&g_sessionMutex);
     DestroyHcMutex(&g_sessionMutex);
 }
@@ -139,10 +279,9 @@ void DestroyDevSessionManager(void)
 bool IsSessionExist(int64_t sessionId)
 {
     (void)LockHcMutex(&g_sessionMutex);
-    SessionInfo *sessionInfo;
-    int32_t res = GetSessionInfo(sessionId, &sessionInfo);
+    bool isExist = GetSessionInfo(sessionId) != NULL;
     UnlockHcMutex(&g_sessionMutex);
-    return res == HC_SUCCESS;
+    return isExist;
 }
 
 int32_t OpenDevSession(int64_t sessionId, const char *appId, SessionInitParams *params)
@@ -172,25 +311,28 @@ int32_t OpenDevSession(int64_t sessionId, const char *appId, SessionInitParams *
         return res;
     }
     LOGI("create session success. [AppId]: %" LOG_PUB "s, [CurNum]: %" LOG_PUB "u, [Id]: %" LOG_PUB PRId64,
-        appId, HC_VECTOR_SIZE(&g_sessionInfoList), sessionId);
+        appId, g_sessionTable.count, sessionId);
     UnlockHcMutex(&g_sessionMutex);
     return HC_SUCCESS;
 }
 
 int32_t StartDevSession(int64_t sessionId)
 {
-    (void)LockHcMutex(&g_sessionMutex);
-    RemoveTimeoutSession();
-    SessionInfo *sessionInfo;
-    int32_t res = GetSessionInfo(sessionId, &sessionInfo);
-    if (res != HC_SUCCESS) {
+    SessionInfo *sessionInfo = PinSessionInfo(sessionId);
+    if (sessionInfo == NULL) {
         LOGE("session not found. [Id]: %" LOG_PUB PRId64, sessionId);
-        UnlockHcMutex(&g_sessionMutex);
-        return res;
+        return HC_ERR_SESSION_NOT_EXIST;
     }
-    DevSession *session = sessionInfo->session;
-    res = session->start(session);
-    UnlockHcMutex(&g_sessionMutex);
+    (void)LockHcMutex(&sessionInfo->stepMutex);
+    int32_t res = HC_ERR_SESSION_NOT_EXIST;
+    if (!IsSessionInfoRemoved(sessionInfo)) {
+        DevSession *session = sessionInfo->session;
+        res = session->start(session);
+    } else {
+        LOGE("session has been removed. [Id]: %" LOG_PUB PRId64, sessionId);
+    }
+    UnlockHcMutex(&sessionInfo->stepMutex);
+    UnpinSessionInfo(sessionInfo);
     return res;
 }
 
@@ -200,18 +342,21 @@ int32_t ProcessDevSession(int64_t sessionId, const CJson *receviedMsg, bool *isF
         LOGE("invalid params.");
         return HC_ERR_INVALID_PARAMS;
     }
-    (void)LockHcMutex(&g_sessionMutex);
-    RemoveTimeoutSession();
-    SessionInfo *sessionInfo;
-    int32_t res = GetSessionInfo(sessionId, &sessionInfo);
-    if (res != HC_SUCCESS) {
+    SessionInfo *sessionInfo = PinSessionInfo(sessionId);
+    if (sessionInfo == NULL) {
         LOGE("session not found. [Id]: %" LOG_PUB PRId64, sessionId);
-        UnlockHcMutex(&g_sessionMutex);
-        return res;
+        return HC_ERR_SESSION_NOT_EXIST;
     }
-    DevSession *session = sessionInfo->session;
-    res = session->process(session, receviedMsg, isFinish);
-    UnlockHcMutex(&g_sessionMutex);
+    (void)LockHcMutex(&sessionInfo->stepMutex);
+    int32_t res = HC_ERR_SESSION_NOT_EXIST;
+    if (!IsSessionInfoRemoved(sessionInfo)) {
+        DevSession *session = sessionInfo->session;
+        res = session->process(session, receviedMsg, isFinish);
+    } else {
+        LOGE("session has been removed. [Id]: %" LOG_PUB PRId64, sessionId);
+    }
+    UnlockHcMutex(&sessionInfo->stepMutex);
+    UnpinSessionInfo(sessionInfo);
     return res;
 }
 
@@ -219,18 +364,13 @@ void CloseDevSession(int64_t sessionId)
 {
     (void)LockHcMutex(&g_sessionMutex);
     RemoveTimeoutSession();
-    uint32_t index;
-    SessionInfo *ptr;
-    FOR_EACH_HC_VECTOR(g_sessionInfoList, index, ptr) {
-        DevSession *session = ptr->session;
-        if (session->id == sessionId) {
-            session->destroy(session);
-            HC_VECTOR_POPELEMENT(&g_sessionInfoList, ptr, index);
-            LOGI("close session success. [CurNum]: %" LOG_PUB "u, [Id]: %" LOG_PUB PRId64,
-                HC_VECTOR_SIZE(&g_sessionInfoList), sessionId);
-            UnlockHcMutex(&g_sessionMutex);
-            return;
-        }
+    SessionInfo *sessionInfo = GetSessionInfo(sessionId);
+    if (sessionInfo != NULL) {
+        DestroySessionInfo(sessionInfo, false);
+        LOGI("close session success. [CurNum]: %" LOG_PUB "u, [Id]: %" LOG_PUB PRId64,
+            g_sessionTable.count, sessionId);
+        UnlockHcMutex(&g_sessionMutex);
+        return;
     }
     LOGI("session not exist. [Id]: %" LOG_PUB PRId64, sessionId);
     UnlockHcMutex(&g_sessionMutex);
@@ -244,18 +384,13 @@ void CancelDevSession(int64_t sessionId, const char *appId)
     }
     (void)LockHcMutex(&g_sessionMutex);
     RemoveTimeoutSession();
-    uint32_t index;
-    SessionInfo *ptr;
-    FOR_EACH_HC_VECTOR(g_sessionInfoList, index, ptr) {
-        DevSession *session = ptr->session;
-        if (session->id == sessionId && IsStrEqual(session->appId, appId)) {
-            session->destroy(session);
-            HC_VECTOR_POPELEMENT(&g_sessionInfoList, ptr, index);
-            LOGI("cancel session success. [CurNum]: %" LOG_PUB "u, [Id]: %" LOG_PUB PRId64,
-                HC_VECTOR_SIZE(&g_sessionInfoList), sessionId);
-            UnlockHcMutex(&g_sessionMutex);
-            return;
-        }
+    SessionInfo *sessionInfo = GetSessionInfo(sessionId);
+    if (sessionInfo != NULL && IsStrEqual(sessionInfo->session->appId, appId)) {
+        DestroySessionInfo(sessionInfo, false);
+        LOGI("cancel session success. [CurNum]: %" LOG_PUB "u, [Id]: %" LOG_PUB PRId64,
+            g_sessionTable.count, sessionId);
+        UnlockHcMutex(&g_sessionMutex);
+        return;
     }
     LOGI("session not exist. [Id]: %" LOG_PUB PRId64, sessionId);
     UnlockHcMutex(&g_sessionMutex);
@@ -336,7 +471,7 @@ int32_t PushStartSessionTask(int64_t sessionId)
         return HC_ERR_ALLOC_MEMORY;
     }
     InitStartSessionTask(task, sessionId);
-    if (PushTask((HcTaskBase*)task) != HC_SUCCESS) {
+    if (PushSessionTask(sessionId, (HcTaskBase*)task) != HC_SUCCESS) {
         LOGE("push start session task fail.");
         HcFree(task);
         return HC_ERR_INIT_TASK_FAIL;
@@ -354,7 +489,7 @@ int32_t PushProcSessionTask(int64_t sessionId, CJson *receivedMsg)
         return HC_ERR_ALLOC_MEMORY;
     }
     InitProcSessionTask(task, sessionId, receivedMsg);
-    if (PushTask((HcTaskBase*)task) != HC_SUCCESS) {
+    if (PushSessionTask(sessionId, (HcTaskBase*)task) != HC_SUCCESS) {
         LOGE("push process session task fail.");
         HcFree(task);
         return HC_ERR_INIT_TASK_FAIL;
@@ -31,10 +31,12 @@
 #include "hc_log.h"
 #include "hc_time.h"
 #include "hc_types.h"
+#include "json_compact.h"
 #include "performance_dumper.h"
 #include "hisysevent_common.h"
 #include "operation_data_manager.h"
 #include "identity_service_defines.h"
+#include "string_util.h"
 
 static int32_t StartV1Session(SessionImpl *impl, CJson **sendMsg)
 {
@@ -71,9 +73,7 @@ static void DestroySession(DevSession *self)
         return;
     }
     SessionImpl *impl = (SessionImpl *)self;
-    HcFree(impl->base.appId);
     FreeJson(impl->context);
-    ClearFreeUint8Buff(&impl->salt);
     ClearFreeUint8Buff(&impl->sessionKey);
     ClearIdentityInfoVec(&impl->credList);
     DestroyEventList(&impl->eventList);
@@ -91,6 +91,7 @@ static void DestroySession(DevSession *self)
         DestroyCompatibleSubSession(impl->compatibleSubSession);
         impl->compatibleSubSession = NULL;
     }
+    DestroyArena(&impl->arena);
     HcFree(impl);
 }
 
@@ -111,6 +112,41 @@ static int32_t DecodeEvent(const CJson *inputEvent)
     return SESSION_UNKNOWN_EVENT;
 }
 
+static int32_t AddCompactSessionMsg(const CJson *sessionMsg, CJson *sendMsg)
+{
+    HcParcel parcel = CreateParcel(0, 0);
+    if (PackJsonToCompactData(sessionMsg, &parcel) != HC_SUCCESS) {
+        LOGE("pack sessionMsg to compact data fail.");
+        DeleteParcel(&parcel);
+        return HC_ERR_PACKAGE_JSON_TO_STRING_FAIL;
+    }
+    uint32_t dataLen = GetParcelDataSize(&parcel);
+    uint32_t base64StrLen = (dataLen / BYTE_TO_BASE64_DIVISOR + (dataLen % BYTE_TO_BASE64_DIVISOR != 0)) *
+        BYTE_TO_BASE64_MULTIPLIER + 1;
+    char *base64Str = (char *)HcMalloc(base64StrLen, 0);
+    if (base64Str == NULL) {
+        LOGE("allocate base64Str memory fail.");
+        DeleteParcel(&parcel);
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    uint32_t outLen = 0;
+    int32_t res = GetLoaderInstance()->base64Encode((const uint8_t *)GetParcelData(&parcel), dataLen,
+        base64Str, base64StrLen, &outLen);
+    DeleteParcel(&parcel);
+    if (res != HC_SUCCESS) {
+        LOGE("base64 encode compact data fail.");
+        HcFree(base64Str);
+        return HC_ERR_CONVERT_FAILED;
+    }
+    if (AddStringToJson(sendMsg, FIELD_COMPACT_MSG, base64Str) != HC_SUCCESS) {
+        LOGE("add compact sessionMsg to json fail.");
+        HcFree(base64Str);
+        return HC_ERR_JSON_ADD;
+    }
+    HcFree(base64Str);
+    return HC_SUCCESS;
+}
+
 static int32_t PackSendMsg(SessionImpl *impl, CJson *sessionMsg, CJson *sendMsg)
 {
     if (AddInt64StringToJson(sendMsg, FIELD_REQUEST_ID, impl->base.id) != HC_SUCCESS) {
@@ -121,6 +157,9 @@ static int32_t PackSendMsg(SessionImpl *impl, CJson *sessionMsg, CJson *sendMsg)
         LOGE("add appId to json fail.");
         return HC_ERR_JSON_ADD;
     }
+    if (impl->isCompactMsg) {
+        return AddCompactSessionMsg(sessionMsg, sendMsg);
+    }
     if (AddObjToJson(sendMsg, FIELD_MSG, sessionMsg) != HC_SUCCESS) {
         LOGE("add sessionMsg to json fail.");
         return HC_ERR_JSON_ADD;
@@ -438,13 +477,52 @@ static int32_t StartSession(DevSession *self)
     return res;
 }
 
-static int32_t ParseAllRecvEvent(SessionImpl *impl, const CJson *receviedMsg)
+static int32_t DecodeCompactSessionMsg(const char *base64Str, CJson **sessionMsg)
 {
-    CJson *sessionMsg = GetObjFromJson(receviedMsg, FIELD_MSG);
-    if (sessionMsg == NULL) {
+    uint32_t dataLen = HcStrlen(base64Str) / BYTE_TO_BASE64_MULTIPLIER * BYTE_TO_BASE64_DIVISOR;
+    if (dataLen == 0) {
+        LOGE("compact sessionMsg is empty.");
+        return HC_ERR_BAD_MESSAGE;
+    }
+    uint8_t *data = (uint8_t *)HcMalloc(dataLen, 0);
+    if (data == NULL) {
+        LOGE("allocate compact data memory fail.");
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    uint32_t outLen = 0;
+    if (GetLoaderInstance()->base64Decode(base64Str, HcStrlen(base64Str), data, dataLen, &outLen) != HC_SUCCESS) {
+        LOGE("base64 decode compact sessionMsg fail.");
+        HcFree(data);
+        return HC_ERR_CONVERT_FAILED;
+    }
+    *sessionMsg = CreateJsonFromCompactData(data, outLen);
+    HcFree(data);
+    if (*sessionMsg == NULL) {
+        LOGE("create sessionMsg from compact data fail.");
+        return HC_ERR_BAD_MESSAGE;
+    }
+    return HC_SUCCESS;
+}
+
+/* The events keep pointers into the session msg, so a decoded compact msg has to outlive the event list. */
+static int32_t GetRecvSessionMsg(const CJson *receviedMsg, CJson **decodedMsg, const CJson **sessionMsg)
+{
+    const char *compactMsg = GetStringFromJson(receviedMsg, FIELD_COMPACT_MSG);
+    if (compactMsg != NULL) {
+        int32_t res = DecodeCompactSessionMsg(compactMsg, decodedMsg);
+        *sessionMsg = *decodedMsg;
+        return res;
+    }
+    *sessionMsg = GetObjFromJson(receviedMsg, FIELD_MSG);
+    if (*sessionMsg == NULL) {
         LOGE("get sessionMsg from receviedMsg fail.");
         return HC_ERR_JSON_GET;
     }
+    return HC_SUCCESS;
+}
+
+static int32_t ParseAllRecvEvent(SessionImpl *impl, const CJson *sessionMsg)
+{
     int32_t eventNum = GetItemNum(sessionMsg);
     if (eventNum <= 0) {
         LOGE("There are no events in the received session message.");
@@ -474,7 +552,8 @@ static int32_t ParseAllRecvEvent(SessionImpl *impl, const CJson *receviedMsg)
 
 static bool IsV1SessionMsg(const CJson *receviedMsg)
 {
-    return (GetObjFromJson(receviedMsg, FIELD_MSG) == NULL);
+    return (GetObjFromJson(receviedMsg, FIELD_MSG) == NULL) &&
+        (GetStringFromJson(receviedMsg, FIELD_COMPACT_MSG) == NULL);
 }
 
 static int32_t AddChannelInfoToParams(SessionImpl *impl, CJson *receviedMsg)
@@ -778,14 +857,21 @@ static int32_t ProcV2Session(SessionImpl *impl, const CJson *receviedMsg, bool *
         DestroyCompatibleSubSession(impl->compatibleSubSession);
         impl->compatibleSubSession = NULL;
     }
+    CJson *decodedMsg = NULL;
+    const CJson *sessionMsg = NULL;
     int32_t res;
     do {
-        res = ParseAllRecvEvent(impl, receviedMsg);
+        res = GetRecvSessionMsg(receviedMsg, &decodedMsg, &sessionMsg);
+        if (res != HC_SUCCESS) {
+            break;
+        }
+        res = ParseAllRecvEvent(impl, sessionMsg);
         if (res != HC_SUCCESS) {
             break;
         }
         res = ProcEventList(impl);
     } while (0);
+    FreeJson(decodedMsg);
     ReportBehaviorEvent(impl, true, false, res);
     if (res != HC_SUCCESS) {
         OnDevSessionError(impl, res, NULL, false);
@@ -852,15 +938,17 @@ static int32_t BuildDevSession(int64_t sessionId, const char *appId, SessionInit
     if (res != HC_SUCCESS) {
         return res;
     }
-    res = DeepCopyString(appId, &session->base.appId);
+    InitArena(&session->arena, DEV_SESSION_ARENA_CHUNK_SIZE);
+    res = ArenaCopyString(&session->arena, appId, &session->base.appId);
     if (res != HC_SUCCESS) {
         LOGE("copy appId fail.");
+        DestroyArena(&session->arena);
         return res;
     }
     CJson *copyContext = DuplicateJson(params->context);
     if (copyContext == NULL) {
         LOGE("copy context fail.");
-        HcFree(session->base.appId);
+        DestroyArena(&session->arena);
         return HC_ERR_ALLOC_MEMORY;
     }
     session->base.id = sessionId;
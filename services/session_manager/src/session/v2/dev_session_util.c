@@ -27,12 +27,58 @@
 #define FIELD_AUTH_ID_CLIENT "authIdC"
 #define FIELD_AUTH_ID_SERVER "authIdS"
 
-static TrustedDeviceEntry *GetPeerDeviceEntryByContext(int32_t osAccountId, const CJson *context)
+typedef struct {
+    char **returnPdidIndex;
+    int32_t res;
+} PdidIndexVisitCtx;
+
+typedef struct {
+    CJson *context;
+    int32_t res;
+} PeerAuthIdVisitCtx;
+
+static bool CopyDeviceEntryVisitor(const TrustedDeviceEntry *entry, void *ctx)
+{
+    *(TrustedDeviceEntry **)ctx = DeepCopyDeviceEntry(entry);
+    return false;
+}
+
+static bool GetPdidIndexVisitor(const TrustedDeviceEntry *entry, void *ctx)
+{
+    PdidIndexVisitCtx *visitCtx = (PdidIndexVisitCtx *)ctx;
+    const char *pdidIndex = StringGet(&entry->userId);
+    if (pdidIndex == NULL) {
+        LOGE("pdidIndex is null!");
+        visitCtx->res = HC_ERR_NULL_PTR;
+        return false;
+    }
+    if (DeepCopyString(pdidIndex, visitCtx->returnPdidIndex) != HC_SUCCESS) {
+        LOGE("Failed to copy pdidIndex!");
+        visitCtx->res = HC_ERR_ALLOC_MEMORY;
+        return false;
+    }
+    visitCtx->res = HC_SUCCESS;
+    return false;
+}
+
+static bool SetPeerAuthIdVisitor(const TrustedDeviceEntry *entry, void *ctx)
+{
+    PeerAuthIdVisitCtx *visitCtx = (PeerAuthIdVisitCtx *)ctx;
+    if (AddStringToJson(visitCtx->context, FIELD_PEER_AUTH_ID, StringGet(&entry->authId)) != HC_SUCCESS) {
+        LOGE("Failed to add peer authId to context!");
+        visitCtx->res = HC_ERR_JSON_ADD;
+        return false;
+    }
+    visitCtx->res = HC_SUCCESS;
+    return false;
+}
+
+static int32_t GetPdidIndexByGroup(const CJson *context, int32_t osAccountId, char **returnPdidIndex)
 {
     const char *groupId = GetStringFromJson(context, FIELD_GROUP_ID);
     if (groupId == NULL) {
         LOGE("Failed to get groupId!");
-        return NULL;
+        return HC_ERR_DEVICE_NOT_EXIST;
     }
     bool isUdid = false;
     const char *peerDeviceId = GetStringFromJson(context, FIELD_PEER_UDID);
@@ -43,32 +89,15 @@ static TrustedDeviceEntry *GetPeerDeviceEntryByContext(int32_t osAccountId, cons
         peerDeviceId = GetStringFromJson(context, FIELD_PEER_AUTH_ID);
         if (peerDeviceId == NULL) {
             LOGE("Failed to get peer authId!");
-            return NULL;
+            return HC_ERR_DEVICE_NOT_EXIST;
         }
     }
-    return GetDeviceEntryById(osAccountId, peerDeviceId, isUdid, groupId);
-}
-
-static int32_t GetPdidIndexByGroup(const CJson *context, int32_t osAccountId, char **returnPdidIndex)
-{
-    TrustedDeviceEntry *deviceEntry = GetPeerDeviceEntryByContext(osAccountId, context);
-    if (deviceEntry == NULL) {
+    PdidIndexVisitCtx ctx = { returnPdidIndex, HC_ERR_DEVICE_NOT_EXIST };
+    (void)VisitDeviceEntryById(osAccountId, peerDeviceId, isUdid, groupId, GetPdidIndexVisitor, &ctx);
+    if (ctx.res == HC_ERR_DEVICE_NOT_EXIST) {
         LOGE("Failed to get device entry!");
-        return HC_ERR_DEVICE_NOT_EXIST;
     }
-    const char *pdidIndex = StringGet(&deviceEntry->userId);
-    if (pdidIndex == NULL) {
-        LOGE("pdidIndex is null!");
-        DestroyDeviceEntry(deviceEntry);
-        return HC_ERR_NULL_PTR;
-    }
-    if (DeepCopyString(pdidIndex, returnPdidIndex) != HC_SUCCESS) {
-        LOGE("Failed to copy pdidIndex!");
-        DestroyDeviceEntry(deviceEntry);
-        return HC_ERR_ALLOC_MEMORY;
-    }
-    DestroyDeviceEntry(deviceEntry);
-    return HC_SUCCESS;
+    return ctx.res;
 }
 
 static int32_t GetPdidIndexByISInfo(const CJson *context, char **returnPdidIndex)
@@ -263,19 +292,12 @@ static int32_t SetPeerAuthIdByDb(CJson *context, const char *groupId)
         LOGE("Failed to get peer udid!");
         return HC_ERR_JSON_GET;
     }
-    TrustedDeviceEntry *entry = GetDeviceEntryById(osAccountId, peerUdid, true, groupId);
-    if (entry == NULL) {
+    PeerAuthIdVisitCtx ctx = { context, HC_ERR_DEVICE_NOT_EXIST };
+    (void)VisitDeviceEntryById(osAccountId, peerUdid, true, groupId, SetPeerAuthIdVisitor, &ctx);
+    if (ctx.res == HC_ERR_DEVICE_NOT_EXIST) {
         LOGE("Failed to get device entry!");
-        return HC_ERR_DEVICE_NOT_EXIST;
-    }
-    const char *peerAuthId = StringGet(&entry->authId);
-    if (AddStringToJson(context, FIELD_PEER_AUTH_ID, peerAuthId) != HC_SUCCESS) {
-        LOGE("Failed to add peer authId to context!");
-        DestroyDeviceEntry(entry);
-        return HC_ERR_JSON_ADD;
     }
-    DestroyDeviceEntry(entry);
-    return HC_SUCCESS;
+    return ctx.res;
 }
 
 static int32_t SetPeerAuthIdByCredAuthInfo(CJson *context)
@@ -577,10 +599,9 @@ int32_t AddPkInfoWithPdid(const CJson *context, CJson *credInfo, bool isCredAuth
     return HC_SUCCESS;
 }
 
-TrustedDeviceEntry *GetDeviceEntryById(int32_t osAccountId, const char *deviceId, bool isUdid,
-    const char *groupId)
+int32_t VisitDeviceEntryById(int32_t osAccountId, const char *deviceId, bool isUdid, const char *groupId,
+    DeviceEntryVisitor visitor, void *ctx)
 {
-    DeviceEntryVec deviceEntryVec = CreateDeviceEntryVec();
     QueryDeviceParams params = InitQueryDeviceParams();
     params.groupId = groupId;
     if (isUdid) {
@@ -588,20 +609,19 @@ TrustedDeviceEntry *GetDeviceEntryById(int32_t osAccountId, const char *deviceId
     } else {
         params.authId = deviceId;
     }
-    if (QueryDevices(osAccountId, &params, &deviceEntryVec) != HC_SUCCESS) {
+    int32_t res = VisitDevices(osAccountId, &params, visitor, ctx);
+    if (res != HC_SUCCESS) {
         LOGE("Failed to query trusted devices!");
-        ClearDeviceEntryVec(&deviceEntryVec);
-        return NULL;
-    }
-    uint32_t index;
-    TrustedDeviceEntry **deviceEntry;
-    FOR_EACH_HC_VECTOR(deviceEntryVec, index, deviceEntry) {
-        TrustedDeviceEntry *returnEntry = DeepCopyDeviceEntry(*deviceEntry);
-        ClearDeviceEntryVec(&deviceEntryVec);
-        return returnEntry;
-    }
-    ClearDeviceEntryVec(&deviceEntryVec);
-    return NULL;
+    }
+    return res;
+}
+
+TrustedDeviceEntry *GetDeviceEntryById(int32_t osAccountId, const char *deviceId, bool isUdid,
+    const char *groupId)
+{
+    TrustedDeviceEntry *returnEntry = NULL;
+    (void)VisitDeviceEntryById(osAccountId, deviceId, isUdid, groupId, CopyDeviceEntryVisitor, &returnEntry);
+    return returnEntry;
 }
 
 int32_t BuildPeerCertInfo(const char *pkInfoStr, const char *pkInfoSignHexStr, int32_t signAlg,
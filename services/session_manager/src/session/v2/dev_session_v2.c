@@ -592,9 +592,22 @@ static int32_t GetSelfCredByInput(SessionImpl *impl, const CJson *inputData)
     return HC_SUCCESS;
 }
 
+static int32_t AllocDevSessionSalt(SessionImpl *impl)
+{
+    if (impl->salt.val != NULL) {
+        return HC_SUCCESS;
+    }
+    impl->salt.val = (uint8_t *)ArenaAlloc(&impl->arena, DEV_SESSION_SALT_LEN);
+    if (impl->salt.val == NULL) {
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    impl->salt.length = DEV_SESSION_SALT_LEN;
+    return HC_SUCCESS;
+}
+
 static int32_t GenerateDevSessionSalt(SessionImpl *impl)
 {
-    if (InitUint8Buff(&impl->salt, DEV_SESSION_SALT_LEN) != HC_SUCCESS) {
+    if (AllocDevSessionSalt(impl) != HC_SUCCESS) {
         LOGE("Failed to alloc salt memory!");
         return HC_ERR_ALLOC_MEMORY;
     }
@@ -632,6 +645,10 @@ static int32_t AddSessionInfoToEventData(SessionImpl *impl, CJson *eventData)
         LOGE("add cred num to json fail.");
         return HC_ERR_JSON_ADD;
     }
+    if (AddBoolToJson(eventData, FIELD_SUPPORT_COMPACT_MSG, true) != HC_SUCCESS) {
+        LOGE("add compact msg ability to json fail.");
+        return HC_ERR_JSON_ADD;
+    }
     return HC_SUCCESS;
 }
 
@@ -973,39 +990,56 @@ static int32_t AddAcrossAccountGroupInfoToContext(SessionImpl *impl, const Trust
     return HC_SUCCESS;
 }
 
-static int32_t AddGroupInfoToContext(SessionImpl *impl, int32_t osAccountId, const char *groupId)
+typedef struct {
+    SessionImpl *impl;
+    int32_t res;
+} ContextVisitCtx;
+
+static bool AddGroupInfoVisitor(const TrustedGroupEntry *entry, void *ctx)
 {
-    TrustedGroupEntry *entry = GetGroupEntryById(osAccountId, groupId);
-    if (entry == NULL) {
-        LOGE("The group cannot be found!");
-        return HC_ERR_GROUP_NOT_EXIST;
-    }
-    int32_t res = HC_ERROR;
+    ContextVisitCtx *visitCtx = (ContextVisitCtx *)ctx;
     if (entry->type == IDENTICAL_ACCOUNT_GROUP) {
-        res = AddIdenticalAccountGroupInfoToContext(impl, entry);
+        visitCtx->res = AddIdenticalAccountGroupInfoToContext(visitCtx->impl, entry);
     } else if (entry->type == PEER_TO_PEER_GROUP) {
-        res = AddP2PGroupInfoToContext(impl, entry);
+        visitCtx->res = AddP2PGroupInfoToContext(visitCtx->impl, entry);
     } else {
-        res = AddAcrossAccountGroupInfoToContext(impl, entry);
+        visitCtx->res = AddAcrossAccountGroupInfoToContext(visitCtx->impl, entry);
     }
-    DestroyGroupEntry(entry);
-    return res;
+    return false;
+}
+
+static bool AddDevInfoVisitor(const TrustedDeviceEntry *entry, void *ctx)
+{
+    ContextVisitCtx *visitCtx = (ContextVisitCtx *)ctx;
+    if (AddStringToJson(visitCtx->impl->context, FIELD_AUTH_ID, StringGet(&entry->authId)) != HC_SUCCESS) {
+        LOGE("add selfAuthId to context fail.");
+        visitCtx->res = HC_ERR_ALLOC_MEMORY;
+        return false;
+    }
+    visitCtx->res = HC_SUCCESS;
+    return false;
+}
+
+static int32_t AddGroupInfoToContext(SessionImpl *impl, int32_t osAccountId, const char *groupId)
+{
+    QueryGroupParams params = InitQueryGroupParams();
+    params.groupId = groupId;
+    ContextVisitCtx ctx = { impl, HC_ERR_GROUP_NOT_EXIST };
+    (void)VisitGroups(osAccountId, &params, AddGroupInfoVisitor, &ctx);
+    if (ctx.res == HC_ERR_GROUP_NOT_EXIST) {
+        LOGE("The group cannot be found!");
+    }
+    return ctx.res;
 }
 
 static int32_t AddDevInfoToContext(SessionImpl *impl, int32_t osAccountId, const char *groupId, const char *selfUdid)
 {
-    TrustedDeviceEntry *deviceEntry = GetDeviceEntryById(osAccountId, selfUdid, true, groupId);
-    if (deviceEntry == NULL) {
+    ContextVisitCtx ctx = { impl, HC_ERR_DEVICE_NOT_EXIST };
+    (void)VisitDeviceEntryById(osAccountId, selfUdid, true, groupId, AddDevInfoVisitor, &ctx);
+    if (ctx.res == HC_ERR_DEVICE_NOT_EXIST) {
         LOGE("The trusted device is not found!");
-        return HC_ERR_DEVICE_NOT_EXIST;
     }
-    if (AddStringToJson(impl->context, FIELD_AUTH_ID, StringGet(&deviceEntry->authId)) != HC_SUCCESS) {
-        LOGE("add selfAuthId to context fail.");
-        DestroyDeviceEntry(deviceEntry);
-        return HC_ERR_ALLOC_MEMORY;
-    }
-    DestroyDeviceEntry(deviceEntry);
-    return HC_SUCCESS;
+    return ctx.res;
 }
 
 static int32_t AddAuthInfoToContextByDb(SessionImpl *impl, const char *selfUdid, CJson *urlJson)
@@ -1266,7 +1300,7 @@ static int32_t ProcStartEventInner(SessionImpl *impl, CJson *sessionMsg)
 
 static int32_t GetSessionSaltFromInput(SessionImpl *impl, const CJson *inputData)
 {
-    if (InitUint8Buff(&impl->salt, DEV_SESSION_SALT_LEN) != HC_SUCCESS) {
+    if (AllocDevSessionSalt(impl) != HC_SUCCESS) {
         LOGE("Allocate salt memory fail.");
         return HC_ERR_ALLOC_MEMORY;
     }
@@ -1383,6 +1417,10 @@ static int32_t GenerateHandshakeRspEventData(SessionImpl *impl, IdentityInfo *se
         LOGE("add version to json fail.");
         return HC_ERR_JSON_ADD;
     }
+    if (impl->isCompactMsg && (AddBoolToJson(eventData, FIELD_SUPPORT_COMPACT_MSG, true) != HC_SUCCESS)) {
+        LOGE("add compact msg ability to json fail.");
+        return HC_ERR_JSON_ADD;
+    }
     int32_t res = AddCredInfoToEventData(impl, selfCred, eventData);
     if (res != HC_SUCCESS) {
         return res;
@@ -1636,6 +1674,8 @@ static int32_t ProcHandshakeReqEventInner(SessionImpl *impl, SessionEvent *input
     if (res != HC_SUCCESS) {
         return res;
     }
+    /* an old peer does not send the flag and keeps getting json */
+    (void)GetBoolFromJson(inputEvent->data, FIELD_SUPPORT_COMPACT_MSG, &impl->isCompactMsg);
     return AddHandshakeRspMsg(impl, selfCred, sessionMsg);
 }
 
@@ -1692,6 +1732,7 @@ static int32_t ProcHandshakeRspEventInner(SessionImpl *impl, SessionEvent *input
     if (res != HC_SUCCESS) {
         return res;
     }
+    (void)GetBoolFromJson(inputEvent->data, FIELD_SUPPORT_COMPACT_MSG, &impl->isCompactMsg);
     return SetAuthProtectedMsg(impl, inputEvent->data, false);
 }
 
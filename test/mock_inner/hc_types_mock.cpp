@@ -44,6 +44,11 @@ extern "C" void *HcMalloc(uint32_t size, char val)
     return RealHcMalloc(size, val);
 }
 
+extern "C" void *HcMallocUninit(uint32_t size)
+{
+    return RealHcMalloc(size, 0);
+}
+
 extern "C" void HcFree(void *addr)
 {
     if (g_mockHcTypes) {
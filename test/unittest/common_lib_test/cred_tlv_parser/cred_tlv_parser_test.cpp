@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include "cred_tlv_parser.h"
+#include "hc_parcel.h"
+#include "hc_types.h"
+
+using namespace testing::ext;
+
+namespace {
+static const uint32_t TEST_BUFFER_SIZE = 32;
+
+class CredTlvParserTest : public testing::Test {
+};
+
+HWTEST_F(CredTlvParserTest, ParseCredTlvStringTest001, TestSize.Level0)
+{
+    CredTlvString tlvString;
+    InitCredTlvString(&tlvString, 0x1234);
+    HcParcel parcel = CreateParcel(TEST_BUFFER_SIZE, TEST_BUFFER_SIZE);
+    const char data[] = "test";
+    ParcelWrite(&parcel, data, sizeof(data) - 1);
+    CredTlvBase *tlvBase = (CredTlvBase *)&tlvString;
+    tlvBase->length = sizeof(data) - 1;
+    int64_t ret = ParseCredTlvString(tlvBase, &parcel, HC_FALSE);
+    EXPECT_EQ(ret, CRED_TLV_FAIL);
+    EXPECT_EQ(GetParcelDataSize(&tlvString.data.parcel), 0U);
+    DeleteParcel(&parcel);
+    tlvString.base.deinit((CredTlvBase *)&tlvString);
+}
+
+HWTEST_F(CredTlvParserTest, ParseCredTlvStringTest002, TestSize.Level0)
+{
+    CredTlvString tlvString;
+    InitCredTlvString(&tlvString, 0x1234);
+    HcParcel parcel = CreateParcel(TEST_BUFFER_SIZE, TEST_BUFFER_SIZE);
+    const char data[] = "test";
+    ParcelWrite(&parcel, data, sizeof(data));
+    CredTlvBase *tlvBase = (CredTlvBase *)&tlvString;
+    tlvBase->length = sizeof(data);
+    int64_t ret = ParseCredTlvString(tlvBase, &parcel, HC_FALSE);
+    EXPECT_EQ(ret, (int64_t)sizeof(data));
+    EXPECT_STREQ(StringGet(&tlvString.data), data);
+    DeleteParcel(&parcel);
+    tlvString.base.deinit((CredTlvBase *)&tlvString);
+}
+
+HWTEST_F(CredTlvParserTest, ParseCredTlvStringTest003, TestSize.Level0)
+{
+    CredTlvString tlvString;
+    InitCredTlvString(&tlvString, 0x1234);
+    HcParcel parcel = CreateParcel(TEST_BUFFER_SIZE, TEST_BUFFER_SIZE);
+    const char data[] = "test";
+    ParcelWrite(&parcel, data, sizeof(data) - 1);
+    CredTlvBase *tlvBase = (CredTlvBase *)&tlvString;
+    tlvBase->length = sizeof(data);
+    int64_t ret = ParseCredTlvString(tlvBase, &parcel, HC_FALSE);
+    EXPECT_EQ(ret, CRED_TLV_FAIL);
+    DeleteParcel(&parcel);
+    tlvString.base.deinit((CredTlvBase *)&tlvString);
+}
+}
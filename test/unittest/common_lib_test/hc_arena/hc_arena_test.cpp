@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include "base/security/device_auth/common_lib/interfaces/hc_arena.h"
+#include "base/security/device_auth/common_lib/interfaces/clib_error.h"
+
+using namespace std;
+using namespace testing::ext;
+namespace {
+static const uint32_t TEST_CHUNK_SIZE = 64;
+static const uint32_t TEST_ALIGN = 8;
+
+class HcArenaTest : public testing::Test {};
+
+HWTEST_F(HcArenaTest, ArenaAllocTest001, TestSize.Level0)
+{
+    HcArena arena;
+    InitArena(&arena, TEST_CHUNK_SIZE);
+    EXPECT_EQ(ArenaAlloc(nullptr, 1), nullptr);
+    EXPECT_EQ(ArenaAlloc(&arena, 0), nullptr);
+    EXPECT_EQ(arena.head, nullptr);
+
+    uint8_t *first = static_cast<uint8_t *>(ArenaAlloc(&arena, 1));
+    ASSERT_NE(first, nullptr);
+    uint8_t *second = static_cast<uint8_t *>(ArenaAlloc(&arena, TEST_ALIGN));
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(second, first + TEST_ALIGN);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % TEST_ALIGN, 0);
+    for (uint32_t i = 0; i < TEST_ALIGN; i++) {
+        EXPECT_EQ(second[i], 0);
+    }
+    DestroyArena(&arena);
+    EXPECT_EQ(arena.head, nullptr);
+}
+
+HWTEST_F(HcArenaTest, ArenaAllocTest002, TestSize.Level0)
+{
+    HcArena arena;
+    InitArena(&arena, TEST_CHUNK_SIZE);
+    void *small = ArenaAlloc(&arena, TEST_ALIGN);
+    ASSERT_NE(small, nullptr);
+    HcArenaChunk *head = arena.head;
+    // a block larger than the chunk size must not take the place of the head chunk
+    void *large = ArenaAlloc(&arena, TEST_CHUNK_SIZE * 2);
+    ASSERT_NE(large, nullptr);
+    EXPECT_EQ(arena.head, head);
+    uint8_t *next = static_cast<uint8_t *>(ArenaAlloc(&arena, TEST_ALIGN));
+    EXPECT_EQ(next, static_cast<uint8_t *>(small) + TEST_ALIGN);
+    // once the head chunk is used up a new one is created
+    for (uint32_t i = 0; i < TEST_CHUNK_SIZE / TEST_ALIGN; i++) {
+        EXPECT_NE(ArenaAlloc(&arena, TEST_ALIGN), nullptr);
+    }
+    EXPECT_NE(arena.head, head);
+    DestroyArena(&arena);
+    DestroyArena(&arena);
+    DestroyArena(nullptr);
+}
+
+HWTEST_F(HcArenaTest, ArenaCopyStringTest001, TestSize.Level0)
+{
+    HcArena arena;
+    InitArena(&arena, TEST_CHUNK_SIZE);
+    char *str = nullptr;
+    EXPECT_EQ(ArenaCopyString(nullptr, "test", &str), CLIB_ERR_NULL_PTR);
+    EXPECT_EQ(ArenaCopyString(&arena, nullptr, &str), CLIB_ERR_NULL_PTR);
+    EXPECT_EQ(ArenaCopyString(&arena, "test", nullptr), CLIB_ERR_NULL_PTR);
+    EXPECT_EQ(ArenaCopyString(&arena, "", &str), CLIB_ERR_INVALID_LEN);
+    EXPECT_EQ(ArenaCopyString(&arena, "test", &str), CLIB_SUCCESS);
+    EXPECT_STREQ(str, "test");
+    DestroyArena(&arena);
+}
+}
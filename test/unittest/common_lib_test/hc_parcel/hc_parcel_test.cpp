@@ -1709,4 +1709,81 @@ HWTEST_F(HcParcelTest, ParcelWriteWithNullParcelTest003, TestSize.Level0)
     HcBool ret = ParcelWrite(nullptr, data, sizeof(data));
     EXPECT_EQ(ret, HC_FALSE);
 }
+
+static uint32_t g_releasedLength = 0;
+
+static void RecordReleasedData(char *data, uint32_t length)
+{
+    (void)data;
+    g_releasedLength = length;
+}
+
+HWTEST_F(HcParcelTest, ReadOnlyParcelTest001, TestSize.Level0)
+{
+    char data[sizeof(uint32_t) + sizeof(uint16_t)] = { 0 };
+    uint32_t srcUint32 = 0x12345678;
+    uint16_t srcUint16 = 0xABCD;
+    (void)memcpy_s(data, sizeof(data), &srcUint32, sizeof(srcUint32));
+    (void)memcpy_s(data + sizeof(srcUint32), sizeof(data) - sizeof(srcUint32), &srcUint16, sizeof(srcUint16));
+    g_releasedLength = 0;
+    HcParcel parcel = CreateReadOnlyParcel(data, sizeof(data), RecordReleasedData);
+    EXPECT_EQ(GetParcelDataSize(&parcel), sizeof(data));
+    EXPECT_EQ(GetParcelData(&parcel), data);
+
+    uint32_t dstUint32 = 0;
+    EXPECT_EQ(ParcelReadUint32(&parcel, &dstUint32), HC_TRUE);
+    EXPECT_EQ(dstUint32, srcUint32);
+    EXPECT_EQ(ParcelWriteUint32(&parcel, srcUint32), HC_FALSE);
+    uint16_t dstUint16 = 0;
+    EXPECT_EQ(ParcelEraseBlock(&parcel, 0, sizeof(dstUint16), &dstUint16), HC_FALSE);
+    EXPECT_EQ(ParcelReadUint16(&parcel, &dstUint16), HC_TRUE);
+    EXPECT_EQ(dstUint16, srcUint16);
+
+    DeleteParcel(&parcel);
+    EXPECT_EQ(g_releasedLength, sizeof(data));
+    EXPECT_EQ(parcel.isReadOnly, HC_FALSE);
+    EXPECT_EQ(ParcelWriteUint16(&parcel, srcUint16), HC_TRUE);
+    DeleteParcel(&parcel);
+}
+
+HWTEST_F(HcParcelTest, ParcelReserveTest001, TestSize.Level0)
+{
+    HcParcel parcel = CreateParcel(0, 0);
+    EXPECT_EQ(ParcelReserve(nullptr, TEST_BUFFER_SIZE), HC_FALSE);
+    EXPECT_EQ(ParcelReserve(&parcel, TEST_BUFFER_SIZE_LARGE), HC_TRUE);
+    EXPECT_GE(parcel.length, TEST_BUFFER_SIZE_LARGE);
+    const char *data = parcel.data;
+    for (uint32_t i = 0; i < TEST_BUFFER_SIZE_LARGE / sizeof(uint32_t); i++) {
+        EXPECT_EQ(ParcelWriteUint32(&parcel, i), HC_TRUE);
+    }
+    EXPECT_EQ(parcel.data, data);
+    EXPECT_EQ(ParcelReserve(&parcel, 0), HC_TRUE);
+    DeleteParcel(&parcel);
+
+    char buffer[TEST_BUFFER_SIZE] = { 0 };
+    parcel = CreateReadOnlyParcel(buffer, sizeof(buffer), nullptr);
+    EXPECT_EQ(ParcelReserve(&parcel, TEST_BUFFER_SIZE), HC_FALSE);
+    DeleteParcel(&parcel);
+}
+
+HWTEST_F(HcParcelTest, ParcelGeometricGrowthTest001, TestSize.Level0)
+{
+    HcParcel parcel = CreateParcel(0, sizeof(uint32_t));
+    uint32_t reallocNum = 0;
+    const char *data = nullptr;
+    for (uint32_t i = 0; i < TEST_BUFFER_SIZE_LARGE; i++) {
+        EXPECT_EQ(ParcelWriteUint32(&parcel, i), HC_TRUE);
+        if (parcel.data != data) {
+            reallocNum++;
+            data = parcel.data;
+        }
+    }
+    EXPECT_LT(reallocNum, TEST_BUFFER_SIZE);
+    for (uint32_t i = 0; i < TEST_BUFFER_SIZE_LARGE; i++) {
+        uint32_t value = 0;
+        EXPECT_EQ(ParcelReadUint32(&parcel, &value), HC_TRUE);
+        EXPECT_EQ(value, i);
+    }
+    DeleteParcel(&parcel);
+}
 }
@@ -53,6 +53,7 @@ void ResetMemmoveFail(void)
 }
 
 void *__real_HcMalloc(uint32_t size, uint32_t maxLen);
+void *__real_HcMallocUninit(uint32_t size);
 errno_t __real_memmove_s(void *dest, uint32_t destMax, const void *src, uint32_t count);
 errno_t __real_memcpy_s(void *dest, uint32_t destMax, const void *src, uint32_t count);
 
@@ -64,6 +65,14 @@ void *__wrap_HcMalloc(uint32_t size, uint32_t maxLen)
     return __real_HcMalloc(size, maxLen);
 }
 
+void *__wrap_HcMallocUninit(uint32_t size)
+{
+    if (GetHcMallocFail()) {
+        return NULL;
+    }
+    return __real_HcMallocUninit(size);
+}
+
 errno_t __wrap_memmove_s(void *dest, uint32_t destMax, const void *src, uint32_t count)
 {
     if (GetMemmoveFail()) {
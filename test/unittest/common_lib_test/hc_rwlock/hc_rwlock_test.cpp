@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include "hc_rwlock.h"
+#include "securec.h"
+
+using namespace testing::ext;
+
+namespace {
+static const int TEST_ITERATION_COUNT = 100;
+static const int TEST_THREAD_COUNT = 5;
+
+struct RwLockTestData {
+    HcRwLock *rwLock;
+    int *counter;
+    int iterationCount;
+};
+
+void *ThreadWriteRoutine(void *arg)
+{
+    RwLockTestData *data = static_cast<RwLockTestData *>(arg);
+    for (int i = 0; i < data->iterationCount; i++) {
+        WriteLockHcRwLock(data->rwLock);
+        (*data->counter)++;
+        UnlockHcRwLock(data->rwLock);
+    }
+    return nullptr;
+}
+
+void *ThreadTryWriteRoutine(void *arg)
+{
+    HcRwLock *rwLock = static_cast<HcRwLock *>(arg);
+    int res = pthread_rwlock_trywrlock(&rwLock->rwlock);
+    if (res == 0) {
+        pthread_rwlock_unlock(&rwLock->rwlock);
+    }
+    return reinterpret_cast<void *>(static_cast<intptr_t>(res));
+}
+
+class HcRwLockTest : public testing::Test {
+};
+
+HWTEST_F(HcRwLockTest, InitHcRwLockTest001, TestSize.Level0)
+{
+    HcRwLock rwLock;
+    EXPECT_EQ(InitHcRwLock(&rwLock), 0);
+    EXPECT_TRUE(rwLock.isInitialized);
+    DestroyHcRwLock(&rwLock);
+    EXPECT_FALSE(rwLock.isInitialized);
+}
+
+HWTEST_F(HcRwLockTest, InitHcRwLockTest002, TestSize.Level0)
+{
+    EXPECT_EQ(InitHcRwLock(nullptr), -1);
+    DestroyHcRwLock(nullptr);
+    EXPECT_EQ(ReadLockHcRwLock(nullptr), -1);
+    EXPECT_EQ(WriteLockHcRwLock(nullptr), -1);
+    UnlockHcRwLock(nullptr);
+}
+
+HWTEST_F(HcRwLockTest, LockHcRwLockTest001, TestSize.Level0)
+{
+    HcRwLock rwLock;
+    ASSERT_EQ(InitHcRwLock(&rwLock), 0);
+    EXPECT_EQ(ReadLockHcRwLock(&rwLock), 0);
+    EXPECT_EQ(pthread_rwlock_tryrdlock(&rwLock.rwlock), 0);
+    pthread_t thread;
+    void *threadRes = nullptr;
+    ASSERT_EQ(pthread_create(&thread, nullptr, ThreadTryWriteRoutine, &rwLock), 0);
+    pthread_join(thread, &threadRes);
+    EXPECT_NE(reinterpret_cast<intptr_t>(threadRes), 0);
+    UnlockHcRwLock(&rwLock);
+    UnlockHcRwLock(&rwLock);
+    EXPECT_EQ(WriteLockHcRwLock(&rwLock), 0);
+    EXPECT_NE(pthread_rwlock_tryrdlock(&rwLock.rwlock), 0);
+    UnlockHcRwLock(&rwLock);
+    DestroyHcRwLock(&rwLock);
+}
+
+HWTEST_F(HcRwLockTest, LockHcRwLockTest002, TestSize.Level0)
+{
+    HcRwLock rwLock;
+    (void)memset_s(&rwLock, sizeof(rwLock), 0, sizeof(rwLock));
+    EXPECT_EQ(ReadLockHcRwLock(&rwLock), -1);
+    EXPECT_EQ(WriteLockHcRwLock(&rwLock), -1);
+}
+
+HWTEST_F(HcRwLockTest, MultiThreadTest001, TestSize.Level0)
+{
+    HcRwLock rwLock;
+    ASSERT_EQ(InitHcRwLock(&rwLock), 0);
+    int counter = 0;
+    RwLockTestData data = { &rwLock, &counter, TEST_ITERATION_COUNT };
+    pthread_t threads[TEST_THREAD_COUNT];
+    for (int i = 0; i < TEST_THREAD_COUNT; i++) {
+        ASSERT_EQ(pthread_create(&threads[i], nullptr, ThreadWriteRoutine, &data), 0);
+    }
+    for (int i = 0; i < TEST_THREAD_COUNT; i++) {
+        pthread_join(threads[i], nullptr);
+    }
+    EXPECT_EQ(counter, TEST_ITERATION_COUNT * TEST_THREAD_COUNT);
+    DestroyHcRwLock(&rwLock);
+}
+}
@@ -350,6 +350,37 @@ HWTEST_F(HcTlvParserTest, ParseTlvStringTest001, TestSize.Level0)
     tlvString.base.deinit((TlvBase *)&tlvString);
 }
 
+HWTEST_F(HcTlvParserTest, ParseTlvStringTest002, TestSize.Level0)
+{
+    TlvString tlvString;
+    InitTlvString(&tlvString, 0x1234);
+    HcParcel parcel = CreateParcel(TEST_BUFFER_SIZE, TEST_BUFFER_SIZE);
+    const char data[] = "test";
+    ParcelWrite(&parcel, data, sizeof(data) - 1);
+    TlvBase *tlvBase = (TlvBase *)&tlvString;
+    tlvBase->length = sizeof(data) - 1;
+    int32_t ret = ParseTlvString(tlvBase, &parcel, HC_FALSE);
+    EXPECT_EQ(ret, TLV_FAIL);
+    DeleteParcel(&parcel);
+    tlvString.base.deinit((TlvBase *)&tlvString);
+}
+
+HWTEST_F(HcTlvParserTest, ParseTlvStringTest003, TestSize.Level0)
+{
+    TlvString tlvString;
+    InitTlvString(&tlvString, 0x1234);
+    HcParcel parcel = CreateParcel(TEST_BUFFER_SIZE, TEST_BUFFER_SIZE);
+    const char data[] = "test";
+    ParcelWrite(&parcel, data, sizeof(data));
+    TlvBase *tlvBase = (TlvBase *)&tlvString;
+    tlvBase->length = sizeof(data);
+    int32_t ret = ParseTlvString(tlvBase, &parcel, HC_FALSE);
+    EXPECT_EQ(ret, sizeof(data));
+    EXPECT_STREQ(StringGet(&tlvString.data), data);
+    DeleteParcel(&parcel);
+    tlvString.base.deinit((TlvBase *)&tlvString);
+}
+
 HWTEST_F(HcTlvParserTest, EncodeTlvStringTest001, TestSize.Level0)
 {
     TlvString tlvString;
@@ -470,4 +501,29 @@ HWTEST_F(HcTlvParserTest, ParseTlvStructSuccessTest001, TestSize.Level0)
     DeleteParcel(&parcel);
     tlvStruct.base.deinit((TlvBase *)&tlvStruct);
 }
+
+HWTEST_F(HcTlvParserTest, ParseTlvStructWithEmptyUnknownTagTest001, TestSize.Level0)
+{
+    TestTlvStruct tlvStruct;
+    InitTestTlvStruct(&tlvStruct, 0x1000);
+
+    HcParcel parcel = CreateParcel(TEST_BUFFER_SIZE * 2, TEST_BUFFER_SIZE);
+    ParcelWriteUint16(&parcel, 0x1000);
+    ParcelWriteUint16(&parcel, 20);
+    ParcelWriteUint16(&parcel, 0x0001);
+    ParcelWriteUint16(&parcel, sizeof(uint32_t));
+    ParcelWriteUint32(&parcel, 0x11111111);
+    ParcelWriteUint16(&parcel, 0x9999);
+    ParcelWriteUint16(&parcel, 0);
+    ParcelWriteUint16(&parcel, 0x0002);
+    ParcelWriteUint16(&parcel, sizeof(uint32_t));
+    ParcelWriteUint32(&parcel, 0x22222222);
+
+    int32_t ret = ParseTlvNode((TlvBase *)&tlvStruct, &parcel, HC_FALSE);
+    EXPECT_EQ(ret, 24);
+    EXPECT_EQ(tlvStruct.member2.data, 0x22222222);
+
+    DeleteParcel(&parcel);
+    tlvStruct.base.deinit((TlvBase *)&tlvStruct);
+}
 }
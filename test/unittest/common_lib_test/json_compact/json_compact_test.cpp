@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include "json_compact.h"
+#include "clib_error.h"
+#include "hc_types.h"
+
+using namespace testing::ext;
+
+namespace {
+static const char *TEST_SESSION_MSG = "[{\"type\":1,\"data\":{\"vr\":\"2.0.0\","
+    "\"salt\":\"8A3F9C0D11E2B7A45C6D7E8F90A1B2C3D4E5F60718293A4B5C6D7E8F9A0B1C2D\",\"index\":0,\"total\":3,"
+    "\"peerUserType\":-1,\"ratio\":0.25,\"big\":1e300,\"isDirectAuth\":false,\"isBind\":true,\"extInfo\":null,"
+    "\"lowerHex\":\"abcdef\",\"oddHex\":\"ABC\",\"empty\":\"\",\"text\":\"quote\\\" \\\\ tab\\t\","
+    "\"spCmds\":[{\"id\":1,\"vr\":\"1.0.0\"},{\"id\":2,\"vr\":\"1.0.0\"}],\"ability\":[[],{}]}}]";
+static const uint32_t TEST_MAX_DEPTH = 10;
+
+class JsonCompactTest : public testing::Test {};
+
+static CJson *RoundTrip(const CJson *jsonObj, uint32_t *compactLen)
+{
+    HcParcel parcel = CreateParcel(0, 0);
+    if (PackJsonToCompactData(jsonObj, &parcel) != CLIB_SUCCESS) {
+        DeleteParcel(&parcel);
+        return nullptr;
+    }
+    *compactLen = GetParcelDataSize(&parcel);
+    CJson *decoded = CreateJsonFromCompactData(reinterpret_cast<const uint8_t *>(GetParcelData(&parcel)),
+        GetParcelDataSize(&parcel));
+    DeleteParcel(&parcel);
+    return decoded;
+}
+
+static CJson *CreateNestedArray(uint32_t depth)
+{
+    CJson *root = CreateJsonArray();
+    CJson *cur = root;
+    for (uint32_t i = 1; i < depth; i++) {
+        CJson *child = CreateJsonArray();
+        (void)cJSON_AddItemToArray(cur, child);
+        cur = child;
+    }
+    return root;
+}
+
+HWTEST_F(JsonCompactTest, CompactRoundTripTest001, TestSize.Level0)
+{
+    CJson *json = CreateJsonFromString(TEST_SESSION_MSG);
+    ASSERT_NE(json, nullptr);
+    uint32_t compactLen = 0;
+    CJson *decoded = RoundTrip(json, &compactLen);
+    ASSERT_NE(decoded, nullptr);
+    char *origin = PackJsonToString(json);
+    char *result = PackJsonToString(decoded);
+    ASSERT_NE(origin, nullptr);
+    ASSERT_NE(result, nullptr);
+    EXPECT_STREQ(origin, result);
+    EXPECT_LT(compactLen, HcStrlen(origin));
+    FreeJsonString(origin);
+    FreeJsonString(result);
+    FreeJson(decoded);
+    FreeJson(json);
+}
+
+HWTEST_F(JsonCompactTest, CompactRoundTripTest002, TestSize.Level0)
+{
+    CJson *json = CreateJson();
+    ASSERT_NE(json, nullptr);
+    EXPECT_EQ(AddInt64StringToJson(json, "requestId", INT64_MAX), CLIB_SUCCESS);
+    EXPECT_EQ(AddIntToJson(json, "min", INT32_MIN), CLIB_SUCCESS);
+    uint8_t bytes[] = { 0x00, 0x0F, 0xF0, 0xFF };
+    EXPECT_EQ(AddByteToJson(json, "bytes", bytes, sizeof(bytes)), CLIB_SUCCESS);
+    uint32_t compactLen = 0;
+    CJson *decoded = RoundTrip(json, &compactLen);
+    ASSERT_NE(decoded, nullptr);
+    int64_t requestId = 0;
+    EXPECT_EQ(GetInt64FromJson(decoded, "requestId", &requestId), CLIB_SUCCESS);
+    EXPECT_EQ(requestId, INT64_MAX);
+    int32_t min = 0;
+    EXPECT_EQ(GetIntFromJson(decoded, "min", &min), CLIB_SUCCESS);
+    EXPECT_EQ(min, INT32_MIN);
+    uint8_t result[sizeof(bytes)] = { 0 };
+    EXPECT_EQ(GetByteFromJson(decoded, "bytes", result, sizeof(result)), CLIB_SUCCESS);
+    EXPECT_EQ(memcmp(bytes, result, sizeof(bytes)), 0);
+    FreeJson(decoded);
+    FreeJson(json);
+}
+
+HWTEST_F(JsonCompactTest, CompactDepthTest001, TestSize.Level0)
+{
+    CJson *json = CreateNestedArray(TEST_MAX_DEPTH);
+    uint32_t compactLen = 0;
+    CJson *decoded = RoundTrip(json, &compactLen);
+    EXPECT_NE(decoded, nullptr);
+    FreeJson(decoded);
+    FreeJson(json);
+
+    json = CreateNestedArray(TEST_MAX_DEPTH + 1);
+    HcParcel parcel = CreateParcel(0, 0);
+    EXPECT_EQ(PackJsonToCompactData(json, &parcel), CLIB_ERR_INVALID_PARAM);
+    DeleteParcel(&parcel);
+    FreeJson(json);
+}
+
+HWTEST_F(JsonCompactTest, CompactInvalidParamTest001, TestSize.Level0)
+{
+    HcParcel parcel = CreateParcel(0, 0);
+    EXPECT_EQ(PackJsonToCompactData(nullptr, &parcel), CLIB_ERR_NULL_PTR);
+    CJson *raw = cJSON_CreateRaw("1");
+    EXPECT_EQ(PackJsonToCompactData(raw, nullptr), CLIB_ERR_NULL_PTR);
+    EXPECT_EQ(PackJsonToCompactData(raw, &parcel), CLIB_ERR_INVALID_PARAM);
+    FreeJson(raw);
+    DeleteParcel(&parcel);
+    const uint8_t data[] = { 1, 0 };
+    EXPECT_EQ(CreateJsonFromCompactData(nullptr, sizeof(data)), nullptr);
+    EXPECT_EQ(CreateJsonFromCompactData(data, 0), nullptr);
+}
+
+HWTEST_F(JsonCompactTest, CompactInvalidDataTest001, TestSize.Level0)
+{
+    const uint8_t badVersion[] = { 2, 0 };
+    EXPECT_EQ(CreateJsonFromCompactData(badVersion, sizeof(badVersion)), nullptr);
+    const uint8_t badTag[] = { 1, 0x7F };
+    EXPECT_EQ(CreateJsonFromCompactData(badTag, sizeof(badTag)), nullptr);
+    const uint8_t trailing[] = { 1, 0, 0 };
+    EXPECT_EQ(CreateJsonFromCompactData(trailing, sizeof(trailing)), nullptr);
+    const uint8_t hugeCount[] = { 1, 7, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0 };
+    EXPECT_EQ(CreateJsonFromCompactData(hugeCount, sizeof(hugeCount)), nullptr);
+    const uint8_t embeddedNul[] = { 1, 5, 3, 'a', 0, 0 };
+    EXPECT_EQ(CreateJsonFromCompactData(embeddedNul, sizeof(embeddedNul)), nullptr);
+    const uint8_t noTerminator[] = { 1, 5, 2, 'a', 'b' };
+    EXPECT_EQ(CreateJsonFromCompactData(noTerminator, sizeof(noTerminator)), nullptr);
+}
+
+HWTEST_F(JsonCompactTest, CompactTruncatedDataTest001, TestSize.Level0)
+{
+    CJson *json = CreateJsonFromString(TEST_SESSION_MSG);
+    ASSERT_NE(json, nullptr);
+    HcParcel parcel = CreateParcel(0, 0);
+    EXPECT_EQ(PackJsonToCompactData(json, &parcel), CLIB_SUCCESS);
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(GetParcelData(&parcel));
+    for (uint32_t len = 1; len < GetParcelDataSize(&parcel); len++) {
+        EXPECT_EQ(CreateJsonFromCompactData(data, len), nullptr);
+    }
+    DeleteParcel(&parcel);
+    FreeJson(json);
+}
+}
@@ -14,6 +14,10 @@
  */
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
 #include "json_utils.h"
 #include "clib_error.h"
 #include "hc_types.h"
@@ -60,6 +64,28 @@ HWTEST_F(JsonUtilsTest, CreateJsonFromDataTest004, TestSize.Level0)
     FreeJson(json);
 }
 
+HWTEST_F(JsonUtilsTest, CreateJsonFromDataTest005, TestSize.Level0)
+{
+    // the buffer is parsed in place, bytes after dataLen must not be read
+    const char data[] = "{\"key\":\"value\"}{\"key\":";
+    CJson *json = nullptr;
+    int32_t ret = CreateJsonFromData(reinterpret_cast<const uint8_t *>(data), sizeof(TEST_DATA) - 1, &json);
+    EXPECT_EQ(ret, CLIB_SUCCESS);
+    EXPECT_STREQ(GetStringFromJson(json, "key"), "value");
+    FreeJson(json);
+}
+
+HWTEST_F(JsonUtilsTest, CreateJsonFromDataTest006, TestSize.Level0)
+{
+    const char data[] = "[[[[[[[[[[[1]]]]]]]]]]]";
+    CJson *json = nullptr;
+    int32_t ret = CreateJsonFromData(reinterpret_cast<const uint8_t *>(data), sizeof(data) - 1, &json);
+    EXPECT_EQ(ret, CLIB_ERR_JSON_CREATE);
+    EXPECT_EQ(CreateJsonFromString(data), nullptr);
+    EXPECT_EQ(CreateJsonFromData(reinterpret_cast<const uint8_t *>(data), sizeof(data) - 1, nullptr),
+        CLIB_ERR_INVALID_PARAM);
+}
+
 HWTEST_F(JsonUtilsTest, CreateJsonFromStringTest001, TestSize.Level0)
 {
     CJson *json = CreateJsonFromString(TEST_JSON_STR);
@@ -200,6 +226,57 @@ HWTEST_F(JsonUtilsTest, PackJsonToStringTest001, TestSize.Level0)
     FreeJson(json);
 }
 
+HWTEST_F(JsonUtilsTest, PackJsonToStringTest003, TestSize.Level0)
+{
+    const char *input = "{\"id\":\"123\",\"bigIntArr\":[\"id\",\"name\",\"seq\",\"missing\"],"
+        "\"name\":\"abc\",\"inner\":{\"seq\":\"9007199254740993\"},\"seq\":\"1\"}";
+    CJson *json = CreateJsonFromString(input);
+    ASSERT_NE(json, nullptr);
+    char *str = PackJsonToString(json);
+    ASSERT_NE(str, nullptr);
+    EXPECT_STREQ(str, "{\"id\":123,\"name\":\"abc\",\"inner\":{\"seq\":9007199254740993},\"seq\":\"1\"}");
+    FreeJsonString(str);
+    // the source json is left untouched
+    EXPECT_STREQ(GetStringFromJson(json, "id"), "123");
+    EXPECT_NE(GetObjFromJson(json, "bigIntArr"), nullptr);
+    str = PackJsonToString(json);
+    ASSERT_NE(str, nullptr);
+    EXPECT_STREQ(str, "{\"id\":123,\"name\":\"abc\",\"inner\":{\"seq\":9007199254740993},\"seq\":\"1\"}");
+    FreeJsonString(str);
+    FreeJson(json);
+}
+
+HWTEST_F(JsonUtilsTest, PackJsonToStringTest004, TestSize.Level0)
+{
+    const char *input = "{\"id\":\"123\",\"bigIntArr\":[\"id\",\"seq\"],\"inner\":{\"seq\":\"456\"}}";
+    const char *expect = "{\"id\":123,\"inner\":{\"seq\":456}}";
+    CJson *json = CreateJsonFromString(input);
+    ASSERT_NE(json, nullptr);
+    // worker threads may print the same tree at the same time
+    const int threadNum = 4;
+    const int loopNum = 200;
+    std::atomic<int> mismatchNum(0);
+    std::vector<std::thread> printers;
+    for (int i = 0; i < threadNum; i++) {
+        printers.emplace_back([json, expect, loopNum, &mismatchNum]() {
+            for (int j = 0; j < loopNum; j++) {
+                char *str = PackJsonToString(json);
+                if (str == nullptr || strcmp(str, expect) != 0) {
+                    mismatchNum++;
+                }
+                FreeJsonString(str);
+            }
+        });
+    }
+    for (auto &printer : printers) {
+        printer.join();
+    }
+    EXPECT_EQ(mismatchNum.load(), 0);
+    EXPECT_STREQ(GetStringFromJson(json, "id"), "123");
+    EXPECT_EQ(GetItemNum(GetObjFromJson(json, "bigIntArr")), 2);
+    FreeJson(json);
+}
+
 HWTEST_F(JsonUtilsTest, PackJsonToStringTest002, TestSize.Level0)
 {
     char *str = PackJsonToString(nullptr);
@@ -838,4 +915,23 @@ HWTEST_F(JsonUtilsTest, ClearSensitiveStringInJsonNullStrTest001, TestSize.Level
     ClearSensitiveStringInJson(jsonObj, "nonexistent");
     FreeJson(jsonObj);
 }
-}
\ No newline at end of file
+
+HWTEST_F(JsonUtilsTest, GetNestedItemFromJsonTest001, TestSize.Level0)
+{
+    CJson *json = CreateJsonFromString("{\"value\":\"str\",\"arr\":[{\"flag\":true}],"
+        "\"first\":{\"name\":\"first\",\"inner\":{\"value\":1}},\"second\":{\"name\":\"second\",\"value\":2}}");
+    ASSERT_NE(json, nullptr);
+    // a top level item of another type is skipped and the first match in depth-first order wins
+    int32_t value = 0;
+    EXPECT_EQ(GetIntFromJson(json, "value", &value), CLIB_SUCCESS);
+    EXPECT_EQ(value, 1);
+    EXPECT_STREQ(GetStringFromJson(json, "value"), "str");
+    EXPECT_STREQ(GetStringFromJson(json, "name"), "first");
+    EXPECT_NE(GetObjFromJson(json, "inner"), nullptr);
+    // objects inside arrays are not searched
+    bool flag = false;
+    EXPECT_NE(GetBoolFromJson(json, "flag", &flag), CLIB_SUCCESS);
+    EXPECT_EQ(GetObjFromJson(json, "missing"), nullptr);
+    FreeJson(json);
+}
+}
@@ -416,6 +416,30 @@ HWTEST_F(StringUtilTest, HexStringToByteTest009, TestSize.Level0)
     EXPECT_EQ(byte[1], 0x12);
 }
 
+HWTEST_F(StringUtilTest, HexStringToByteTest010, TestSize.Level0)
+{
+    // every byte value goes through both lookup tables and comes back unchanged
+    uint8_t byte[UINT8_MAX + 1] = {0};
+    for (uint32_t i = 0; i < sizeof(byte); i++) {
+        byte[i] = static_cast<uint8_t>(i);
+    }
+    char hexStr[sizeof(byte) * BYTE_TO_HEX_OPER_LENGTH + 1] = {0};
+    EXPECT_EQ(ByteToHexString(byte, sizeof(byte), hexStr, sizeof(hexStr)), CLIB_SUCCESS);
+    uint8_t result[sizeof(byte)] = {0};
+    EXPECT_EQ(HexStringToByte(hexStr, result, sizeof(result)), CLIB_SUCCESS);
+    EXPECT_EQ(memcmp(byte, result, sizeof(byte)), 0);
+}
+
+HWTEST_F(StringUtilTest, HexStringToByteTest011, TestSize.Level0)
+{
+    // the chars next to the hex ranges and the ones above 0x7F are rejected
+    const char *invalidStrs[] = { "0/", "0:", "0@", "0G", "0`", "0g", "0\xB0" };
+    uint8_t byte[1] = {0};
+    for (const char *hexStr : invalidStrs) {
+        EXPECT_EQ(HexStringToByte(hexStr, byte, sizeof(byte)), CLIB_ERR_INVALID_PARAM);
+    }
+}
+
 HWTEST_F(StringUtilTest, PrintBufferTest001, TestSize.Level0)
 {
     uint8_t msg[] = {0x01, 0x02, 0x03, 0x04};
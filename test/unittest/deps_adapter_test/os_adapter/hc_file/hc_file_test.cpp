@@ -29,6 +29,7 @@ public:
 };
 
 static const char *TEST_FILE_PATH = "/data/local/tmp/hc_file_test.dat";
+static const char *TEST_TEMP_FILE_PATH = "/data/local/tmp/tmp_hc_file_test.dat";
 
 HWTEST_F(HcFileTest, HcFileOpenReadTest001, TestSize.Level0)
 {
@@ -169,3 +170,56 @@ HWTEST_F(HcFileTest, HcFileRemoveTest001, TestSize.Level0)
     ret = HcFileOpen(TEST_FILE_PATH, MODE_FILE_READ, &readFile);
     EXPECT_EQ(ret, -1);
 }
+
+HWTEST_F(HcFileTest, HcFileRenameNullPathTest001, TestSize.Level0)
+{
+    EXPECT_EQ(HcFileRename(nullptr, TEST_FILE_PATH), -1);
+    EXPECT_EQ(HcFileRename(TEST_FILE_PATH, nullptr), -1);
+}
+
+HWTEST_F(HcFileTest, HcFileRenameTest001, TestSize.Level0)
+{
+    FileHandle writeFile;
+    writeFile.pfd = nullptr;
+    int ret = HcFileOpen(TEST_TEMP_FILE_PATH, MODE_FILE_WRITE, &writeFile);
+    EXPECT_EQ(ret, 0);
+    HcFileWrite(writeFile, "test", 4);
+    HcFileClose(writeFile);
+    EXPECT_EQ(HcFileRename(TEST_TEMP_FILE_PATH, TEST_FILE_PATH), 0);
+
+    FileHandle readFile;
+    readFile.pfd = nullptr;
+    EXPECT_EQ(HcFileOpen(TEST_TEMP_FILE_PATH, MODE_FILE_READ, &readFile), -1);
+    ret = HcFileOpen(TEST_FILE_PATH, MODE_FILE_READ, &readFile);
+    EXPECT_EQ(ret, 0);
+    char buf[5] = { 0 };
+    EXPECT_EQ(HcFileRead(readFile, buf, 4), 4);
+    EXPECT_STREQ(buf, "test");
+    HcFileClose(readFile);
+    HcFileRemove(TEST_FILE_PATH);
+    EXPECT_EQ(HcFileRename(TEST_TEMP_FILE_PATH, TEST_FILE_PATH), -1);
+}
+
+HWTEST_F(HcFileTest, HcFileMapReadTest001, TestSize.Level0)
+{
+    FileHandle writeFile;
+    writeFile.pfd = nullptr;
+    int ret = HcFileOpen(TEST_FILE_PATH, MODE_FILE_WRITE, &writeFile);
+    EXPECT_EQ(ret, 0);
+    HcFileWrite(writeFile, "test", 4);
+    HcFileClose(writeFile);
+
+    FileHandle readFile;
+    readFile.pfd = nullptr;
+    EXPECT_EQ(HcFileMapRead(readFile, 4), nullptr);
+    ret = HcFileOpen(TEST_FILE_PATH, MODE_FILE_READ, &readFile);
+    EXPECT_EQ(ret, 0);
+    EXPECT_EQ(HcFileMapRead(readFile, 0), nullptr);
+    char *addr = HcFileMapRead(readFile, HcFileSize(readFile));
+    HcFileClose(readFile);
+    ASSERT_NE(addr, nullptr);
+    EXPECT_EQ(memcmp(addr, "test", 4), 0);
+    HcFileUnmap(addr, 4);
+    HcFileUnmap(nullptr, 4);
+    HcFileRemove(TEST_FILE_PATH);
+}
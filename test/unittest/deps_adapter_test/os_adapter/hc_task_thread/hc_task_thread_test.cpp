@@ -14,7 +14,9 @@
  */
 
 #include <gtest/gtest.h>
+#include <thread>
 #include <unistd.h>
+#include <vector>
 #include "hc_task_thread.h"
 #include "hc_dev_info.h"
 
@@ -23,6 +25,9 @@ using namespace testing::ext;
 namespace {
 static volatile int g_taskActionCount = 0;
 static const int32_t TEST_TASK_WAIT_TIME_US = 100000;
+static const int32_t TEST_PRODUCER_NUM = 8;
+static const int32_t TEST_TASK_NUM_PER_PRODUCER = 1000;
+static const int32_t TEST_WAIT_RETRY_NUM = 100;
 
 static void TestTaskDoAction(HcTaskBase *task)
 {
@@ -120,4 +125,56 @@ HWTEST_F(HcTaskThreadTest, StopAndClearNullTest001, TestSize.Level0)
 
     DestroyHcTaskThread(&thread);
 }
+
+HWTEST_F(HcTaskThreadTest, MultiProducerTest001, TestSize.Level0)
+{
+    HcTaskThread thread;
+    int32_t res = InitHcTaskThread(&thread, 0, "multiProducer");
+    EXPECT_EQ(res, 0);
+    res = thread.startThread(&thread);
+    EXPECT_EQ(res, 0);
+
+    std::vector<std::thread> producers;
+    for (int32_t i = 0; i < TEST_PRODUCER_NUM; i++) {
+        producers.emplace_back([&thread]() {
+            for (int32_t j = 0; j < TEST_TASK_NUM_PER_PRODUCER; j++) {
+                thread.pushTask(&thread, CreateTestTask());
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    for (int32_t i = 0; i < TEST_WAIT_RETRY_NUM && g_taskActionCount < TEST_PRODUCER_NUM * TEST_TASK_NUM_PER_PRODUCER;
+        i++) {
+        usleep(TEST_TASK_WAIT_TIME_US);
+    }
+    EXPECT_EQ(g_taskActionCount, TEST_PRODUCER_NUM * TEST_TASK_NUM_PER_PRODUCER);
+
+    thread.stopAndClear(&thread);
+    DestroyHcTaskThread(&thread);
+}
+
+HWTEST_F(HcTaskThreadTest, OverflowTest001, TestSize.Level0)
+{
+    HcTaskThread thread;
+    int32_t res = InitHcTaskThread(&thread, 0, "overflowThread");
+    EXPECT_EQ(res, 0);
+
+    int32_t taskNum = HC_TASK_RING_SIZE * 2;
+    for (int32_t i = 0; i < taskNum; i++) {
+        thread.pushTask(&thread, CreateTestTask());
+    }
+    EXPECT_EQ(thread.overflowNum, static_cast<uint32_t>(taskNum - HC_TASK_RING_SIZE));
+    res = thread.startThread(&thread);
+    EXPECT_EQ(res, 0);
+    for (int32_t i = 0; i < TEST_WAIT_RETRY_NUM && g_taskActionCount < taskNum; i++) {
+        usleep(TEST_TASK_WAIT_TIME_US);
+    }
+    EXPECT_EQ(g_taskActionCount, taskNum);
+    EXPECT_EQ(thread.overflowNum, 0);
+
+    thread.stopAndClear(&thread);
+    DestroyHcTaskThread(&thread);
+}
 }
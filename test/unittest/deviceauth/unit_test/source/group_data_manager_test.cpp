@@ -14,10 +14,15 @@
  */
 
 #include "gtest/gtest.h"
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
 #include "group_data_manager.h"
 #include "device_auth_defines.h"
 #include "device_auth.h"
 #include "common_defs.h"
+#include "hc_file.h"
+#include "hc_types.h"
 using namespace testing::ext;
 namespace {
 static const int32_t TEST_OS_ACCOUNT_ID = 0;
@@ -26,6 +31,14 @@ static const char *TEST_GROUP_ID = "test_group_id";
 static const char *TEST_GROUP_NAME = "test_group_name";
 static const char *TEST_USER_ID = "0";
 static const char *TEST_SHARED_USER_ID = "test_sharedUser_id";
+static const char *TEST_UDID = "test_udid";
+static const char *TEST_UDID2 = "test_udid2";
+static const char *TEST_AUTH_ID = "test_auth_id";
+static const char *TEST_AUTH_ID2 = "test_auth_id2";
+static const char *TEST_DB_FILE_PATH = "/data/service/el1/public/deviceauthMock/hcgroup.dat";
+/* the first flush and the three retries queued by the failed flushes */
+static const uint32_t TEST_FAILED_FLUSH_RUN_NUM = 4;
+static std::vector<HcTaskBase *> g_flushTasks;
 class GroupDataManagerTest : public testing::Test {
 public:
     static void SetUpTestCase(void);
@@ -45,6 +58,69 @@ void GroupDataManagerTest::SetUp(void)
 void GroupDataManagerTest::TearDown(void)
 {
     DestroyDatabase();
+    for (HcTaskBase *task : g_flushTasks) {
+        HcFree(task);
+    }
+    g_flushTasks.clear();
+    (void)rmdir(TEST_DB_FILE_PATH);
+}
+
+/*
+ * Reloads the database from the file. ReloadOsAccountDb is not used as it moves the de file to the ce
+ * path first, while the loader reads the de path when os accounts are not supported.
+ */
+static void ReloadDatabase(void)
+{
+    DestroyDatabase();
+    InitDatabase();
+}
+
+static void ClearDatabase(void)
+{
+    DestroyDatabase();
+    HcFileRemove(TEST_DB_FILE_PATH);
+    InitDatabase();
+}
+
+static int32_t PushTestFlushTask(HcTaskBase *task)
+{
+    g_flushTasks.push_back(task);
+    return HC_SUCCESS;
+}
+
+/* Runs the queued flush tasks, including the ones queued again while running, and returns their number. */
+static uint32_t RunTestFlushTasks(void)
+{
+    uint32_t runNum = 0;
+    while (!g_flushTasks.empty()) {
+        HcTaskBase *task = g_flushTasks.front();
+        g_flushTasks.erase(g_flushTasks.begin());
+        task->doAction(task);
+        if (task->destroy != nullptr) {
+            task->destroy(task);
+        }
+        HcFree(task);
+        runNum++;
+    }
+    return runNum;
+}
+
+static bool IsDbFileExist(void)
+{
+    struct stat fileStat;
+    return stat(TEST_DB_FILE_PATH, &fileStat) == 0 && S_ISREG(fileStat.st_mode);
+}
+
+/* A directory in place of the database file makes the rename at the end of every flush fail. */
+static void BlockDbFile(void)
+{
+    HcFileRemove(TEST_DB_FILE_PATH);
+    ASSERT_EQ(mkdir(TEST_DB_FILE_PATH, S_IRWXU), 0);
+}
+
+static void UnblockDbFile(void)
+{
+    ASSERT_EQ(rmdir(TEST_DB_FILE_PATH), 0);
 }
 
 static TrustedGroupEntry *generateTestGroupEntry(void)
@@ -65,6 +141,53 @@ static TrustedGroupEntry *generateTestGroupEntry(void)
     return entry;
 }
 
+static TrustedDeviceEntry *generateTestDeviceEntry(const char *udid, const char *authId)
+{
+    TrustedDeviceEntry *entry = CreateDeviceEntry();
+    if (entry == NULL) {
+        return NULL;
+    }
+    StringSetPointer(&(entry->groupId), TEST_GROUP_ID);
+    StringSetPointer(&(entry->udid), udid);
+    StringSetPointer(&(entry->authId), authId);
+    StringSetPointer(&(entry->userId), TEST_USER_ID);
+    StringSetPointer(&(entry->serviceType), TEST_GROUP_ID);
+    return entry;
+}
+
+static uint32_t GetQueryGroupNum(void)
+{
+    QueryGroupParams params = InitQueryGroupParams();
+    GroupEntryVec vec = CreateGroupEntryVec();
+    (void)QueryGroups(TEST_OS_ACCOUNT_ID, &params, &vec);
+    uint32_t num = HC_VECTOR_SIZE(&vec);
+    ClearGroupEntryVec(&vec);
+    return num;
+}
+
+static uint32_t GetQueryDeviceNum(const QueryDeviceParams *params)
+{
+    DeviceEntryVec vec = CreateDeviceEntryVec();
+    (void)QueryDevices(TEST_OS_ACCOUNT_ID, params, &vec);
+    uint32_t num = HC_VECTOR_SIZE(&vec);
+    ClearDeviceEntryVec(&vec);
+    return num;
+}
+
+static bool CountDeviceVisitor(const TrustedDeviceEntry *entry, void *ctx)
+{
+    (void)entry;
+    (*(uint32_t *)ctx)++;
+    return true;
+}
+
+static bool StopDeviceVisitor(const TrustedDeviceEntry *entry, void *ctx)
+{
+    (void)entry;
+    (*(uint32_t *)ctx)++;
+    return false;
+}
+
 HWTEST_F(GroupDataManagerTest, DelGroupTEST001, TestSize.Level0)
 {
     QueryGroupParams param = InitQueryGroupParams();
@@ -78,4 +201,173 @@ HWTEST_F(GroupDataManagerTest, DelGroupTEST001, TestSize.Level0)
     ClearGroupEntryVec(&vec);
     DestroyGroupEntry(entry);
 }
-}
\ No newline at end of file
+
+HWTEST_F(GroupDataManagerTest, QueryIndexedDevicesTEST001, TestSize.Level0)
+{
+    TrustedDeviceEntry *entry = generateTestDeviceEntry(TEST_UDID, TEST_AUTH_ID);
+    TrustedDeviceEntry *entry2 = generateTestDeviceEntry(TEST_UDID2, TEST_AUTH_ID);
+    ASSERT_NE(entry, nullptr);
+    ASSERT_NE(entry2, nullptr);
+    EXPECT_EQ(AddTrustedDevice(TEST_OS_ACCOUNT_ID, entry), HC_SUCCESS);
+    EXPECT_EQ(AddTrustedDevice(TEST_OS_ACCOUNT_ID, entry2), HC_SUCCESS);
+    QueryDeviceParams params = InitQueryDeviceParams();
+    params.groupId = TEST_GROUP_ID;
+    EXPECT_EQ(GetQueryDeviceNum(&params), 2);
+    params.udid = TEST_UDID2;
+    EXPECT_EQ(GetQueryDeviceNum(&params), 1);
+    params = InitQueryDeviceParams();
+    params.authId = TEST_AUTH_ID;
+    EXPECT_EQ(GetQueryDeviceNum(&params), 2);
+    params.userId = TEST_SHARED_USER_ID;
+    EXPECT_EQ(GetQueryDeviceNum(&params), 0);
+    DestroyDeviceEntry(entry);
+    DestroyDeviceEntry(entry2);
+}
+
+HWTEST_F(GroupDataManagerTest, QueryIndexedDevicesTEST002, TestSize.Level0)
+{
+    TrustedDeviceEntry *entry = generateTestDeviceEntry(TEST_UDID, TEST_AUTH_ID);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(AddTrustedDevice(TEST_OS_ACCOUNT_ID, entry), HC_SUCCESS);
+    StringSetPointer(&(entry->authId), TEST_AUTH_ID2);
+    EXPECT_EQ(AddTrustedDevice(TEST_OS_ACCOUNT_ID, entry), HC_SUCCESS);
+    QueryDeviceParams params = InitQueryDeviceParams();
+    params.authId = TEST_AUTH_ID;
+    EXPECT_EQ(GetQueryDeviceNum(&params), 0);
+    params.authId = TEST_AUTH_ID2;
+    EXPECT_EQ(GetQueryDeviceNum(&params), 1);
+    params = InitQueryDeviceParams();
+    params.udid = TEST_UDID;
+    EXPECT_EQ(DelTrustedDevice(TEST_OS_ACCOUNT_ID, &params), HC_SUCCESS);
+    EXPECT_EQ(GetQueryDeviceNum(&params), 0);
+    params.udid = NULL;
+    params.groupId = TEST_GROUP_ID;
+    EXPECT_EQ(GetQueryDeviceNum(&params), 0);
+    DestroyDeviceEntry(entry);
+}
+
+HWTEST_F(GroupDataManagerTest, VisitDevicesTEST001, TestSize.Level0)
+{
+    TrustedDeviceEntry *entry = generateTestDeviceEntry(TEST_UDID, TEST_AUTH_ID);
+    TrustedDeviceEntry *entry2 = generateTestDeviceEntry(TEST_UDID2, TEST_AUTH_ID2);
+    ASSERT_NE(entry, nullptr);
+    ASSERT_NE(entry2, nullptr);
+    EXPECT_EQ(AddTrustedDevice(TEST_OS_ACCOUNT_ID, entry), HC_SUCCESS);
+    EXPECT_EQ(AddTrustedDevice(TEST_OS_ACCOUNT_ID, entry2), HC_SUCCESS);
+    QueryDeviceParams params = InitQueryDeviceParams();
+    EXPECT_EQ(VisitDevices(TEST_OS_ACCOUNT_ID, nullptr, CountDeviceVisitor, nullptr), HC_ERR_NULL_PTR);
+    EXPECT_EQ(VisitDevices(TEST_OS_ACCOUNT_ID, &params, nullptr, nullptr), HC_ERR_NULL_PTR);
+    uint32_t num = 0;
+    params.groupId = TEST_GROUP_ID;
+    EXPECT_EQ(VisitDevices(TEST_OS_ACCOUNT_ID, &params, CountDeviceVisitor, &num), HC_SUCCESS);
+    EXPECT_EQ(num, 2);
+    num = 0;
+    EXPECT_EQ(VisitDevices(TEST_OS_ACCOUNT_ID, &params, StopDeviceVisitor, &num), HC_SUCCESS);
+    EXPECT_EQ(num, 1);
+    num = 0;
+    params.authId = TEST_AUTH_ID2;
+    EXPECT_EQ(VisitDevices(TEST_OS_ACCOUNT_ID, &params, CountDeviceVisitor, &num), HC_SUCCESS);
+    EXPECT_EQ(num, 1);
+    DestroyDeviceEntry(entry);
+    DestroyDeviceEntry(entry2);
+}
+
+HWTEST_F(GroupDataManagerTest, LazyLoadDevicesTEST001, TestSize.Level0)
+{
+    ClearDatabase();
+    TrustedDeviceEntry *entry = generateTestDeviceEntry(TEST_UDID, TEST_AUTH_ID);
+    TrustedDeviceEntry *entry2 = generateTestDeviceEntry(TEST_UDID2, TEST_AUTH_ID2);
+    ASSERT_NE(entry, nullptr);
+    ASSERT_NE(entry2, nullptr);
+    EXPECT_EQ(AddTrustedDevice(TEST_OS_ACCOUNT_ID, entry), HC_SUCCESS);
+    EXPECT_EQ(AddTrustedDevice(TEST_OS_ACCOUNT_ID, entry2), HC_SUCCESS);
+    EXPECT_EQ(SaveOsAccountDb(TEST_OS_ACCOUNT_ID), HC_SUCCESS);
+    ReloadDatabase();
+    QueryDeviceParams params = InitQueryDeviceParams();
+    params.udid = TEST_UDID;
+    EXPECT_EQ(GetQueryDeviceNum(&params), 1);
+    EXPECT_EQ(SaveOsAccountDb(TEST_OS_ACCOUNT_ID), HC_SUCCESS);
+    ReloadDatabase();
+    params = InitQueryDeviceParams();
+    params.userId = TEST_USER_ID;
+    EXPECT_EQ(GetQueryDeviceNum(&params), 2);
+    params = InitQueryDeviceParams();
+    params.authId = TEST_AUTH_ID2;
+    EXPECT_EQ(DelTrustedDevice(TEST_OS_ACCOUNT_ID, &params), HC_SUCCESS);
+    EXPECT_EQ(GetQueryDeviceNum(&params), 0);
+    EXPECT_EQ(SaveOsAccountDb(TEST_OS_ACCOUNT_ID), HC_SUCCESS);
+    DestroyDeviceEntry(entry);
+    DestroyDeviceEntry(entry2);
+}
+
+HWTEST_F(GroupDataManagerTest, DeferredFlushTEST001, TestSize.Level0)
+{
+    ClearDatabase();
+    SetGroupDbFlushScheduler(PushTestFlushTask);
+    TrustedGroupEntry *entry = generateTestGroupEntry();
+    TrustedDeviceEntry *deviceEntry = generateTestDeviceEntry(TEST_UDID, TEST_AUTH_ID);
+    TrustedDeviceEntry *deviceEntry2 = generateTestDeviceEntry(TEST_UDID2, TEST_AUTH_ID2);
+    ASSERT_NE(entry, nullptr);
+    ASSERT_NE(deviceEntry, nullptr);
+    ASSERT_NE(deviceEntry2, nullptr);
+    EXPECT_EQ(AddGroup(TEST_OS_ACCOUNT_ID, entry), HC_SUCCESS);
+    EXPECT_EQ(SaveOsAccountDb(TEST_OS_ACCOUNT_ID), HC_SUCCESS);
+    EXPECT_EQ(AddTrustedDevice(TEST_OS_ACCOUNT_ID, deviceEntry), HC_SUCCESS);
+    EXPECT_EQ(SaveOsAccountDb(TEST_OS_ACCOUNT_ID), HC_SUCCESS);
+    EXPECT_EQ(AddTrustedDevice(TEST_OS_ACCOUNT_ID, deviceEntry2), HC_SUCCESS);
+    EXPECT_EQ(SaveOsAccountDb(TEST_OS_ACCOUNT_ID), HC_SUCCESS);
+    // the three saves share one pending flush and nothing is written before it runs
+    EXPECT_EQ(g_flushTasks.size(), 1);
+    EXPECT_FALSE(IsDbFileExist());
+    EXPECT_EQ(RunTestFlushTasks(), 1);
+    EXPECT_TRUE(IsDbFileExist());
+    ReloadDatabase();
+    EXPECT_EQ(GetQueryGroupNum(), 1);
+    QueryDeviceParams params = InitQueryDeviceParams();
+    EXPECT_EQ(GetQueryDeviceNum(&params), 2);
+    DestroyGroupEntry(entry);
+    DestroyDeviceEntry(deviceEntry);
+    DestroyDeviceEntry(deviceEntry2);
+}
+
+HWTEST_F(GroupDataManagerTest, DeferredFlushTEST002, TestSize.Level0)
+{
+    ClearDatabase();
+    SetGroupDbFlushScheduler(PushTestFlushTask);
+    TrustedGroupEntry *entry = generateTestGroupEntry();
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(AddGroup(TEST_OS_ACCOUNT_ID, entry), HC_SUCCESS);
+    EXPECT_EQ(SaveOsAccountDb(TEST_OS_ACCOUNT_ID), HC_SUCCESS);
+    BlockDbFile();
+    EXPECT_EQ(RunTestFlushTasks(), TEST_FAILED_FLUSH_RUN_NUM);
+    UnblockDbFile();
+    EXPECT_FALSE(IsDbFileExist());
+    // the data is still dirty, so the next save queues a new flush that writes it
+    EXPECT_EQ(SaveOsAccountDb(TEST_OS_ACCOUNT_ID), HC_SUCCESS);
+    EXPECT_EQ(RunTestFlushTasks(), 1);
+    EXPECT_TRUE(IsDbFileExist());
+    ReloadDatabase();
+    EXPECT_EQ(GetQueryGroupNum(), 1);
+    DestroyGroupEntry(entry);
+}
+
+HWTEST_F(GroupDataManagerTest, DeferredFlushTEST003, TestSize.Level0)
+{
+    ClearDatabase();
+    SetGroupDbFlushScheduler(PushTestFlushTask);
+    TrustedGroupEntry *entry = generateTestGroupEntry();
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(AddGroup(TEST_OS_ACCOUNT_ID, entry), HC_SUCCESS);
+    EXPECT_EQ(SaveOsAccountDb(TEST_OS_ACCOUNT_ID), HC_SUCCESS);
+    BlockDbFile();
+    EXPECT_EQ(RunTestFlushTasks(), TEST_FAILED_FLUSH_RUN_NUM);
+    UnblockDbFile();
+    EXPECT_FALSE(IsDbFileExist());
+    // destroying the database flushes the dirty data synchronously
+    DestroyDatabase();
+    EXPECT_TRUE(IsDbFileExist());
+    InitDatabase();
+    EXPECT_EQ(GetQueryGroupNum(), 1);
+    DestroyGroupEntry(entry);
+}
+}
@@ -24,6 +24,7 @@
 #include "crypto_hash_to_point.h"
 #include "mbedtls_ec_adapter.h"
 #include "huks_adapter.h"
+#include "huks_adapter_utils.h"
 #include "string_util.h"
 #include "alg_loader.h"
 #include "device_auth.h"
@@ -37,7 +38,13 @@ static const int32_t SHA_256_LENGTH = 32;
 static const int32_t DEFAULT_RAND_LEN = 32;
 static const int32_t EC_LEN = 64;
 static const int32_t P256_PUBLIC_SIZE = 64;
+static const int32_t P256_KEY_SIZE = 32;
 static const int32_t BIGNUM_HEX_LEN = 512;
+static const int32_t HKDF_IKM_LEN = 22;
+static const int32_t HKDF_SALT_LEN = 13;
+static const int32_t HKDF_INFO_LEN = 10;
+static const int32_t HKDF_OKM_LEN = 42;
+static const int32_t LARGE_RAND_LEN = 2048;
 
 class KeyManagementTest : public testing::Test {
 public:
@@ -67,6 +74,26 @@ HWTEST_F(KeyManagementTest, HashToPointTest001, TestSize.Level0)
     HcFree(invalidDataBlob.data);
 }
 
+HWTEST_F(KeyManagementTest, HashToPointTest002, TestSize.Level0)
+{
+    EXPECT_EQ(InitMbedtlsBigNumCtx(), HAL_SUCCESS);
+    uint8_t hashData[KEY_BYTES_CURVE25519] = { 0 };
+    uint8_t hashCopy[KEY_BYTES_CURVE25519] = { 0 };
+    uint8_t pointData[KEY_BYTES_CURVE25519] = { 0 };
+    uint8_t mbedtlsPointData[KEY_BYTES_CURVE25519] = { 0 };
+    for (uint32_t round = 0; round < KEY_BYTES_CURVE25519; round++) {
+        (void)memset_s(hashData, KEY_BYTES_CURVE25519, round * KEY_BYTES_CURVE25519 + 1, KEY_BYTES_CURVE25519);
+        (void)memcpy_s(hashCopy, KEY_BYTES_CURVE25519, hashData, KEY_BYTES_CURVE25519);
+        struct HksBlob hashBlob = { KEY_BYTES_CURVE25519, hashCopy };
+        struct HksBlob pointBlob = { KEY_BYTES_CURVE25519, pointData };
+        EXPECT_EQ(OpensslHashToPoint(&hashBlob, &pointBlob), HAL_SUCCESS);
+        Uint8Buff hashBuffer = { hashData, KEY_BYTES_CURVE25519 };
+        Uint8Buff pointBuffer = { mbedtlsPointData, KEY_BYTES_CURVE25519 };
+        EXPECT_EQ(MbedtlsHashToPoint25519(&hashBuffer, &pointBuffer), HAL_SUCCESS);
+        EXPECT_EQ(memcmp(pointData, mbedtlsPointData, KEY_BYTES_CURVE25519), 0);
+    }
+}
+
 HWTEST_F(KeyManagementTest, MbedtlsHashToPointTest001, TestSize.Level0)
 {
     uint8_t hashData[SHA256_LEN] = { 0 };
@@ -103,6 +130,165 @@ HWTEST_F(KeyManagementTest, MbedtlsSharedSecretTest001, TestSize.Level0)
     EXPECT_EQ(ret, HAL_FAILED);
 }
 
+HWTEST_F(KeyManagementTest, MbedtlsSharedSecretTest002, TestSize.Level0)
+{
+    EXPECT_EQ(InitMbedtlsRng(), HAL_SUCCESS);
+    EXPECT_EQ(InitMbedtlsRng(), HAL_SUCCESS);
+    // base point of P256, the shared secret is priKey * G
+    uint8_t pubKeyData[P256_PUBLIC_SIZE] = {
+        0x6B, 0x17, 0xD1, 0xF2, 0xE1, 0x2C, 0x42, 0x47,
+        0xF8, 0xBC, 0xE6, 0xE5, 0x63, 0xA4, 0x40, 0xF2,
+        0x77, 0x03, 0x7D, 0x81, 0x2D, 0xEB, 0x33, 0xA0,
+        0xF4, 0xA1, 0x39, 0x45, 0xD8, 0x98, 0xC2, 0x96,
+        0x4F, 0xE3, 0x42, 0xE2, 0xFE, 0x1A, 0x7F, 0x9B,
+        0x8E, 0xE7, 0xEB, 0x4A, 0x7C, 0x0F, 0x9E, 0x16,
+        0x2B, 0xCE, 0x33, 0x57, 0x6B, 0x31, 0x5E, 0xCE,
+        0xCB, 0xB6, 0x40, 0x68, 0x37, 0xBF, 0x51, 0xF5
+    };
+    uint8_t priKeyData[P256_KEY_SIZE] = { 0 };
+    (void)memset_s(priKeyData, P256_KEY_SIZE, 0x01, P256_KEY_SIZE);
+    uint8_t sharedKeyData[P256_PUBLIC_SIZE] = { 0 };
+    uint8_t otherSharedKeyData[P256_PUBLIC_SIZE] = { 0 };
+    KeyBuff priKeyBuffer = { priKeyData, P256_KEY_SIZE, false };
+    KeyBuff pubKeyBuffer = { pubKeyData, P256_PUBLIC_SIZE, false };
+    Uint8Buff sharedKeyBuffer = { sharedKeyData, P256_PUBLIC_SIZE };
+    Uint8Buff otherSharedKeyBuffer = { otherSharedKeyData, P256_PUBLIC_SIZE };
+    EXPECT_EQ(MbedtlsAgreeSharedSecret(&priKeyBuffer, &pubKeyBuffer, &sharedKeyBuffer), HAL_SUCCESS);
+    EXPECT_EQ(MbedtlsAgreeSharedSecret(&priKeyBuffer, &pubKeyBuffer, &otherSharedKeyBuffer), HAL_SUCCESS);
+    EXPECT_EQ(memcmp(sharedKeyData, otherSharedKeyData, P256_PUBLIC_SIZE), 0);
+    Uint8Buff pubKeyCheckBuffer = { pubKeyData, P256_PUBLIC_SIZE };
+    EXPECT_EQ(MbedtlsIsP256PublicKeyValid(&pubKeyCheckBuffer), true);
+}
+
+HWTEST_F(KeyManagementTest, MbedtlsBigNumExpModTest001, TestSize.Level0)
+{
+    EXPECT_EQ(InitMbedtlsBigNumCtx(), HAL_SUCCESS);
+    uint8_t baseData[] = { 0x02 };
+    uint8_t expData[] = { 0x01, 0x00, 0x01 };
+    uint8_t outData[BIG_PRIME_LEN_384] = { 0 };
+    Uint8Buff baseBuff = { baseData, sizeof(baseData) };
+    Uint8Buff expBuff = { expData, sizeof(expData) };
+    Uint8Buff outBuff = { outData, BIG_PRIME_LEN_384 };
+    int32_t ret = MbedtlsBigNumExpMod(&baseBuff, &expBuff, DL_PRIME_HEX_384, &outBuff);
+    EXPECT_EQ(ret, HAL_SUCCESS);
+    ret = MbedtlsBigNumExpMod(&baseBuff, &expBuff, "TestPrimeHex", &outBuff);
+    EXPECT_EQ(ret, HAL_ERR_NOT_SUPPORTED);
+    ret = MbedtlsBigNumExpMod(nullptr, &expBuff, DL_PRIME_HEX_384, &outBuff);
+    EXPECT_EQ(ret, HAL_ERR_INVALID_PARAM);
+    outBuff.length = BIG_PRIME_LEN_256;
+    ret = MbedtlsBigNumExpMod(&baseBuff, &expBuff, DL_PRIME_HEX_384, &outBuff);
+    EXPECT_EQ(ret, HAL_ERR_INVALID_LEN);
+}
+
+static void CheckMbedtlsBigNumExpMod(const char *primeHex, uint32_t primeLen)
+{
+    uint8_t baseData[EC_LEN] = { 0 };
+    uint8_t expData[SHA_256_LENGTH] = { 0 };
+    (void)memset_s(baseData, sizeof(baseData), 0x5A, sizeof(baseData));
+    (void)memset_s(expData, sizeof(expData), 0xA5, sizeof(expData));
+    uint8_t outData[BIG_PRIME_LEN_384] = { 0 };
+    uint8_t huksOutData[BIG_PRIME_LEN_384] = { 0 };
+    Uint8Buff baseBuff = { baseData, sizeof(baseData) };
+    Uint8Buff expBuff = { expData, sizeof(expData) };
+    Uint8Buff outBuff = { outData, primeLen };
+    Uint8Buff huksOutBuff = { huksOutData, primeLen };
+    EXPECT_EQ(MbedtlsBigNumExpMod(&baseBuff, &expBuff, primeHex, &outBuff), HAL_SUCCESS);
+    EXPECT_EQ(BigNumExpMod(&baseBuff, &expBuff, primeHex, &huksOutBuff), HAL_SUCCESS);
+    EXPECT_EQ(memcmp(outData, huksOutData, primeLen), 0);
+
+    // 2 ^ 1 mod p is 2, left padded to the prime length
+    uint8_t twoData[] = { 0x02 };
+    uint8_t oneData[] = { 0x01 };
+    Uint8Buff twoBuff = { twoData, sizeof(twoData) };
+    Uint8Buff oneBuff = { oneData, sizeof(oneData) };
+    EXPECT_EQ(MbedtlsBigNumExpMod(&twoBuff, &oneBuff, primeHex, &outBuff), HAL_SUCCESS);
+    uint8_t expectData[BIG_PRIME_LEN_384] = { 0 };
+    expectData[primeLen - 1] = 0x02;
+    EXPECT_EQ(memcmp(outData, expectData, primeLen), 0);
+}
+
+HWTEST_F(KeyManagementTest, MbedtlsBigNumExpModTest002, TestSize.Level0)
+{
+    EXPECT_EQ(InitMbedtlsBigNumCtx(), HAL_SUCCESS);
+    CheckMbedtlsBigNumExpMod(DL_PRIME_HEX_384, BIG_PRIME_LEN_384);
+    CheckMbedtlsBigNumExpMod(DL_PRIME_HEX_256, BIG_PRIME_LEN_256);
+}
+
+HWTEST_F(KeyManagementTest, MbedtlsLocalCryptoTest001, TestSize.Level0)
+{
+    // RFC 4231 test case 2
+    uint8_t hmacKeyData[] = { 'J', 'e', 'f', 'e' };
+    uint8_t hmacMsgData[] = "what do ya want for nothing?";
+    uint8_t hmacData[SHA_256_LENGTH] = { 0 };
+    uint8_t expectData[SHA_256_LENGTH] = { 0 };
+    KeyBuff hmacKeyBuff = { hmacKeyData, sizeof(hmacKeyData), false };
+    Uint8Buff hmacMsgBuff = { hmacMsgData, sizeof(hmacMsgData) - 1 };
+    Uint8Buff hmacBuff = { hmacData, SHA_256_LENGTH };
+    EXPECT_EQ(MbedtlsComputeHmac(&hmacKeyBuff, &hmacMsgBuff, &hmacBuff), HAL_SUCCESS);
+    EXPECT_EQ(HexStringToByte("5BDCC146BF60754E6A042426089575C75A003F089D2739839DEC58B964EC3843",
+        expectData, SHA_256_LENGTH), CLIB_SUCCESS);
+    EXPECT_EQ(memcmp(hmacData, expectData, SHA_256_LENGTH), 0);
+
+    // RFC 5869 test case 1
+    uint8_t ikmData[HKDF_IKM_LEN] = { 0 };
+    (void)memset_s(ikmData, HKDF_IKM_LEN, 0x0B, HKDF_IKM_LEN);
+    uint8_t saltData[HKDF_SALT_LEN] = { 0 };
+    uint8_t infoData[HKDF_INFO_LEN] = { 0 };
+    uint8_t okmData[HKDF_OKM_LEN] = { 0 };
+    uint8_t expectOkmData[HKDF_OKM_LEN] = { 0 };
+    EXPECT_EQ(HexStringToByte("000102030405060708090A0B0C", saltData, HKDF_SALT_LEN), CLIB_SUCCESS);
+    EXPECT_EQ(HexStringToByte("F0F1F2F3F4F5F6F7F8F9", infoData, HKDF_INFO_LEN), CLIB_SUCCESS);
+    EXPECT_EQ(HexStringToByte("3CB25F25FAACD57A90434F64D0362F2A2D2D0A90CF1A5A4C5DB02D56ECC4C5BF"
+        "34007208D5B887185865", expectOkmData, HKDF_OKM_LEN), CLIB_SUCCESS);
+    KeyBuff ikmBuff = { ikmData, HKDF_IKM_LEN, false };
+    Uint8Buff saltBuff = { saltData, HKDF_SALT_LEN };
+    Uint8Buff infoBuff = { infoData, HKDF_INFO_LEN };
+    Uint8Buff okmBuff = { okmData, HKDF_OKM_LEN };
+    EXPECT_EQ(MbedtlsComputeHkdf(&ikmBuff, &saltBuff, &infoBuff, &okmBuff), HAL_SUCCESS);
+    EXPECT_EQ(memcmp(okmData, expectOkmData, HKDF_OKM_LEN), 0);
+
+    // RFC 7748 section 6.1
+    uint8_t priKeyData[KEY_BYTES_CURVE25519] = { 0 };
+    uint8_t pubKeyData[KEY_BYTES_CURVE25519] = { 0 };
+    uint8_t sharedData[KEY_BYTES_CURVE25519] = { 0 };
+    uint8_t expectSharedData[KEY_BYTES_CURVE25519] = { 0 };
+    EXPECT_EQ(HexStringToByte("77076D0A7318A57D3C16C17251B26645DF4C2F87EBC0992AB177FBA51DB92C2A",
+        priKeyData, KEY_BYTES_CURVE25519), CLIB_SUCCESS);
+    EXPECT_EQ(HexStringToByte("DE9EDB7D7B7DC1B4D35B61C2ECE435373F8343C85B78674DADFC7E146F882B4F",
+        pubKeyData, KEY_BYTES_CURVE25519), CLIB_SUCCESS);
+    EXPECT_EQ(HexStringToByte("4A5D9D5BA4CE2DE1728E3BF480350F25E07E21C947D19E3376F09B3C1E161742",
+        expectSharedData, KEY_BYTES_CURVE25519), CLIB_SUCCESS);
+    KeyBuff priKeyBuff = { priKeyData, KEY_BYTES_CURVE25519, false };
+    KeyBuff pubKeyBuff = { pubKeyData, KEY_BYTES_CURVE25519, false };
+    Uint8Buff sharedBuff = { sharedData, KEY_BYTES_CURVE25519 };
+    EXPECT_EQ(MbedtlsAgreeSharedSecret25519(&priKeyBuff, &pubKeyBuff, &sharedBuff), HAL_SUCCESS);
+    EXPECT_EQ(memcmp(sharedData, expectSharedData, KEY_BYTES_CURVE25519), 0);
+    uint8_t lowOrderData[KEY_BYTES_CURVE25519] = { 0 };
+    KeyBuff lowOrderBuff = { lowOrderData, KEY_BYTES_CURVE25519, false };
+    EXPECT_NE(MbedtlsAgreeSharedSecret25519(&priKeyBuff, &lowOrderBuff, &sharedBuff), HAL_SUCCESS);
+}
+
+HWTEST_F(KeyManagementTest, MbedtlsLocalCryptoTest002, TestSize.Level0)
+{
+    uint8_t msgData[] = "abc";
+    uint8_t hashData[SHA_256_LENGTH] = { 0 };
+    uint8_t expectData[SHA_256_LENGTH] = { 0 };
+    Uint8Buff msgBuff = { msgData, sizeof(msgData) - 1 };
+    Uint8Buff hashBuff = { hashData, SHA_256_LENGTH };
+    EXPECT_EQ(MbedtlsSha256(&msgBuff, &hashBuff), HAL_SUCCESS);
+    EXPECT_EQ(HexStringToByte("BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD",
+        expectData, SHA_256_LENGTH), CLIB_SUCCESS);
+    EXPECT_EQ(memcmp(hashData, expectData, SHA_256_LENGTH), 0);
+
+    uint8_t randData[LARGE_RAND_LEN] = { 0 };
+    uint8_t zeroData[LARGE_RAND_LEN] = { 0 };
+    Uint8Buff randBuff = { randData, LARGE_RAND_LEN };
+    EXPECT_EQ(MbedtlsGenerateRandom(&randBuff), HAL_SUCCESS);
+    EXPECT_NE(memcmp(randData, zeroData, LARGE_RAND_LEN), 0);
+    Uint8Buff emptyBuff = { randData, 0 };
+    EXPECT_EQ(MbedtlsGenerateRandom(&emptyBuff), HAL_ERR_INVALID_PARAM);
+}
+
 HWTEST_F(KeyManagementTest, HuksAdapterTest001, TestSize.Level0)
 {
     int32_t ret = GetLoaderInstance()->initAlg();
@@ -166,4 +352,118 @@ HWTEST_F(KeyManagementTest, HuksAdapterTest004, TestSize.Level0)
     ret = GetLoaderInstance()->bigNumExpMod(&baseBuff, &expBuff, bigNumHex, &outBuff);
     EXPECT_EQ(ret, HAL_SUCCESS);
 }
+
+HWTEST_F(KeyManagementTest, HuksAdapterTest005, TestSize.Level0)
+{
+    int32_t ret = GetLoaderInstance()->initAlg();
+    EXPECT_EQ(ret, HAL_SUCCESS);
+    // lower case hex of the same prime is not precomputed and goes through the conversion
+    char lowerPrimeHex[] = DL_PRIME_HEX_256;
+    for (uint32_t i = 0; lowerPrimeHex[i] != '\0'; i++) {
+        lowerPrimeHex[i] = static_cast<char>(tolower(lowerPrimeHex[i]));
+    }
+    uint8_t baseData[] = { 0x02 };
+    uint8_t expData[] = { 0x01, 0x00, 0x01 };
+    uint8_t outData[BIG_PRIME_LEN_256] = { 0 };
+    uint8_t lowerOutData[BIG_PRIME_LEN_256] = { 0 };
+    Uint8Buff baseBuff = { baseData, sizeof(baseData) };
+    Uint8Buff expBuff = { expData, sizeof(expData) };
+    Uint8Buff outBuff = { outData, BIG_PRIME_LEN_256 };
+    Uint8Buff lowerOutBuff = { lowerOutData, BIG_PRIME_LEN_256 };
+    ret = GetLoaderInstance()->bigNumExpMod(&baseBuff, &expBuff, DL_PRIME_HEX_256, &outBuff);
+    EXPECT_EQ(ret, HAL_SUCCESS);
+    ret = GetLoaderInstance()->bigNumExpMod(&baseBuff, &expBuff, lowerPrimeHex, &lowerOutBuff);
+    EXPECT_EQ(ret, HAL_SUCCESS);
+    EXPECT_EQ(memcmp(outData, lowerOutData, BIG_PRIME_LEN_256), 0);
+
+    EXPECT_EQ(GetLoaderInstance()->checkDlPublicKey(&outBuff, DL_PRIME_HEX_256), true);
+    uint8_t primeData[BIG_PRIME_LEN_256] = { 0 };
+    EXPECT_EQ(HexStringToByte(DL_PRIME_HEX_256, primeData, BIG_PRIME_LEN_256), CLIB_SUCCESS);
+    primeData[BIG_PRIME_LEN_256 - 1] -= 1;
+    Uint8Buff primeBuff = { primeData, BIG_PRIME_LEN_256 };
+    EXPECT_EQ(GetLoaderInstance()->checkDlPublicKey(&primeBuff, DL_PRIME_HEX_256), false);
+    EXPECT_EQ(GetLoaderInstance()->checkDlPublicKey(&primeBuff, lowerPrimeHex), false);
+}
+
+HWTEST_F(KeyManagementTest, HuksAdapterTest006, TestSize.Level0)
+{
+    int32_t ret = GetLoaderInstance()->initAlg();
+    EXPECT_EQ(ret, HAL_SUCCESS);
+    struct HksParamSet *firstSet = nullptr;
+    struct HksParamSet *secondSet = nullptr;
+    struct HksParamSet *keySet = nullptr;
+    EXPECT_EQ(ConstructHmacParamSet(true, DEFAULT_OS_ACCOUNT, true, &firstSet), HAL_SUCCESS);
+    EXPECT_EQ(ConstructHmacParamSet(true, DEFAULT_OS_ACCOUNT, true, &secondSet), HAL_SUCCESS);
+    EXPECT_EQ(ConstructHmacParamSet(true, DEFAULT_OS_ACCOUNT, false, &keySet), HAL_SUCCESS);
+    EXPECT_EQ(firstSet, secondSet);
+    EXPECT_NE(firstSet, keySet);
+    FreeParamSet(firstSet);
+    FreeParamSet(keySet);
+    // the shared set is still alive after being released by its users
+    struct HksParam *aliasParam = nullptr;
+    EXPECT_EQ(HksGetParam(secondSet, HKS_TAG_IS_KEY_ALIAS, &aliasParam), HKS_SUCCESS);
+    ASSERT_NE(aliasParam, nullptr);
+    EXPECT_EQ(aliasParam->boolParam, true);
+    FreeParamSet(secondSet);
+
+    uint8_t msgData[] = { 0x01, 0x02, 0x03 };
+    uint8_t hashData[SHA_256_LENGTH] = { 0 };
+    uint8_t hashAgainData[SHA_256_LENGTH] = { 0 };
+    Uint8Buff msgBuff = { msgData, sizeof(msgData) };
+    Uint8Buff hashBuff = { hashData, SHA_256_LENGTH };
+    Uint8Buff hashAgainBuff = { hashAgainData, SHA_256_LENGTH };
+    EXPECT_EQ(GetLoaderInstance()->sha256(&msgBuff, &hashBuff), HAL_SUCCESS);
+    EXPECT_EQ(GetLoaderInstance()->sha256(&msgBuff, &hashAgainBuff), HAL_SUCCESS);
+    EXPECT_EQ(memcmp(hashData, hashAgainData, SHA_256_LENGTH), 0);
+}
+
+HWTEST_F(KeyManagementTest, HuksAdapterTest007, TestSize.Level0)
+{
+    EXPECT_EQ(InitKeyExistCache(), HAL_SUCCESS);
+    uint8_t aliasData[] = "TestKeyExistCacheAlias";
+    Uint8Buff aliasBuff = { aliasData, sizeof(aliasData) - 1 };
+    const int32_t otherOsAccount = DEFAULT_OS_ACCOUNT + 1;
+    KeyExistCacheStats before = { 0 };
+    GetKeyExistCacheStats(&before);
+    EXPECT_EQ(IsKeyExistCached(&aliasBuff, true, DEFAULT_OS_ACCOUNT), false);
+    uint64_t generation = GetKeyExistCacheGeneration();
+    AddKeyExistCache(&aliasBuff, true, DEFAULT_OS_ACCOUNT, generation);
+    AddKeyExistCache(&aliasBuff, false, otherOsAccount, generation);
+    EXPECT_EQ(IsKeyExistCached(&aliasBuff, true, DEFAULT_OS_ACCOUNT), true);
+    EXPECT_EQ(IsKeyExistCached(&aliasBuff, false, DEFAULT_OS_ACCOUNT), false);
+    EXPECT_EQ(IsKeyExistCached(&aliasBuff, false, otherOsAccount), true);
+    KeyExistCacheStats after = { 0 };
+    GetKeyExistCacheStats(&after);
+    EXPECT_EQ(after.hitCount - before.hitCount, 2U);
+    EXPECT_EQ(after.missCount - before.missCount, 2U);
+    EXPECT_EQ(after.entryCount - before.entryCount, 2U);
+
+    ClearKeyExistCache(otherOsAccount);
+    EXPECT_EQ(IsKeyExistCached(&aliasBuff, false, otherOsAccount), false);
+    EXPECT_EQ(IsKeyExistCached(&aliasBuff, true, DEFAULT_OS_ACCOUNT), true);
+    RemoveKeyExistCache(&aliasBuff, DEFAULT_OS_ACCOUNT);
+    EXPECT_EQ(IsKeyExistCached(&aliasBuff, true, DEFAULT_OS_ACCOUNT), false);
+    // a result taken before the removal must not come back
+    EXPECT_NE(GetKeyExistCacheGeneration(), generation);
+    AddKeyExistCache(&aliasBuff, true, DEFAULT_OS_ACCOUNT, generation);
+    EXPECT_EQ(IsKeyExistCached(&aliasBuff, true, DEFAULT_OS_ACCOUNT), false);
+}
+
+HWTEST_F(KeyManagementTest, HuksAdapterTest008, TestSize.Level0)
+{
+    EXPECT_EQ(InitParamSetCache(), HAL_SUCCESS);
+    // more params than a param set can hold, huks refuses to add them
+    struct HksParam params[HKS_DEFAULT_PARAM_CNT + 1];
+    for (uint32_t i = 0; i < HKS_DEFAULT_PARAM_CNT + 1; i++) {
+        params[i].tag = HKS_TAG_IS_KEY_ALIAS;
+        params[i].boolParam = true;
+    }
+    struct HksParamSet *paramSet = nullptr;
+    EXPECT_NE(ConstructCachedParamSet(&paramSet, params, HKS_DEFAULT_PARAM_CNT + 1), HAL_SUCCESS);
+    EXPECT_EQ(paramSet, nullptr);
+    // the failed build leaves the cache usable
+    EXPECT_EQ(ConstructHmacParamSet(true, DEFAULT_OS_ACCOUNT, true, &paramSet), HAL_SUCCESS);
+    EXPECT_NE(paramSet, nullptr);
+    FreeParamSet(paramSet);
+}
 }
\ No newline at end of file
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "dev_session_mgr.h"
+#include "device_auth_defines.h"
+#include "hc_time.h"
+#include "hc_types.h"
+#include "task_manager.h"
+
+using namespace testing::ext;
+
+namespace {
+static const char *TEST_APP_ID = "TestAppId";
+static const int64_t TEST_SESSION_ID = 100;
+static const int64_t TEST_SESSION_ID2 = 200;
+static const int64_t TEST_SESSION_ID3 = 300;
+static const int64_t TEST_NOT_EXIST_SESSION_ID = 999;
+static const int64_t TEST_CREATE_INTERVAL = 10;
+
+static int64_t g_curTime = 0;
+static std::vector<int64_t> g_timeoutIds;
+static std::vector<int64_t> g_destroyedIds;
+
+static std::mutex g_startMutex;
+static std::condition_variable g_startCond;
+static bool g_isBlockStart = false;
+static bool g_isStartEntered = false;
+static bool g_isStartReleased = false;
+
+static int32_t StartTestSession(DevSession *self)
+{
+    (void)self;
+    std::unique_lock<std::mutex> lock(g_startMutex);
+    if (!g_isBlockStart) {
+        return HC_SUCCESS;
+    }
+    g_isStartEntered = true;
+    g_startCond.notify_all();
+    g_startCond.wait(lock, [] { return g_isStartReleased; });
+    return HC_SUCCESS;
+}
+
+static int32_t ProcessTestSession(DevSession *self, const CJson *receviedMsg, bool *isFinish)
+{
+    (void)self;
+    (void)receviedMsg;
+    *isFinish = true;
+    return HC_SUCCESS;
+}
+
+static void DestroyTestSession(DevSession *self)
+{
+    g_destroyedIds.push_back(self->id);
+    HcFree(self);
+}
+}
+
+/* The session manager is tested against a fake clock and fake sessions. */
+extern "C" int64_t HcGetCurTime(void)
+{
+    return g_curTime;
+}
+
+extern "C" int64_t HcGetIntervalTime(int64_t startTime)
+{
+    return g_curTime - startTime;
+}
+
+extern "C" void ProcessErrorCallback(int64_t reqId, int operationCode, int errorCode,
+    const char *errorReturn, const DeviceAuthCallback *callback)
+{
+    (void)operationCode;
+    (void)errorReturn;
+    (void)callback;
+    if (errorCode == HC_ERR_TIME_OUT) {
+        g_timeoutIds.push_back(reqId);
+    }
+}
+
+extern "C" int32_t PushSessionTask(int64_t sessionId, HcTaskBase *task)
+{
+    (void)sessionId;
+    (void)task;
+    return HC_ERR_INIT_TASK_FAIL;
+}
+
+extern "C" int32_t CreateDevSession(int64_t sessionId, const char *appId, SessionInitParams *params,
+    DevSession **returnObj)
+{
+    (void)params;
+    DevSession *session = (DevSession *)HcMalloc(sizeof(DevSession), 0);
+    if (session == nullptr) {
+        return HC_ERR_ALLOC_MEMORY;
+    }
+    session->id = sessionId;
+    session->appId = (char *)appId;
+    session->start = StartTestSession;
+    session->process = ProcessTestSession;
+    session->destroy = DestroyTestSession;
+    *returnObj = session;
+    return HC_SUCCESS;
+}
+
+namespace {
+class DevSessionMgrTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        g_curTime = 0;
+        g_timeoutIds.clear();
+        g_destroyedIds.clear();
+        g_isBlockStart = false;
+        g_isStartEntered = false;
+        g_isStartReleased = false;
+        ASSERT_EQ(InitDevSessionManager(), HC_SUCCESS);
+    }
+    void TearDown() override
+    {
+        DestroyDevSessionManager();
+    }
+};
+
+static int32_t OpenTestSession(int64_t sessionId)
+{
+    SessionInitParams params = { nullptr, {} };
+    return OpenDevSession(sessionId, TEST_APP_ID, &params);
+}
+
+HWTEST_F(DevSessionMgrTest, LookupSessionTest001, TestSize.Level0)
+{
+    EXPECT_EQ(OpenTestSession(TEST_SESSION_ID), HC_SUCCESS);
+    EXPECT_EQ(OpenTestSession(TEST_SESSION_ID2), HC_SUCCESS);
+    EXPECT_EQ(OpenTestSession(TEST_SESSION_ID), HC_ERR_REQUEST_EXIST);
+    EXPECT_TRUE(IsSessionExist(TEST_SESSION_ID));
+    EXPECT_TRUE(IsSessionExist(TEST_SESSION_ID2));
+    EXPECT_FALSE(IsSessionExist(TEST_NOT_EXIST_SESSION_ID));
+
+    CloseDevSession(TEST_SESSION_ID);
+    EXPECT_FALSE(IsSessionExist(TEST_SESSION_ID));
+    EXPECT_TRUE(IsSessionExist(TEST_SESSION_ID2));
+    EXPECT_EQ(StartDevSession(TEST_SESSION_ID), HC_ERR_SESSION_NOT_EXIST);
+    EXPECT_EQ(StartDevSession(TEST_SESSION_ID2), HC_SUCCESS);
+    EXPECT_EQ(g_destroyedIds, std::vector<int64_t>({ TEST_SESSION_ID }));
+
+    CancelDevSession(TEST_SESSION_ID2, "OtherAppId");
+    EXPECT_TRUE(IsSessionExist(TEST_SESSION_ID2));
+    CancelDevSession(TEST_SESSION_ID2, TEST_APP_ID);
+    EXPECT_FALSE(IsSessionExist(TEST_SESSION_ID2));
+
+    EXPECT_EQ(OpenTestSession(TEST_SESSION_ID), HC_SUCCESS);
+    EXPECT_TRUE(IsSessionExist(TEST_SESSION_ID));
+    EXPECT_TRUE(g_timeoutIds.empty());
+}
+
+HWTEST_F(DevSessionMgrTest, LookupSessionTest002, TestSize.Level0)
+{
+    // ids sharing their low bits land in the same bucket chain
+    const int64_t idStep = (int64_t)1 << 32;
+    for (int64_t i = 0; i < MAX_AUTH_SESSION_COUNT; i++) {
+        EXPECT_EQ(OpenTestSession(i * idStep), HC_SUCCESS);
+    }
+    EXPECT_EQ(OpenTestSession(TEST_NOT_EXIST_SESSION_ID), HC_ERR_SESSION_IS_FULL);
+    for (int64_t i = 0; i < MAX_AUTH_SESSION_COUNT; i += 2) {
+        CloseDevSession(i * idStep);
+    }
+    for (int64_t i = 0; i < MAX_AUTH_SESSION_COUNT; i++) {
+        EXPECT_EQ(IsSessionExist(i * idStep), (i % 2) != 0);
+    }
+    EXPECT_EQ(OpenTestSession(TEST_NOT_EXIST_SESSION_ID), HC_SUCCESS);
+}
+
+HWTEST_F(DevSessionMgrTest, RemoveTimeoutSessionTest001, TestSize.Level0)
+{
+    EXPECT_EQ(OpenTestSession(TEST_SESSION_ID), HC_SUCCESS);
+    g_curTime += TEST_CREATE_INTERVAL;
+    EXPECT_EQ(OpenTestSession(TEST_SESSION_ID2), HC_SUCCESS);
+    g_curTime += TEST_CREATE_INTERVAL;
+    EXPECT_EQ(OpenTestSession(TEST_SESSION_ID3), HC_SUCCESS);
+
+    g_curTime = TIME_OUT_VALUE;
+    CloseDevSession(TEST_NOT_EXIST_SESSION_ID);
+    EXPECT_EQ(g_timeoutIds, std::vector<int64_t>({ TEST_SESSION_ID }));
+    EXPECT_FALSE(IsSessionExist(TEST_SESSION_ID));
+    EXPECT_TRUE(IsSessionExist(TEST_SESSION_ID2));
+    EXPECT_TRUE(IsSessionExist(TEST_SESSION_ID3));
+
+    g_curTime = TIME_OUT_VALUE + TEST_CREATE_INTERVAL + TEST_CREATE_INTERVAL;
+    CloseDevSession(TEST_NOT_EXIST_SESSION_ID);
+    EXPECT_EQ(g_timeoutIds, std::vector<int64_t>({ TEST_SESSION_ID, TEST_SESSION_ID2, TEST_SESSION_ID3 }));
+    EXPECT_EQ(g_destroyedIds, g_timeoutIds);
+}
+
+HWTEST_F(DevSessionMgrTest, RemoveTimeoutSessionTest002, TestSize.Level0)
+{
+    EXPECT_EQ(OpenTestSession(TEST_SESSION_ID), HC_SUCCESS);
+    g_isBlockStart = true;
+    int32_t startRes = HC_ERROR;
+    std::thread stepThread([&startRes] { startRes = StartDevSession(TEST_SESSION_ID); });
+    {
+        std::unique_lock<std::mutex> lock(g_startMutex);
+        g_startCond.wait(lock, [] { return g_isStartEntered; });
+    }
+
+    // the session times out while its start step is still running
+    g_curTime = TIME_OUT_VALUE;
+    CloseDevSession(TEST_NOT_EXIST_SESSION_ID);
+    EXPECT_FALSE(IsSessionExist(TEST_SESSION_ID));
+    EXPECT_TRUE(g_timeoutIds.empty());
+    EXPECT_TRUE(g_destroyedIds.empty());
+    CloseDevSession(TEST_SESSION_ID);
+    EXPECT_TRUE(g_timeoutIds.empty());
+
+    {
+        std::lock_guard<std::mutex> lock(g_startMutex);
+        g_isStartReleased = true;
+    }
+    g_startCond.notify_all();
+    stepThread.join();
+    EXPECT_EQ(startRes, HC_SUCCESS);
+    EXPECT_EQ(g_timeoutIds, std::vector<int64_t>({ TEST_SESSION_ID }));
+    EXPECT_EQ(g_destroyedIds, std::vector<int64_t>({ TEST_SESSION_ID }));
+    EXPECT_EQ(StartDevSession(TEST_SESSION_ID), HC_ERR_SESSION_NOT_EXIST);
+}
+}
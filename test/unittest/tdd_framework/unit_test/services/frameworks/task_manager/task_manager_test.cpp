@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <mutex>
+#include <pthread.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "device_auth_defines.h"
+#include "hc_types.h"
+#include "task_manager.h"
+
+using namespace std;
+using namespace testing::ext;
+
+namespace {
+static const int32_t TEST_PUSHER_NUM = 2;
+static const int32_t TEST_TASK_NUM_PER_PUSHER = 50;
+static const int32_t TEST_WAIT_RETRY_NUM = 200;
+static const int32_t TEST_TASK_WAIT_TIME_US = 10000;
+static const int32_t TEST_FIRST_TASK_DELAY_US = 20000;
+static const int64_t TEST_SESSION_ID = 2;
+
+typedef struct {
+    HcTaskBase base;
+    int32_t seq;
+} TestTask;
+
+typedef struct {
+    int32_t seq;
+    pthread_t worker;
+} TaskRecord;
+
+static mutex g_recordMutex;
+static vector<TaskRecord> g_taskRecords;
+
+static void DoTestTask(HcTaskBase *task)
+{
+    TestTask *realTask = (TestTask *)task;
+    if (realTask->seq == 0) {
+        // keep the worker busy so that the following tasks queue up behind the first one
+        usleep(TEST_FIRST_TASK_DELAY_US);
+    }
+    lock_guard<mutex> lock(g_recordMutex);
+    g_taskRecords.push_back({ realTask->seq, pthread_self() });
+}
+
+static HcTaskBase *CreateTestTask(int32_t seq)
+{
+    TestTask *task = (TestTask *)HcMalloc(sizeof(TestTask), 0);
+    if (task == nullptr) {
+        return nullptr;
+    }
+    task->base.doAction = DoTestTask;
+    task->base.destroy = nullptr;
+    task->seq = seq;
+    return (HcTaskBase *)task;
+}
+
+static size_t GetTaskRecordNum(void)
+{
+    lock_guard<mutex> lock(g_recordMutex);
+    return g_taskRecords.size();
+}
+
+static void WaitTaskRecords(size_t taskNum)
+{
+    for (int32_t i = 0; i < TEST_WAIT_RETRY_NUM && GetTaskRecordNum() < taskNum; i++) {
+        usleep(TEST_TASK_WAIT_TIME_US);
+    }
+}
+
+class TaskManagerTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        g_taskRecords.clear();
+        ASSERT_EQ(InitTaskManager(), HC_SUCCESS);
+    }
+    void TearDown() override
+    {
+        DestroyTaskManager();
+    }
+};
+
+HWTEST_F(TaskManagerTest, PushTaskTest001, TestSize.Level0)
+{
+    const int32_t taskNum = TEST_TASK_NUM_PER_PUSHER;
+    for (int32_t i = 0; i < taskNum; i++) {
+        EXPECT_EQ(PushTask(CreateTestTask(i)), HC_SUCCESS);
+    }
+    // session id 0 is routed to worker 0
+    EXPECT_EQ(PushSessionTask(0, CreateTestTask(taskNum)), HC_SUCCESS);
+    WaitTaskRecords(taskNum + 1);
+    ASSERT_EQ(g_taskRecords.size(), (size_t)(taskNum + 1));
+    for (int32_t i = 0; i <= taskNum; i++) {
+        EXPECT_EQ(g_taskRecords[i].seq, i);
+        EXPECT_TRUE(pthread_equal(g_taskRecords[i].worker, g_taskRecords[0].worker));
+    }
+}
+
+HWTEST_F(TaskManagerTest, PushSessionTaskTest001, TestSize.Level0)
+{
+    // the seq is taken under the push lock, so it is the order the two pushers hand the tasks over
+    mutex pushMutex;
+    int32_t nextSeq = 0;
+    vector<thread> pushers;
+    for (int32_t i = 0; i < TEST_PUSHER_NUM; i++) {
+        pushers.emplace_back([&pushMutex, &nextSeq]() {
+            for (int32_t j = 0; j < TEST_TASK_NUM_PER_PUSHER; j++) {
+                lock_guard<mutex> lock(pushMutex);
+                EXPECT_EQ(PushSessionTask(TEST_SESSION_ID, CreateTestTask(nextSeq)), HC_SUCCESS);
+                nextSeq++;
+            }
+        });
+    }
+    for (auto &pusher : pushers) {
+        pusher.join();
+    }
+    const int32_t taskNum = TEST_PUSHER_NUM * TEST_TASK_NUM_PER_PUSHER;
+    WaitTaskRecords(taskNum);
+    ASSERT_EQ(g_taskRecords.size(), (size_t)taskNum);
+    for (int32_t i = 0; i < taskNum; i++) {
+        EXPECT_EQ(g_taskRecords[i].seq, i);
+        EXPECT_TRUE(pthread_equal(g_taskRecords[i].worker, g_taskRecords[0].worker));
+    }
+}
+
+HWTEST_F(TaskManagerTest, PushSessionTaskTest002, TestSize.Level0)
+{
+    // small session ids map to distinct workers, each session runs on a thread of its own
+    for (int32_t i = 0; i < DEV_AUTH_WORK_THREAD_NUM; i++) {
+        EXPECT_EQ(PushSessionTask(i, CreateTestTask(i + 1)), HC_SUCCESS);
+    }
+    WaitTaskRecords(DEV_AUTH_WORK_THREAD_NUM);
+    ASSERT_EQ(g_taskRecords.size(), (size_t)DEV_AUTH_WORK_THREAD_NUM);
+    for (size_t i = 0; i < g_taskRecords.size(); i++) {
+        for (size_t j = i + 1; j < g_taskRecords.size(); j++) {
+            EXPECT_FALSE(pthread_equal(g_taskRecords[i].worker, g_taskRecords[j].worker));
+        }
+    }
+}
+}